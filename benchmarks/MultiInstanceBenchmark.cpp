@@ -0,0 +1,371 @@
+#include "../src/PluginProcessor.h"
+#include "../src/dsp/KernelDispatch.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Runs N plugin instances side by side the way a host does: every audio period each instance gets one processBlock
+// call, and a fixed pool of threads pulls instances from a shared queue until the period's work is done. The sweep
+// doubles N from 1 up to --instances and reports aggregate throughput, per-block latency and cache misses, so
+// shared-cache pressure from many instances shows up as a throughput knee.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int maxInstances = 512;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int blockSize = 256;
+    double sampleRate = 48000.0;
+    double seconds = 1.0;
+    int hilbertMode = 1;
+    float widthPercent = 100.0f;
+};
+
+void printUsage() {
+    std::cout << "Usage: QuadraBassBenchmark [--instances N] [--threads N] [--block N] [--rate HZ]\n"
+                 "                           [--seconds S] [--mode 0..5] [--width PERCENT]\n"
+                 "Sweeps 1, 2, 4 ... N instances (default 512) over a host-style thread pool.\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        if (arg == "--help" || arg == "-h")
+            return false;
+        if (i + 1 >= argc)
+            return false;
+
+        const char* value = argv[++i];
+        if (arg == "--instances")
+            options.maxInstances = std::atoi(value);
+        else if (arg == "--threads")
+            options.threads = std::atoi(value);
+        else if (arg == "--block")
+            options.blockSize = std::atoi(value);
+        else if (arg == "--rate")
+            options.sampleRate = std::atof(value);
+        else if (arg == "--seconds")
+            options.seconds = std::atof(value);
+        else if (arg == "--mode")
+            options.hilbertMode = std::atoi(value);
+        else if (arg == "--width")
+            options.widthPercent = static_cast<float>(std::atof(value));
+        else
+            return false;
+    }
+
+    return options.maxInstances > 0 && options.threads > 0 && options.blockSize > 0 && options.sampleRate > 0.0 &&
+           options.seconds > 0.0 && options.hilbertMode >= 0 &&
+           options.hilbertMode < qbdsp::EngineParams::kNumHilbertModes;
+}
+
+// Hardware cache-miss counter for the calling thread. Unavailable (and silently inert) outside Linux, or where the
+// kernel refuses user-space perf events (perf_event_paranoid, containers, some VMs).
+class CacheMissCounter final {
+  public:
+    CacheMissCounter() {
+#if defined(__linux__)
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#if defined(__linux__)
+        if (fd_ >= 0)
+            close(fd_);
+#endif
+    }
+
+    bool isAvailable() const noexcept { return fd_ >= 0; }
+
+    void start() noexcept {
+#if defined(__linux__)
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop() noexcept {
+        long long count = 0;
+#if defined(__linux__)
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count)))
+                count = 0;
+        }
+#endif
+        return count;
+    }
+
+  private:
+    int fd_ = -1;
+
+    JUCE_DECLARE_NON_COPYABLE(CacheMissCounter)
+};
+
+struct Instance {
+    std::unique_ptr<QuadraBassAudioProcessor> processor;
+    juce::AudioBuffer<float> source;
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midi;
+};
+
+std::unique_ptr<Instance> createInstance(const Options& options, juce::Random& random) {
+    auto instance = std::make_unique<Instance>();
+    instance->processor = std::make_unique<QuadraBassAudioProcessor>();
+    auto& processor = *instance->processor;
+
+    if (auto* width = dynamic_cast<juce::AudioParameterFloat*>(
+            processor.params().apvts.getParameter(util::Params::IDs::widthPercent)))
+        *width = options.widthPercent;
+    if (auto* mode = dynamic_cast<juce::AudioParameterChoice*>(
+            processor.params().apvts.getParameter(util::Params::IDs::hilbertMode)))
+        *mode = options.hilbertMode;
+
+    processor.prepareToPlay(options.sampleRate, options.blockSize);
+
+    // Each instance owns distinct input memory, as separate host tracks would.
+    instance->source.setSize(2, options.blockSize);
+    instance->buffer.setSize(2, options.blockSize);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < options.blockSize; ++i)
+            instance->source.setSample(ch, i, random.nextFloat() * 0.5f - 0.25f);
+
+    return instance;
+}
+
+struct WorkerResult {
+    std::vector<float> blockMicros;
+    long long cacheMisses = 0;
+    bool countersAvailable = false;
+};
+
+// Minimal host render pool. The main thread opens a period by bumping the generation; every participant (main
+// included) then claims instances until the queue is empty and checks in, so the next period cannot start while
+// anyone is still claiming from this one.
+class HostPool final {
+  public:
+    HostPool(std::vector<std::unique_ptr<Instance>>& instances, int numThreads)
+        : instances_(instances), results_(static_cast<size_t>(numThreads)) {
+        for (int t = 1; t < numThreads; ++t)
+            workers_.emplace_back([this, t] { workerLoop(t); });
+    }
+
+    ~HostPool() {
+        quit_.store(true, std::memory_order_release);
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    void beginMeasuring(size_t expectedBlocksPerThread) {
+        for (auto& result : results_) {
+            result.blockMicros.clear();
+            result.blockMicros.reserve(expectedBlocksPerThread);
+        }
+        measuring_ = true;
+    }
+
+    void endMeasuring() noexcept { measuring_ = false; }
+
+    void runPeriod() {
+        claimed_.store(0, std::memory_order_relaxed);
+        checkedIn_.store(0, std::memory_order_relaxed);
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+
+        drainQueue(results_.front());
+
+        const int participants = static_cast<int>(workers_.size()) + 1;
+        while (checkedIn_.load(std::memory_order_acquire) < participants)
+            std::this_thread::yield();
+    }
+
+    // Counters are per thread, so each participant runs its own and reports at the next period.
+    void startCounters() { countersRequested_.store(1, std::memory_order_release); }
+    void stopCounters() { countersRequested_.store(2, std::memory_order_release); }
+
+    std::vector<WorkerResult>& getResults() noexcept { return results_; }
+
+  private:
+    void workerLoop(int index) {
+        int seenGeneration = 0;
+        while (true) {
+            int generation = generation_.load(std::memory_order_acquire);
+            for (int spins = 0; generation == seenGeneration; ++spins) {
+                if (spins > 64)
+                    std::this_thread::yield();
+                generation = generation_.load(std::memory_order_acquire);
+            }
+
+            seenGeneration = generation;
+            if (quit_.load(std::memory_order_acquire))
+                return;
+
+            drainQueue(results_[static_cast<size_t>(index)]);
+        }
+    }
+
+    void drainQueue(WorkerResult& result) {
+        thread_local CacheMissCounter counter;
+        thread_local int counterState = 0;
+        const int requested = countersRequested_.load(std::memory_order_acquire);
+        if (requested != 0 && requested != counterState) {
+            if (requested == 1) {
+                counter.start();
+            } else {
+                result.cacheMisses = counter.stop();
+                result.countersAvailable = counter.isAvailable();
+            }
+            counterState = requested;
+        }
+
+        const int count = static_cast<int>(instances_.size());
+        for (int i = claimed_.fetch_add(1, std::memory_order_acq_rel); i < count;
+             i = claimed_.fetch_add(1, std::memory_order_acq_rel)) {
+            auto& instance = *instances_[static_cast<size_t>(i)];
+            instance.buffer.makeCopyOf(instance.source, true);
+
+            const auto start = Clock::now();
+            instance.processor->processBlock(instance.buffer, instance.midi);
+            const auto end = Clock::now();
+
+            if (measuring_)
+                result.blockMicros.push_back(std::chrono::duration<float, std::micro>(end - start).count());
+        }
+
+        checkedIn_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    std::vector<std::unique_ptr<Instance>>& instances_;
+    std::vector<WorkerResult> results_;
+    std::vector<std::thread> workers_;
+    std::atomic<int> generation_{0};
+    std::atomic<int> claimed_{0};
+    std::atomic<int> checkedIn_{0};
+    std::atomic<int> countersRequested_{0};
+    std::atomic<bool> quit_{false};
+    bool measuring_ = false;
+};
+
+template <typename T> double percentile(std::vector<T>& values, double fraction) {
+    if (values.empty())
+        return 0.0;
+    const auto index = static_cast<size_t>(fraction * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return static_cast<double>(values[index]);
+}
+
+void runSweepStep(const Options& options, std::vector<std::unique_ptr<Instance>>& instances) {
+    const int numInstances = static_cast<int>(instances.size());
+    const int numThreads = std::min(options.threads, numInstances);
+    const int periods = std::max(1, static_cast<int>(options.seconds * options.sampleRate / options.blockSize));
+    const double periodMicros = 1.0e6 * options.blockSize / options.sampleRate;
+
+    HostPool pool(instances, numThreads);
+
+    // Warm caches, page in scratch buffers and let FIR designs settle before timing.
+    for (int p = 0; p < std::min(periods, 16); ++p)
+        pool.runPeriod();
+
+    const auto expectedBlocks = static_cast<size_t>(periods) * static_cast<size_t>(numInstances);
+    pool.beginMeasuring(expectedBlocks / static_cast<size_t>(numThreads) * 2 + 64);
+    pool.startCounters();
+
+    std::vector<double> periodMicrosMeasured;
+    periodMicrosMeasured.reserve(static_cast<size_t>(periods));
+    const auto runStart = Clock::now();
+    for (int p = 0; p < periods; ++p) {
+        const auto start = Clock::now();
+        pool.runPeriod();
+        periodMicrosMeasured.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    const double wallSeconds = std::chrono::duration<double>(Clock::now() - runStart).count();
+
+    pool.endMeasuring();
+    pool.stopCounters();
+    pool.runPeriod();
+
+    std::vector<float> blockMicros;
+    long long cacheMisses = 0;
+    bool countersAvailable = true;
+    for (auto& result : pool.getResults()) {
+        blockMicros.insert(blockMicros.end(), result.blockMicros.begin(), result.blockMicros.end());
+        cacheMisses += result.cacheMisses;
+        countersAvailable &= result.countersAvailable;
+    }
+
+    const int missedDeadlines =
+        static_cast<int>(std::count_if(periodMicrosMeasured.begin(), periodMicrosMeasured.end(),
+                                       [periodMicros](double t) { return t > periodMicros; }));
+    const double audioSeconds = static_cast<double>(periods) * options.blockSize / options.sampleRate;
+    const double aggregateRealtime = static_cast<double>(numInstances) * audioSeconds / wallSeconds;
+
+    char missesText[32] = "n/a";
+    if (countersAvailable && !blockMicros.empty())
+        std::snprintf(missesText, sizeof(missesText), "%.0f",
+                      static_cast<double>(cacheMisses) / static_cast<double>(blockMicros.size()));
+
+    std::printf("%9d %7d %12.1f %10.1f %10.1f %10.1f %10.1f %8d/%-6d %12s\n", numInstances, numThreads,
+                aggregateRealtime, aggregateRealtime / numThreads, percentile(blockMicros, 0.5),
+                percentile(blockMicros, 0.99), percentile(periodMicrosMeasured, 0.99), missedDeadlines, periods,
+                missesText);
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    const double periodMicros = 1.0e6 * options.blockSize / options.sampleRate;
+    std::printf("QuadraBass multi-instance benchmark: %s kernels, mode %d, %.0f Hz, %d-sample blocks "
+                "(%.1f us period), up to %d threads\n",
+                qbdsp::KernelDispatch::getIsaName(qbdsp::KernelDispatch::getActiveIsa()), options.hilbertMode,
+                options.sampleRate, options.blockSize, periodMicros, options.threads);
+    std::printf("%9s %7s %12s %10s %10s %10s %10s %15s %12s\n", "instances", "threads", "x-realtime", "per-thread",
+                "block-p50", "block-p99", "period-p99", "late periods", "misses/block");
+
+    juce::Random random(1234);
+    std::vector<std::unique_ptr<Instance>> instances;
+    for (int count = 1;; count = std::min(count * 2, options.maxInstances)) {
+        while (static_cast<int>(instances.size()) < count)
+            instances.push_back(createInstance(options, random));
+
+        runSweepStep(options, instances);
+        if (count == options.maxInstances)
+            break;
+    }
+
+    std::cout << "Times are in microseconds. x-realtime is seconds of audio processed per wall-clock second, summed "
+                 "over instances.\n";
+    return 0;
+}
@@ -14,11 +14,11 @@ while IFS= read -r file; do
   FILES+=("${file}")
 done < <(
   if command -v rg >/dev/null 2>&1; then
-    rg --files "${ROOT_DIR}/src" "${ROOT_DIR}/tests" \
+    rg --files "${ROOT_DIR}/src" "${ROOT_DIR}/tests" "${ROOT_DIR}/benchmarks" \
       --glob '*.{h,hpp,cpp,cc}' \
       2>/dev/null || true
   else
-    find "${ROOT_DIR}/src" "${ROOT_DIR}/tests" -type f \( \
+    find "${ROOT_DIR}/src" "${ROOT_DIR}/tests" "${ROOT_DIR}/benchmarks" -type f \( \
       -name '*.h' -o -name '*.hpp' -o -name '*.cpp' -o -name '*.cc' \
     \) 2>/dev/null || true
   fi
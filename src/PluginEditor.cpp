@@ -3,9 +3,16 @@
 
 QuadraBassAudioProcessorEditor::QuadraBassAudioProcessorEditor(QuadraBassAudioProcessor& proc)
     : AudioProcessorEditor(proc), audioProcessor_(proc) {
+    QB_TRACE_THREAD_NAME("Message");
 
-    audioProcessor_.activeGoniometer_.store(&goniometer_, std::memory_order_relaxed);
-    audioProcessor_.activeCorrelationMeter_.store(&correlationMeter_, std::memory_order_relaxed);
+    goniometer_.setSource(&audioProcessor_.telemetry());
+    correlationMeter_.setSource(&audioProcessor_.telemetry());
+    loudnessMeter_.setSource(&audioProcessor_.telemetry());
+    qualityIndicator_.setSource(&audioProcessor_.telemetry());
+    repaintScheduler_.addClient(goniometer_);
+    repaintScheduler_.addClient(correlationMeter_);
+    repaintScheduler_.addClient(loudnessMeter_);
+    repaintScheduler_.addClient(qualityIndicator_);
 
     title_.setText("QuadraBass", juce::dontSendNotification);
     title_.setJustificationType(juce::Justification::centredLeft);
@@ -14,6 +21,7 @@ QuadraBassAudioProcessorEditor::QuadraBassAudioProcessorEditor(QuadraBassAudioPr
 
     addAndMakeVisible(goniometer_);
     addAndMakeVisible(correlationMeter_);
+    addAndMakeVisible(loudnessMeter_);
 
     hilbertModeLabel_.setText("Mode", juce::dontSendNotification);
     hilbertModeLabel_.setJustificationType(juce::Justification::centredRight);
@@ -22,12 +30,34 @@ QuadraBassAudioProcessorEditor::QuadraBassAudioProcessorEditor(QuadraBassAudioPr
 
     hilbertModeBox_.addItem("IIR", 1);
     hilbertModeBox_.addItem("FIR", 2);
+    hilbertModeBox_.addItem("Multirate", 3);
+    hilbertModeBox_.addItem("Spectral", 4);
+    hilbertModeBox_.addItem("Auto", 5);
+    hilbertModeBox_.addItem("Velvet", 6);
     hilbertModeBox_.setColour(juce::ComboBox::backgroundColourId, juce::Colour::fromRGB(29, 35, 45));
     hilbertModeBox_.setColour(juce::ComboBox::textColourId, juce::Colour::fromRGB(220, 230, 242));
     hilbertModeBox_.setColour(juce::ComboBox::outlineColourId, juce::Colour::fromRGB(73, 94, 120));
     addAndMakeVisible(hilbertModeBox_);
 
+    adaptiveQualityButton_.setButtonText("Adaptive");
+    adaptiveQualityButton_.setColour(juce::ToggleButton::textColourId, juce::Colour::fromRGB(192, 205, 220));
+    adaptiveQualityButton_.setColour(juce::ToggleButton::tickColourId, juce::Colour::fromRGB(89, 174, 255));
+    addAndMakeVisible(adaptiveQualityButton_);
+    addAndMakeVisible(qualityIndicator_);
+
+    monoBassLabel_.setText("Mono Bass", juce::dontSendNotification);
+    monoBassLabel_.setJustificationType(juce::Justification::centredRight);
+    monoBassLabel_.setColour(juce::Label::textColourId, juce::Colour::fromRGB(192, 205, 220));
+    addAndMakeVisible(monoBassLabel_);
+
+    monoBassBox_.addItemList({"Off", "60 Hz", "80 Hz", "100 Hz", "120 Hz", "150 Hz", "200 Hz"}, 1);
+    monoBassBox_.setColour(juce::ComboBox::backgroundColourId, juce::Colour::fromRGB(29, 35, 45));
+    monoBassBox_.setColour(juce::ComboBox::textColourId, juce::Colour::fromRGB(220, 230, 242));
+    monoBassBox_.setColour(juce::ComboBox::outlineColourId, juce::Colour::fromRGB(73, 94, 120));
+    addAndMakeVisible(monoBassBox_);
+
     auto setupSlider = [this](juce::Slider& slider, juce::Label& label, const juce::String& labelText) {
+        slider.setLookAndFeel(&knobLookAndFeel_);
         slider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
         slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 88, 18);
         slider.setColour(juce::Slider::rotarySliderFillColourId, juce::Colour::fromRGB(89, 174, 255));
@@ -48,6 +78,9 @@ QuadraBassAudioProcessorEditor::QuadraBassAudioProcessorEditor(QuadraBassAudioPr
     auto& apvts = audioProcessor_.params().apvts;
     hilbertModeAttachment_ =
         std::make_unique<ComboBoxAttachment>(apvts, util::Params::IDs::hilbertMode, hilbertModeBox_);
+    adaptiveQualityAttachment_ =
+        std::make_unique<ButtonAttachment>(apvts, util::Params::IDs::adaptiveQuality, adaptiveQualityButton_);
+    monoBassAttachment_ = std::make_unique<ComboBoxAttachment>(apvts, util::Params::IDs::monoBass, monoBassBox_);
     widthAttachment_ = std::make_unique<SliderAttachment>(apvts, util::Params::IDs::widthPercent, widthSlider_);
     phaseAngleAttachment_ =
         std::make_unique<SliderAttachment>(apvts, util::Params::IDs::phaseAngleDeg, phaseAngleSlider_);
@@ -55,15 +88,40 @@ QuadraBassAudioProcessorEditor::QuadraBassAudioProcessorEditor(QuadraBassAudioPr
         std::make_unique<SliderAttachment>(apvts, util::Params::IDs::phaseRotationDeg, phaseRotationSlider_);
     gainAttachment_ = std::make_unique<SliderAttachment>(apvts, util::Params::IDs::outputGainDb, gainSlider_);
 
+    setOpaque(true);
     setSize(760, 420);
 }
 
 QuadraBassAudioProcessorEditor::~QuadraBassAudioProcessorEditor() {
-    audioProcessor_.activeGoniometer_.store(nullptr, std::memory_order_relaxed);
-    audioProcessor_.activeCorrelationMeter_.store(nullptr, std::memory_order_relaxed);
+    goniometer_.setSource(nullptr);
+    correlationMeter_.setSource(nullptr);
+    loudnessMeter_.setSource(nullptr);
+    qualityIndicator_.setSource(nullptr);
 }
 
 void QuadraBassAudioProcessorEditor::paint(juce::Graphics& g) {
+    QB_TRACE_SCOPE("paint Editor");
+    backgroundLayer_.draw(g, getLocalBounds(), [this](juce::Graphics& layer, juce::Rectangle<float>) {
+        paintStaticLayer(layer);
+    });
+}
+
+#if QUADRABASS_ENABLE_TRACING
+void QuadraBassAudioProcessorEditor::mouseDown(const juce::MouseEvent& event) {
+    if (!event.mods.isPopupMenu())
+        return;
+
+    juce::PopupMenu menu;
+    menu.addItem("Save Performance Trace", [] {
+        const auto file = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+                              .getNonexistentChildFile("QuadraBass-trace", ".json");
+        util::Trace::dumpToFile(file);
+    });
+    menu.showMenuAsync(juce::PopupMenu::Options());
+}
+#endif
+
+void QuadraBassAudioProcessorEditor::paintStaticLayer(juce::Graphics& g) const {
     g.fillAll(juce::Colour::fromRGB(18, 21, 28));
 
     const auto bounds = getLocalBounds().reduced(24);
@@ -83,6 +141,10 @@ void QuadraBassAudioProcessorEditor::resized() {
     hilbertModeLabel_.setBounds(modeArea.removeFromLeft(64));
     hilbertModeBox_.setBounds(modeArea.reduced(0, 8));
 
+    auto qualityArea = header.reduced(8, 8);
+    adaptiveQualityButton_.setBounds(qualityArea.removeFromLeft(96));
+    qualityIndicator_.setBounds(qualityArea);
+
     auto topArea = bounds.withTop(98).withHeight(178);
     auto meterArea = topArea.removeFromLeft(240).reduced(8);
 
@@ -91,6 +153,13 @@ void QuadraBassAudioProcessorEditor::resized() {
     meterArea.removeFromLeft(8); // spacing
     correlationMeter_.setBounds(meterArea);
 
+    auto lowerArea = bounds.withTop(topArea.getBottom() + 8).withHeight(56);
+    loudnessMeter_.setBounds(lowerArea.removeFromLeft(240).reduced(8, 0));
+
+    auto monoBassArea = lowerArea.removeFromLeft(240).reduced(6, 14);
+    monoBassLabel_.setBounds(monoBassArea.removeFromLeft(88));
+    monoBassBox_.setBounds(monoBassArea.withTrimmedLeft(8));
+
     auto knobsArea = topArea.reduced(6);
     const int knobWidth = knobsArea.getWidth() / 4;
 
@@ -3,6 +3,12 @@
 #include "PluginProcessor.h"
 #include "ui/CorrelationMeter.h"
 #include "ui/GoniometerComponent.h"
+#include "ui/KnobLookAndFeel.h"
+#include "ui/LayerCache.h"
+#include "ui/LoudnessMeter.h"
+#include "ui/QualityIndicator.h"
+#include "ui/RepaintScheduler.h"
+#include "util/Trace.h"
 #include <JuceHeader.h>
 
 class QuadraBassAudioProcessorEditor final : public juce::AudioProcessorEditor {
@@ -13,19 +19,33 @@ class QuadraBassAudioProcessorEditor final : public juce::AudioProcessorEditor {
     void paint(juce::Graphics&) override;
     void resized() override;
 
+#if QUADRABASS_ENABLE_TRACING
+    // Right-click the background to save the recorded trace to the desktop.
+    void mouseDown(const juce::MouseEvent& event) override;
+#endif
+
   private:
+    void paintStaticLayer(juce::Graphics& g) const;
+
     QuadraBassAudioProcessor& audioProcessor_;
+    qbui::KnobLookAndFeel knobLookAndFeel_;
+    qbui::LayerCache backgroundLayer_;
     juce::Label title_;
     qbui::GoniometerComponent goniometer_;
     qbui::CorrelationMeter correlationMeter_;
+    qbui::LoudnessMeter loudnessMeter_;
+    qbui::QualityIndicator qualityIndicator_;
 
     juce::ComboBox hilbertModeBox_;
+    juce::ToggleButton adaptiveQualityButton_;
+    juce::ComboBox monoBassBox_;
     juce::Slider widthSlider_;
     juce::Slider phaseAngleSlider_;
     juce::Slider phaseRotationSlider_;
     juce::Slider gainSlider_;
 
     juce::Label hilbertModeLabel_;
+    juce::Label monoBassLabel_;
     juce::Label widthLabel_;
     juce::Label phaseAngleLabel_;
     juce::Label phaseRotationLabel_;
@@ -33,11 +53,17 @@ class QuadraBassAudioProcessorEditor final : public juce::AudioProcessorEditor {
 
     using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
     using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
+    using ButtonAttachment = juce::AudioProcessorValueTreeState::ButtonAttachment;
     std::unique_ptr<ComboBoxAttachment> hilbertModeAttachment_;
+    std::unique_ptr<ButtonAttachment> adaptiveQualityAttachment_;
+    std::unique_ptr<ComboBoxAttachment> monoBassAttachment_;
     std::unique_ptr<SliderAttachment> widthAttachment_;
     std::unique_ptr<SliderAttachment> phaseAngleAttachment_;
     std::unique_ptr<SliderAttachment> phaseRotationAttachment_;
     std::unique_ptr<SliderAttachment> gainAttachment_;
 
+    // Declared last so it stops calling into the meters before they are destroyed.
+    qbui::RepaintScheduler repaintScheduler_{*this};
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(QuadraBassAudioProcessorEditor)
 };
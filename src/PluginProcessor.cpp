@@ -1,5 +1,7 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "dsp/HilbertEngineSelector.h"
+#include "util/Trace.h"
 
 QuadraBassAudioProcessor::QuadraBassAudioProcessor()
     : AudioProcessor(BusesProperties()
@@ -11,6 +13,13 @@ QuadraBassAudioProcessor::QuadraBassAudioProcessor()
 #endif
                          ),
       params_(*this) {
+    // Auto mode benchmarks the Hilbert backends once per machine and spec; remember the decisions across sessions.
+    qbdsp::HilbertEngineSelector::setCacheFile(qbdsp::HilbertEngineSelector::getDefaultCacheFile());
+    analysisWorker_->addChannel(telemetry_);
+}
+
+QuadraBassAudioProcessor::~QuadraBassAudioProcessor() {
+    analysisWorker_->removeChannel(telemetry_);
 }
 
 const juce::String QuadraBassAudioProcessor::getName() const {
@@ -54,35 +63,37 @@ void QuadraBassAudioProcessor::changeProgramName(int index, const juce::String&
     juce::ignoreUnused(index, newName);
 }
 
+qbdsp::EngineParams QuadraBassAudioProcessor::readEngineParams() const noexcept {
+    qbdsp::EngineParams engineParams;
+    engineParams.widthPercent = params_.getWidthPercent();
+    engineParams.hilbertModeIndex = params_.getHilbertModeIndex();
+    engineParams.phaseAngleDeg = params_.getPhaseAngleDeg();
+    engineParams.phaseRotationDeg = params_.getPhaseRotationDeg();
+    engineParams.outputGainDb = params_.getOutputGainDb();
+    engineParams.monoBassIndex = params_.getMonoBassIndex();
+    return engineParams;
+}
+
 void QuadraBassAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
-    processSpec_.sampleRate = sampleRate;
-    processSpec_.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
-    processSpec_.numChannels =
-        static_cast<juce::uint32>(juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()));
-
-    outputGain_.reset();
-    outputGain_.prepare(processSpec_);
-    outputGain_.setRampDurationSeconds(0.02);
-    outputGain_.setGainDecibels(params_.getOutputGainDb());
-
-    hilbert_.prepare(processSpec_);
-    activeHilbertMode_ = params_.getHilbertModeIndex() == static_cast<int>(qbdsp::HilbertQuadratureProcessor::Mode::FIR)
-                             ? qbdsp::HilbertQuadratureProcessor::Mode::FIR
-                             : qbdsp::HilbertQuadratureProcessor::Mode::IIR;
-    hilbert_.setMode(activeHilbertMode_);
-    setLatencySamples(hilbert_.getLatencySamples());
-    stereoMatrix_.prepare(processSpec_);
-
-    const int bufferSize = juce::jmax(1, samplesPerBlock);
-    monoBuffer_.setSize(1, bufferSize, false, true, true);
-    xHighBuffer_.setSize(1, bufferSize, false, true, true);
-    qBuffer_.setSize(1, bufferSize, false, true, true);
-    zeroBuffer_.setSize(1, bufferSize, false, true, true);
+    QB_TRACE_SCOPE("prepareToPlay");
+    engine_.setParameters(readEngineParams());
+    engine_.prepare(sampleRate, samplesPerBlock, juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()));
+    // A bounce has no deadline for prepare but needs a fixed latency from the first block, so it waits for Auto's
+    // benchmark; realtime playback starts on FIR and picks the choice up at the next reset.
+    if (isNonRealtime())
+        engine_.waitForAutoHilbertMode();
+    setLatencySamples(engine_.getLatencySamples());
+    telemetry_.setSampleRate(sampleRate);
 }
 
 void QuadraBassAudioProcessor::releaseResources() {
-    hilbert_.reset();
-    stereoMatrix_.reset();
+    engine_.reset();
+}
+
+void QuadraBassAudioProcessor::reset() {
+    // Hosts reset on transport jumps, where a finished Auto benchmark may switch backend; processBlock reports the
+    // new latency.
+    engine_.reset();
 }
 
 #if !JucePlugin_PreferredChannelConfigurations
@@ -105,6 +116,8 @@ bool QuadraBassAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts
 void QuadraBassAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
     juce::ignoreUnused(midiMessages);
     juce::ScopedNoDenormals noDenormals;
+    QB_TRACE_THREAD_NAME("Audio");
+    QB_TRACE_SCOPE("processBlock");
 
     const int totalNumInputChannels = getTotalNumInputChannels();
     const int totalNumOutputChannels = getTotalNumOutputChannels();
@@ -116,58 +129,25 @@ void QuadraBassAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
     if (totalNumInputChannels <= 0 || samples <= 0)
         return;
 
-    monoBuffer_.setSize(1, samples, false, false, true);
-    xHighBuffer_.setSize(1, samples, false, false, true);
-    qBuffer_.setSize(1, samples, false, false, true);
-    zeroBuffer_.setSize(1, samples, false, false, true);
-    zeroBuffer_.clear();
-
-    auto downmixToMono = [samples](const juce::AudioBuffer<float>& src, int srcChannels,
-                                   juce::AudioBuffer<float>& dst) noexcept {
-        float* monoData = dst.getWritePointer(0);
-        juce::FloatVectorOperations::clear(monoData, samples);
-        if (srcChannels <= 0)
-            return;
-
-        const float mixScale = 1.0f / static_cast<float>(srcChannels);
-        for (int ch = 0; ch < srcChannels; ++ch)
-            juce::FloatVectorOperations::addWithMultiply(monoData, src.getReadPointer(ch), mixScale, samples);
-    };
-
-    // Keep widening full-band so width behavior stays consistent across the spectrum.
-    downmixToMono(buffer, totalNumInputChannels, monoBuffer_);
-
-    const auto requestedMode =
-        params_.getHilbertModeIndex() == static_cast<int>(qbdsp::HilbertQuadratureProcessor::Mode::FIR)
-            ? qbdsp::HilbertQuadratureProcessor::Mode::FIR
-            : qbdsp::HilbertQuadratureProcessor::Mode::IIR;
-    if (requestedMode != activeHilbertMode_) {
-        activeHilbertMode_ = requestedMode;
-        hilbert_.setMode(activeHilbertMode_);
-        setLatencySamples(hilbert_.getLatencySamples());
-    }
-
-    xHighBuffer_.copyFrom(0, 0, monoBuffer_, 0, 0, samples);
-    hilbert_.process(monoBuffer_, qBuffer_, params_.getPhaseAngleDeg());
-    stereoMatrix_.process(zeroBuffer_, xHighBuffer_, monoBuffer_, qBuffer_, buffer, params_.getWidthPercent(),
-                          params_.getPhaseAngleDeg(), params_.getPhaseRotationDeg(),
-                          activeHilbertMode_ == qbdsp::HilbertQuadratureProcessor::Mode::FIR);
-
-    if (totalNumOutputChannels == 1 && buffer.getNumChannels() > 1)
-        buffer.clear(1, 0, samples);
-
-    outputGain_.setGainDecibels(params_.getOutputGainDb());
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    outputGain_.process(context);
-
-    if (auto* gonio = static_cast<qbui::GoniometerComponent*>(activeGoniometer_.load(std::memory_order_relaxed)))
-        gonio->processBlock(buffer.getReadPointer(0),
-                            buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : buffer.getReadPointer(0), samples);
-
-    if (auto* corr = static_cast<qbui::CorrelationMeter*>(activeCorrelationMeter_.load(std::memory_order_relaxed)))
-        corr->processBlock(buffer.getReadPointer(0),
-                           buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : buffer.getReadPointer(0), samples);
+    engine_.setParameters(readEngineParams());
+    if (engine_.getLatencySamples() != getLatencySamples())
+        setLatencySamples(engine_.getLatencySamples());
+
+    // Offline bounces can afford to block on worker threads, so the FIR convolution is spread across cores there,
+    // and they run the higher-precision Render profile.
+    engine_.setOfflineRendering(isNonRealtime());
+    engine_.setProcessingProfile(isNonRealtime() ? qbdsp::ProcessingProfile::Render
+                                                 : qbdsp::ProcessingProfile::Realtime);
+    engine_.setAdaptiveQuality(params_.getAdaptiveQuality());
+    engine_.process(buffer, totalNumInputChannels, totalNumOutputChannels);
+
+    QB_TRACE_SCOPE("telemetryPush");
+    telemetry_.publishQuality(engine_.getQualityTier(), static_cast<float>(engine_.getProcessingLoad()),
+                              engine_.getNumQualityChanges());
+    telemetry_.publishNonFiniteBlocks(engine_.getNumNonFiniteBlocks());
+    telemetry_.pushOutputBlock(buffer.getReadPointer(0),
+                               buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : buffer.getReadPointer(0),
+                               samples);
 }
 
 bool QuadraBassAudioProcessor::hasEditor() const {
@@ -179,20 +159,11 @@ juce::AudioProcessorEditor* QuadraBassAudioProcessor::createEditor() {
 }
 
 void QuadraBassAudioProcessor::getStateInformation(juce::MemoryBlock& destData) {
-    auto state = params_.apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    util::StateCodec::write(params_, destData);
 }
 
 void QuadraBassAudioProcessor::setStateInformation(const void* data, int sizeInBytes) {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-    if (xmlState == nullptr)
-        return;
-
-    if (!xmlState->hasTagName(params_.apvts.state.getType()))
-        return;
-
-    params_.apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+    util::StateCodec::read(params_, data, sizeInBytes);
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter() {
@@ -1,17 +1,20 @@
 #pragma once
 
-#include "dsp/HilbertQuadratureProcessor.h"
-#include "dsp/StereoMatrixProcessor.h"
+#include "dsp/QuadraBassEngine.h"
+#include "util/AnalysisWorker.h"
 #include "util/Params.h"
+#include "util/StateCodec.h"
+#include "util/TelemetryChannel.h"
 #include <JuceHeader.h>
 
 class QuadraBassAudioProcessor final : public juce::AudioProcessor {
   public:
     QuadraBassAudioProcessor();
-    ~QuadraBassAudioProcessor() override = default;
+    ~QuadraBassAudioProcessor() override;
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    void reset() override;
 
 #if !JucePlugin_PreferredChannelConfigurations
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
@@ -40,23 +43,15 @@ class QuadraBassAudioProcessor final : public juce::AudioProcessor {
 
     util::Params& params() noexcept { return params_; }
     const util::Params& params() const noexcept { return params_; }
+    util::TelemetryChannel& telemetry() noexcept { return telemetry_; }
 
   private:
-    util::Params params_;
-    qbdsp::HilbertQuadratureProcessor hilbert_;
-    qbdsp::StereoMatrixProcessor stereoMatrix_;
-    qbdsp::HilbertQuadratureProcessor::Mode activeHilbertMode_ = qbdsp::HilbertQuadratureProcessor::Mode::FIR;
-    juce::AudioBuffer<float> monoBuffer_;
-    juce::AudioBuffer<float> xHighBuffer_;
-    juce::AudioBuffer<float> qBuffer_;
-    juce::AudioBuffer<float> zeroBuffer_;
-    juce::dsp::Gain<float> outputGain_;
-    juce::dsp::ProcessSpec processSpec_{};
+    qbdsp::EngineParams readEngineParams() const noexcept;
 
-  public:
-    std::atomic<void*> activeGoniometer_{nullptr};
-    std::atomic<void*> activeCorrelationMeter_{nullptr};
+    util::Params params_;
+    qbdsp::QuadraBassEngine engine_;
+    util::TelemetryChannel telemetry_;
+    juce::SharedResourcePointer<util::AnalysisWorker> analysisWorker_;
 
-  private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(QuadraBassAudioProcessor)
 };
@@ -0,0 +1,313 @@
+#include "quadrabass.h"
+#include "dsp/BatchQuadraBassEngine.h"
+#include "dsp/QuadraBassEngine.h"
+#include <cmath>
+#include <cstring>
+#include <new>
+
+struct qb_engine {
+    qbdsp::QuadraBassEngine engine;
+    // A copy of the input, used when an output channel is another channel's input.
+    juce::AudioBuffer<float> staging;
+    int numChannels = 0;
+    int maxBlockSize = 0;
+    bool prepared = false;
+};
+
+struct qb_batch {
+    qbdsp::BatchQuadraBassEngine engine;
+    bool prepared = false;
+};
+
+namespace {
+
+constexpr int kMaxChannels = 2;
+
+bool isValidParam(qb_param param) noexcept {
+    return param >= QB_PARAM_WIDTH_PERCENT && param <= QB_PARAM_MONO_BASS;
+}
+
+bool isBatchParam(qb_param param) noexcept {
+    return param == QB_PARAM_WIDTH_PERCENT || param == QB_PARAM_PHASE_ANGLE_DEG ||
+           param == QB_PARAM_PHASE_ROTATION_DEG;
+}
+
+bool isValidStream(const qb_batch* batch, int32_t stream) noexcept {
+    return stream >= 0 && stream < batch->engine.getNumStreams();
+}
+
+// True when some output channel is a different channel's input (e.g. swapped pointers), so copying the inputs into
+// the outputs one channel at a time would overwrite an input before it is read.
+bool hasCrossedAliasing(const float* const* inputs, float* const* outputs, int numChannels) noexcept {
+    for (int out = 0; out < numChannels; ++out) {
+        for (int in = 0; in < numChannels; ++in) {
+            if (in != out && outputs[out] == inputs[in] && outputs[out] != inputs[out])
+                return true;
+        }
+    }
+    return false;
+}
+
+// Processes through the staging buffer one prepared block at a time. Writing a block of output only overwrites the
+// same block of input, which has already been copied.
+void processStaged(qb_engine& engine, const float* const* inputs, float* const* outputs, int numSamples) noexcept {
+    for (int start = 0; start < numSamples; start += engine.maxBlockSize) {
+        const int count = juce::jmin(engine.maxBlockSize, numSamples - start);
+        for (int ch = 0; ch < engine.numChannels; ++ch)
+            engine.staging.copyFrom(ch, 0, inputs[ch] + start, count);
+
+        juce::AudioBuffer<float> block(engine.staging.getArrayOfWritePointers(), engine.numChannels, count);
+        engine.engine.process(block, engine.numChannels, engine.numChannels);
+        for (int ch = 0; ch < engine.numChannels; ++ch)
+            std::memcpy(outputs[ch] + start, engine.staging.getReadPointer(ch),
+                        sizeof(float) * static_cast<size_t>(count));
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+uint32_t qb_get_api_version(void) {
+    return QB_API_VERSION;
+}
+
+qb_engine* qb_create(void) {
+    return new (std::nothrow) qb_engine();
+}
+
+void qb_destroy(qb_engine* engine) {
+    delete engine;
+}
+
+qb_status qb_prepare(qb_engine* engine, double sampleRate, int32_t maxBlockSize, int32_t numChannels) {
+    if (engine == nullptr || !std::isfinite(sampleRate) || sampleRate <= 0.0 || maxBlockSize <= 0 ||
+        numChannels < 1 || numChannels > kMaxChannels)
+        return QB_ERROR_INVALID_ARGUMENT;
+
+    // Exceptions must not cross the C boundary; the only one prepare can throw is an allocation failure.
+    try {
+        engine->engine.prepare(sampleRate, maxBlockSize, numChannels);
+        engine->staging.setSize(numChannels, maxBlockSize);
+        // C API hosts render offline and read the latency once, so Auto settles on its backend before returning.
+        engine->engine.waitForAutoHilbertMode();
+    } catch (const std::bad_alloc&) {
+        engine->prepared = false;
+        return QB_ERROR_OUT_OF_MEMORY;
+    }
+
+    engine->numChannels = numChannels;
+    engine->maxBlockSize = maxBlockSize;
+    engine->prepared = true;
+    return QB_OK;
+}
+
+qb_status qb_reset(qb_engine* engine) {
+    if (engine == nullptr)
+        return QB_ERROR_INVALID_ARGUMENT;
+    if (!engine->prepared)
+        return QB_ERROR_NOT_PREPARED;
+
+    engine->engine.reset();
+    return QB_OK;
+}
+
+qb_status qb_set_param(qb_engine* engine, qb_param param, float value) {
+    if (engine == nullptr || !isValidParam(param) || !std::isfinite(value))
+        return QB_ERROR_INVALID_ARGUMENT;
+
+    auto params = engine->engine.getParameters();
+    switch (param) {
+    case QB_PARAM_WIDTH_PERCENT:
+        params.widthPercent = value;
+        break;
+    case QB_PARAM_HILBERT_MODE:
+        params.hilbertModeIndex = static_cast<int>(std::lround(value));
+        break;
+    case QB_PARAM_PHASE_ANGLE_DEG:
+        params.phaseAngleDeg = value;
+        break;
+    case QB_PARAM_PHASE_ROTATION_DEG:
+        params.phaseRotationDeg = value;
+        break;
+    case QB_PARAM_OUTPUT_GAIN_DB:
+        params.outputGainDb = value;
+        break;
+    case QB_PARAM_MONO_BASS:
+        params.monoBassIndex = static_cast<int>(std::lround(value));
+        break;
+    }
+
+    engine->engine.setParameters(params);
+    return QB_OK;
+}
+
+qb_status qb_get_param(const qb_engine* engine, qb_param param, float* value) {
+    if (engine == nullptr || !isValidParam(param) || value == nullptr)
+        return QB_ERROR_INVALID_ARGUMENT;
+
+    const auto& params = engine->engine.getParameters();
+    switch (param) {
+    case QB_PARAM_WIDTH_PERCENT:
+        *value = params.widthPercent;
+        break;
+    case QB_PARAM_HILBERT_MODE:
+        *value = static_cast<float>(params.hilbertModeIndex);
+        break;
+    case QB_PARAM_PHASE_ANGLE_DEG:
+        *value = params.phaseAngleDeg;
+        break;
+    case QB_PARAM_PHASE_ROTATION_DEG:
+        *value = params.phaseRotationDeg;
+        break;
+    case QB_PARAM_OUTPUT_GAIN_DB:
+        *value = params.outputGainDb;
+        break;
+    case QB_PARAM_MONO_BASS:
+        *value = static_cast<float>(params.monoBassIndex);
+        break;
+    }
+
+    return QB_OK;
+}
+
+qb_status qb_process(qb_engine* engine, const float* const* inputs, float* const* outputs, int32_t numSamples) {
+    if (engine == nullptr || inputs == nullptr || outputs == nullptr || numSamples < 0)
+        return QB_ERROR_INVALID_ARGUMENT;
+    if (!engine->prepared)
+        return QB_ERROR_NOT_PREPARED;
+
+    for (int ch = 0; ch < engine->numChannels; ++ch) {
+        if (inputs[ch] == nullptr || outputs[ch] == nullptr)
+            return QB_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (numSamples == 0)
+        return QB_OK;
+
+    juce::ScopedNoDenormals noDenormals;
+    if (hasCrossedAliasing(inputs, outputs, engine->numChannels)) {
+        processStaged(*engine, inputs, outputs, numSamples);
+        return QB_OK;
+    }
+
+    for (int ch = 0; ch < engine->numChannels; ++ch) {
+        if (inputs[ch] != outputs[ch])
+            std::memmove(outputs[ch], inputs[ch], sizeof(float) * static_cast<size_t>(numSamples));
+    }
+
+    juce::AudioBuffer<float> buffer(outputs, engine->numChannels, numSamples);
+    engine->engine.process(buffer, engine->numChannels, engine->numChannels);
+    return QB_OK;
+}
+
+int32_t qb_get_latency_samples(const qb_engine* engine) {
+    if (engine == nullptr || !engine->prepared)
+        return 0;
+
+    return engine->engine.getLatencySamples();
+}
+
+qb_batch* qb_batch_create(void) {
+    return new (std::nothrow) qb_batch();
+}
+
+void qb_batch_destroy(qb_batch* batch) {
+    delete batch;
+}
+
+qb_status qb_batch_prepare(qb_batch* batch, double sampleRate, int32_t numStreams) {
+    if (batch == nullptr || !std::isfinite(sampleRate) || sampleRate <= 0.0 || numStreams <= 0)
+        return QB_ERROR_INVALID_ARGUMENT;
+
+    try {
+        batch->engine.prepare(sampleRate, numStreams);
+    } catch (const std::bad_alloc&) {
+        batch->prepared = false;
+        return QB_ERROR_OUT_OF_MEMORY;
+    }
+
+    batch->prepared = true;
+    return QB_OK;
+}
+
+qb_status qb_batch_reset(qb_batch* batch) {
+    if (batch == nullptr)
+        return QB_ERROR_INVALID_ARGUMENT;
+    if (!batch->prepared)
+        return QB_ERROR_NOT_PREPARED;
+
+    batch->engine.reset();
+    return QB_OK;
+}
+
+qb_status qb_batch_set_stream_param(qb_batch* batch, int32_t stream, qb_param param, float value) {
+    if (batch == nullptr || !isBatchParam(param) || !std::isfinite(value))
+        return QB_ERROR_INVALID_ARGUMENT;
+    if (!batch->prepared)
+        return QB_ERROR_NOT_PREPARED;
+    if (!isValidStream(batch, stream))
+        return QB_ERROR_INVALID_ARGUMENT;
+
+    auto& engine = batch->engine;
+    float width = engine.getStreamWidthPercent(stream);
+    float angle = engine.getStreamPhaseAngleDeg(stream);
+    float rotation = engine.getStreamPhaseRotationDeg(stream);
+    if (param == QB_PARAM_WIDTH_PERCENT)
+        width = value;
+    else if (param == QB_PARAM_PHASE_ANGLE_DEG)
+        angle = value;
+    else
+        rotation = value;
+
+    engine.setStreamParameters(stream, width, angle, rotation);
+    return QB_OK;
+}
+
+qb_status qb_batch_get_stream_param(const qb_batch* batch, int32_t stream, qb_param param, float* value) {
+    if (batch == nullptr || !isBatchParam(param) || value == nullptr)
+        return QB_ERROR_INVALID_ARGUMENT;
+    if (!batch->prepared)
+        return QB_ERROR_NOT_PREPARED;
+    if (!isValidStream(batch, stream))
+        return QB_ERROR_INVALID_ARGUMENT;
+
+    const auto& engine = batch->engine;
+    if (param == QB_PARAM_WIDTH_PERCENT)
+        *value = engine.getStreamWidthPercent(stream);
+    else if (param == QB_PARAM_PHASE_ANGLE_DEG)
+        *value = engine.getStreamPhaseAngleDeg(stream);
+    else
+        *value = engine.getStreamPhaseRotationDeg(stream);
+    return QB_OK;
+}
+
+qb_status qb_batch_process(qb_batch* batch, const float* const* inputs, float* const* leftOutputs,
+                           float* const* rightOutputs, int32_t numSamples) {
+    if (batch == nullptr || inputs == nullptr || leftOutputs == nullptr || rightOutputs == nullptr ||
+        numSamples < 0)
+        return QB_ERROR_INVALID_ARGUMENT;
+    if (!batch->prepared)
+        return QB_ERROR_NOT_PREPARED;
+
+    for (int stream = 0; stream < batch->engine.getNumStreams(); ++stream)
+        if (inputs[stream] == nullptr || leftOutputs[stream] == nullptr || rightOutputs[stream] == nullptr ||
+            leftOutputs[stream] == rightOutputs[stream])
+            return QB_ERROR_INVALID_ARGUMENT;
+
+    if (numSamples == 0)
+        return QB_OK;
+
+    juce::ScopedNoDenormals noDenormals;
+    batch->engine.process(inputs, leftOutputs, rightOutputs, numSamples);
+    return QB_OK;
+}
+
+int32_t qb_batch_get_latency_samples(const qb_batch* batch) {
+    if (batch == nullptr || !batch->prepared)
+        return 0;
+
+    return batch->engine.getLatencySamples();
+}
+
+} // extern "C"
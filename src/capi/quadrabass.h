@@ -0,0 +1,121 @@
+#ifndef QUADRABASS_C_API_H
+#define QUADRABASS_C_API_H
+
+/*
+ * C interface to the QuadraBass DSP engine (the quadrabass_dsp library).
+ *
+ * An engine instance is not thread-safe: qb_prepare, qb_set_param and qb_process must not run concurrently on the
+ * same instance. qb_process never allocates once qb_prepare has returned.
+ */
+
+#include <stdint.h>
+
+#if defined(QUADRABASS_DSP_SHARED)
+#if defined(_WIN32)
+#if defined(QUADRABASS_DSP_BUILDING)
+#define QB_API __declspec(dllexport)
+#else
+#define QB_API __declspec(dllimport)
+#endif
+#else
+#define QB_API __attribute__((visibility("default")))
+#endif
+#else
+#define QB_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bumped whenever a function signature or enum value changes meaning, or new ones are added.
+ *   1: engine lifecycle, parameters 0..4, Hilbert modes 0..3.
+ *   2: qb_batch, QB_PARAM_MONO_BASS, Hilbert modes 4 (Auto) and 5 (Velvet).
+ */
+#define QB_API_VERSION 2
+
+typedef struct qb_engine qb_engine;
+
+typedef enum qb_status {
+    QB_OK = 0,
+    QB_ERROR_INVALID_ARGUMENT = -1,
+    QB_ERROR_NOT_PREPARED = -2,
+    QB_ERROR_OUT_OF_MEMORY = -3
+} qb_status;
+
+/* Same ranges and defaults as the plugin parameters; out-of-range values are clamped. */
+typedef enum qb_param {
+    QB_PARAM_WIDTH_PERCENT = 0,      /* 0 .. 100, default 0 */
+    QB_PARAM_HILBERT_MODE = 1,       /* 0 IIR, 1 FIR, 2 Multirate, 3 Spectral, 4 Auto, 5 Velvet; default 1 */
+    QB_PARAM_PHASE_ANGLE_DEG = 2,    /* 0 .. 180, default 90 */
+    QB_PARAM_PHASE_ROTATION_DEG = 3, /* -180 .. 180, default 0 */
+    QB_PARAM_OUTPUT_GAIN_DB = 4,     /* -60 .. 12, default 0 */
+    QB_PARAM_MONO_BASS = 5           /* 0 = off, 1..6 = 60, 80, 100, 120, 150, 200 Hz crossover; default 0 */
+} qb_param;
+
+QB_API uint32_t qb_get_api_version(void);
+
+/* Returns NULL if the instance could not be allocated. */
+QB_API qb_engine* qb_create(void);
+QB_API void qb_destroy(qb_engine* engine);
+
+/*
+ * numChannels is 1 (mono) or 2 (stereo). Must be called before processing and again whenever the rate changes. In
+ * Auto Hilbert mode the first prepare for a new rate and block size benchmarks the backends before returning.
+ */
+QB_API qb_status qb_prepare(qb_engine* engine, double sampleRate, int32_t maxBlockSize, int32_t numChannels);
+QB_API qb_status qb_reset(qb_engine* engine);
+
+QB_API qb_status qb_set_param(qb_engine* engine, qb_param param, float value);
+QB_API qb_status qb_get_param(const qb_engine* engine, qb_param param, float* value);
+
+/*
+ * Processes numSamples of planar audio. inputs and outputs each hold the prepared number of channel pointers and
+ * may be the same arrays for in-place processing. An output channel may also be another channel's input (swapped
+ * channels), but must not partially overlap a different channel's input. Blocks longer than maxBlockSize are split
+ * internally.
+ */
+QB_API qb_status qb_process(qb_engine* engine, const float* const* inputs, float* const* outputs,
+                            int32_t numSamples);
+
+/* Output delay in samples for the current settings; changes with QB_PARAM_HILBERT_MODE and QB_PARAM_MONO_BASS. */
+QB_API int32_t qb_get_latency_samples(const qb_engine* engine);
+
+/*
+ * Batch interface for widening many independent mono streams at once, for mass offline rendering. All streams run
+ * the FIR Hilbert mode with their histories interleaved, so the convolution is vectorised across streams. Each
+ * stream produces the same stereo output as a qb_engine in FIR mode with unity output gain fed that stream as both
+ * input channels. The same threading rules as qb_engine apply per batch.
+ */
+typedef struct qb_batch qb_batch;
+
+/* Returns NULL if the instance could not be allocated. */
+QB_API qb_batch* qb_batch_create(void);
+QB_API void qb_batch_destroy(qb_batch* batch);
+
+/* Allocates the histories for numStreams streams, all at default parameters. */
+QB_API qb_status qb_batch_prepare(qb_batch* batch, double sampleRate, int32_t numStreams);
+QB_API qb_status qb_batch_reset(qb_batch* batch);
+
+/*
+ * Only QB_PARAM_WIDTH_PERCENT, QB_PARAM_PHASE_ANGLE_DEG and QB_PARAM_PHASE_ROTATION_DEG apply to batch streams;
+ * other parameters are rejected. Requires qb_batch_prepare, which sets the stream count.
+ */
+QB_API qb_status qb_batch_set_stream_param(qb_batch* batch, int32_t stream, qb_param param, float value);
+QB_API qb_status qb_batch_get_stream_param(const qb_batch* batch, int32_t stream, qb_param param, float* value);
+
+/*
+ * inputs, leftOutputs and rightOutputs each hold one pointer per stream to numSamples floats. An input may be the
+ * same buffer as one of its stream's outputs. Never allocates.
+ */
+QB_API qb_status qb_batch_process(qb_batch* batch, const float* const* inputs, float* const* leftOutputs,
+                                  float* const* rightOutputs, int32_t numSamples);
+
+QB_API int32_t qb_batch_get_latency_samples(const qb_batch* batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QUADRABASS_C_API_H */
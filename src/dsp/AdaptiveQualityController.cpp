@@ -0,0 +1,107 @@
+#include "AdaptiveQualityController.h"
+#include <algorithm>
+#include <cmath>
+
+namespace qbdsp {
+
+namespace {
+
+constexpr double kMicroPerCore = 1.0e6;
+
+} // namespace
+
+AdaptiveQualityController::SessionLoad::Contribution::Contribution(SessionLoad& session) noexcept
+    : session_(session) {}
+
+AdaptiveQualityController::SessionLoad::Contribution::~Contribution() {
+    set(0.0);
+}
+
+void AdaptiveQualityController::SessionLoad::Contribution::set(double load) noexcept {
+    const auto micro = static_cast<std::int64_t>(std::llround(std::clamp(load, 0.0, 1.0e3) * kMicroPerCore));
+    if (micro != published_) {
+        session_.microLoad_.fetch_add(micro - published_, std::memory_order_relaxed);
+        published_ = micro;
+    }
+}
+
+double AdaptiveQualityController::SessionLoad::getTotal() const noexcept {
+    return static_cast<double>(microLoad_.load(std::memory_order_relaxed)) / kMicroPerCore;
+}
+
+void AdaptiveQualityController::setNumTiers(int numTiers) noexcept {
+    numTiers_ = std::max(1, numTiers);
+    numTransitions_ = 0;
+    reset();
+}
+
+void AdaptiveQualityController::setBudget(double fractionOfBlock) noexcept {
+    budget_ = std::clamp(fractionOfBlock, 0.05, 1.0);
+}
+
+void AdaptiveQualityController::setSessionBudget(double cores) noexcept {
+    sessionBudget_ = std::max(0.05, cores);
+}
+
+void AdaptiveQualityController::reset() noexcept {
+    tier_ = 0;
+    load_ = 0.0;
+    hasLoad_ = false;
+    secondsSinceChange_ = 0.0;
+    secondsWithHeadroom_ = 0.0;
+}
+
+int AdaptiveQualityController::update(double processingSeconds, double blockSeconds, double sessionLoad) noexcept {
+    if (!(blockSeconds > 0.0) || !(processingSeconds >= 0.0))
+        return tier_;
+
+    const double blockLoad = processingSeconds / blockSeconds;
+    if (hasLoad_) {
+        const double alpha = 1.0 - std::exp(-blockSeconds / kLoadTimeConstantSeconds);
+        load_ += alpha * (blockLoad - load_);
+    } else {
+        load_ = blockLoad;
+        hasLoad_ = true;
+    }
+
+    secondsSinceChange_ += blockSeconds;
+    if (load_ > budget_ || sessionLoad > sessionBudget_) {
+        secondsWithHeadroom_ = 0.0;
+        if (tier_ < numTiers_ - 1 && secondsSinceChange_ >= kStepDownHoldSeconds) {
+            ++tier_;
+            ++numTransitions_;
+            secondsSinceChange_ = 0.0;
+        }
+        return tier_;
+    }
+
+    // Every instance in an overloaded session steps down together, so they would also step up together: the
+    // session has to have room for all of them doubling.
+    if (tier_ > 0 && 2.0 * load_ < kStepUpMargin * budget_ && 2.0 * sessionLoad < kStepUpMargin * sessionBudget_) {
+        secondsWithHeadroom_ += blockSeconds;
+        if (secondsWithHeadroom_ >= kStepUpHoldSeconds) {
+            --tier_;
+            ++numTransitions_;
+            secondsSinceChange_ = 0.0;
+            secondsWithHeadroom_ = 0.0;
+        }
+    } else {
+        secondsWithHeadroom_ = 0.0;
+    }
+
+    return tier_;
+}
+
+int AdaptiveQualityController::getTier() const noexcept {
+    return tier_;
+}
+
+double AdaptiveQualityController::getLoad() const noexcept {
+    return load_;
+}
+
+int AdaptiveQualityController::getNumTransitions() const noexcept {
+    return numTransitions_;
+}
+
+} // namespace qbdsp
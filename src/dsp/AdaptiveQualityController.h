@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace qbdsp {
+
+// Chooses a quality tier from measured processing time, for hosts whose CPU cannot always keep up with the full FIR
+// kernel. The load is the processing time over the block's real-time duration, smoothed over about
+// kLoadTimeConstantSeconds so single late blocks (page faults, preemption) are ignored. When it stays above the
+// budget, or the whole session's load (see SessionLoad) stays above the session budget, the tier steps down
+// (cheaper); when even twice both costs would stay well inside their budgets for kStepUpHoldSeconds, it steps back
+// up. Pure bookkeeping: the caller times the blocks and applies the tier.
+class AdaptiveQualityController final {
+  public:
+    // Sum of the smoothed loads of every instance running adaptive quality in the process, in cores' worth of real
+    // time. Forty instances at 0.05 each never come near their own budget, but together they take two cores, so
+    // each one also checks this total. Shared through juce::SharedResourcePointer; lock-free.
+    class SessionLoad final {
+      public:
+        // One instance's share of the total, withdrawn when it is destroyed.
+        class Contribution final {
+          public:
+            explicit Contribution(SessionLoad& session) noexcept;
+            ~Contribution();
+
+            void set(double load) noexcept;
+
+          private:
+            SessionLoad& session_;
+            std::int64_t published_ = 0;
+
+            Contribution(const Contribution&) = delete;
+            Contribution& operator=(const Contribution&) = delete;
+        };
+
+        double getTotal() const noexcept;
+
+      private:
+        // Millionths of a core, so contributions add exactly and in any order.
+        std::atomic<std::int64_t> microLoad_{0};
+    };
+
+    // Fraction of each block's real-time duration the engine may spend before quality is reduced.
+    static constexpr double kDefaultBudget = 0.5;
+    // Fraction of the machine's cores all adaptive instances together may use; the caller scales it by the core
+    // count with setSessionBudget().
+    static constexpr double kDefaultSessionBudgetPerCore = 0.25;
+    static constexpr double kLoadTimeConstantSeconds = 0.3;
+    // Minimum time between a change and the next step down, so the smoothed load can see the cheaper tier's cost.
+    static constexpr double kStepDownHoldSeconds = 0.25;
+    static constexpr double kStepUpHoldSeconds = 2.0;
+    // Stepping up roughly doubles the convolution cost; it is only tried when that would land below this
+    // fraction of the budget.
+    static constexpr double kStepUpMargin = 0.75;
+
+    // Tier 0 is full quality, numTiers - 1 the cheapest. Resets the controller and its transition count.
+    void setNumTiers(int numTiers) noexcept;
+    void setBudget(double fractionOfBlock) noexcept;
+    // Session load (in cores) above which every instance steps down. Defaults to a quarter of one core.
+    void setSessionBudget(double cores) noexcept;
+    // Back to tier 0 with no load history; the transition count is kept.
+    void reset() noexcept;
+
+    // Feeds one block's timing and the latest SessionLoad total, and returns the tier to run the next block at.
+    int update(double processingSeconds, double blockSeconds, double sessionLoad = 0.0) noexcept;
+
+    int getTier() const noexcept;
+    // Smoothed processing time over real time, e.g. 0.2 when processing takes a fifth of each block.
+    double getLoad() const noexcept;
+    int getNumTransitions() const noexcept;
+
+  private:
+    int numTiers_ = 1;
+    double budget_ = kDefaultBudget;
+    double sessionBudget_ = kDefaultSessionBudgetPerCore;
+    int tier_ = 0;
+    double load_ = 0.0;
+    bool hasLoad_ = false;
+    double secondsSinceChange_ = 0.0;
+    double secondsWithHeadroom_ = 0.0;
+    int numTransitions_ = 0;
+};
+
+} // namespace qbdsp
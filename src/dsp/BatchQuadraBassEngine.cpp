@@ -0,0 +1,159 @@
+#include "BatchQuadraBassEngine.h"
+#include "EngineParams.h"
+#include "HilbertQuadratureProcessor.h"
+#include "KernelDispatch.h"
+#include "StereoMatrixProcessor.h"
+#include "util/Trace.h"
+
+namespace qbdsp {
+
+void BatchQuadraBassEngine::prepare(double sampleRate, int numStreams) {
+    QB_TRACE_SCOPE("BatchQuadraBassEngine::prepare");
+    numStreams_ = juce::jmax(0, numStreams);
+    streams_.assign(static_cast<size_t>(numStreams_), Stream{});
+    for (int stream = 0; stream < numStreams_; ++stream)
+        setStreamParameters(stream, 0.0f, 90.0f, 0.0f);
+
+    // The same taps, rounded the same way, as HilbertQuadratureProcessor's FIR mode at this rate.
+    const double sampleRateSafe = sampleRate > 1.0 ? sampleRate : 48000.0;
+    const auto packed = HilbertQuadratureProcessor::designPackedFIR(
+        sampleRateSafe, HilbertQuadratureProcessor::chooseFIRTapCount(sampleRateSafe));
+    tapCount_ = packed.tapCount;
+    latencySamples_ = (tapCount_ - 1) / 2;
+    firstNonZeroTap_ = packed.firstNonZeroTap;
+    packedCoeffs_.assign(packed.coeffs.begin(), packed.coeffs.end());
+
+    numTiles_ = (numStreams_ + kStreamTile - 1) / kStreamTile;
+    historyRows_ = tapCount_ - 1 + kHistoryChunk;
+    history_.assign(static_cast<size_t>(numTiles_) * static_cast<size_t>(historyRows_ * kStreamTile), 0.0f);
+    quadrature_.assign(static_cast<size_t>(kHistoryChunk * kStreamTile), 0.0f);
+    reset();
+}
+
+void BatchQuadraBassEngine::reset() noexcept {
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    historyRow_ = tapCount_ - 1;
+}
+
+int BatchQuadraBassEngine::getNumStreams() const noexcept {
+    return numStreams_;
+}
+
+int BatchQuadraBassEngine::getLatencySamples() const noexcept {
+    return latencySamples_;
+}
+
+void BatchQuadraBassEngine::setStreamParameters(int stream, float widthPercent, float phaseAngleDeg,
+                                                float phaseRotationDeg) noexcept {
+    if (stream < 0 || stream >= numStreams_)
+        return;
+
+    auto& s = streams_[static_cast<size_t>(stream)];
+    s.widthPercent = juce::jlimit(EngineParams::kMinWidthPercent, EngineParams::kMaxWidthPercent, widthPercent);
+    s.phaseAngleDeg = juce::jlimit(EngineParams::kMinPhaseAngleDeg, EngineParams::kMaxPhaseAngleDeg, phaseAngleDeg);
+    s.phaseRotationDeg =
+        juce::jlimit(EngineParams::kMinPhaseRotationDeg, EngineParams::kMaxPhaseRotationDeg, phaseRotationDeg);
+
+    // Gains for the low, I, Q and xHigh inputs; the FIR width law only ever uses I and Q.
+    float leftGains[4] = {};
+    float rightGains[4] = {};
+    bool activeInputs[4] = {};
+    StereoMatrixProcessor::computeGains(s.widthPercent, s.phaseAngleDeg, s.phaseRotationDeg, true, leftGains,
+                                        rightGains, activeInputs);
+    s.iLeft = leftGains[1];
+    s.qLeft = leftGains[2];
+    s.iRight = rightGains[1];
+    s.qRight = rightGains[2];
+    s.usesQuadrature = activeInputs[2];
+}
+
+float BatchQuadraBassEngine::getStreamWidthPercent(int stream) const noexcept {
+    return stream >= 0 && stream < numStreams_ ? streams_[static_cast<size_t>(stream)].widthPercent : 0.0f;
+}
+
+float BatchQuadraBassEngine::getStreamPhaseAngleDeg(int stream) const noexcept {
+    return stream >= 0 && stream < numStreams_ ? streams_[static_cast<size_t>(stream)].phaseAngleDeg : 0.0f;
+}
+
+float BatchQuadraBassEngine::getStreamPhaseRotationDeg(int stream) const noexcept {
+    return stream >= 0 && stream < numStreams_ ? streams_[static_cast<size_t>(stream)].phaseRotationDeg : 0.0f;
+}
+
+void BatchQuadraBassEngine::process(const float* const* inputs, float* const* leftOutputs,
+                                    float* const* rightOutputs, int numSamples) noexcept {
+    QB_TRACE_SCOPE("BatchQuadraBassEngine::process");
+    if (numStreams_ <= 0 || history_.empty())
+        return;
+
+    int done = 0;
+    while (done < numSamples) {
+        if (historyRow_ == historyRows_) {
+            const int keep = tapCount_ - 1;
+            for (int tile = 0; tile < numTiles_; ++tile) {
+                float* rows = getTileHistory(tile);
+                std::copy(rows + (historyRows_ - keep) * kStreamTile, rows + historyRows_ * kStreamTile, rows);
+            }
+            historyRow_ = keep;
+        }
+
+        const int count = juce::jmin(numSamples - done, historyRows_ - historyRow_);
+        for (int tile = 0; tile < numTiles_; ++tile)
+            processTile(tile, inputs, leftOutputs, rightOutputs, done, count);
+
+        historyRow_ += count;
+        done += count;
+    }
+}
+
+float* BatchQuadraBassEngine::getTileHistory(int tile) noexcept {
+    return history_.data() + static_cast<size_t>(tile) * static_cast<size_t>(historyRows_ * kStreamTile);
+}
+
+void BatchQuadraBassEngine::processTile(int tile, const float* const* inputs, float* const* leftOutputs,
+                                        float* const* rightOutputs, int offset, int count) noexcept {
+    const int firstStream = tile * kStreamTile;
+    const int numTileStreams = juce::jmin(kStreamTile, numStreams_ - firstStream);
+    const Stream* streams = streams_.data() + firstStream;
+    float* newestRow = getTileHistory(tile) + historyRow_ * kStreamTile;
+
+    // Transpose the new samples into rows before any output is written, so in-place processing is safe.
+    bool tileUsesQuadrature = false;
+    for (int k = 0; k < numTileStreams; ++k) {
+        const float* in = inputs[firstStream + k] + offset;
+        for (int t = 0; t < count; ++t)
+            newestRow[t * kStreamTile + k] = in[t];
+        tileUsesQuadrature |= streams[k].usesQuadrature;
+    }
+
+    if (tileUsesQuadrature)
+        KernelDispatch::get().convolveStride2Batch(packedCoeffs_.data(), static_cast<int>(packedCoeffs_.size()),
+                                                   newestRow - firstNonZeroTap_ * kStreamTile, kStreamTile,
+                                                   quadrature_.data(), numTileStreams, count);
+
+    const float* delayedRow = newestRow - latencySamples_ * kStreamTile;
+    for (int k = 0; k < numTileStreams; ++k) {
+        const Stream& s = streams[k];
+        const float* iColumn = delayedRow + k;
+        float* left = leftOutputs[firstStream + k] + offset;
+        float* right = rightOutputs[firstStream + k] + offset;
+
+        if (!s.usesQuadrature) {
+            for (int t = 0; t < count; ++t) {
+                const float i = iColumn[t * kStreamTile];
+                left[t] = s.iLeft * i;
+                right[t] = s.iRight * i;
+            }
+            continue;
+        }
+
+        const float* qColumn = quadrature_.data() + k;
+        for (int t = 0; t < count; ++t) {
+            const float i = iColumn[t * kStreamTile];
+            const float q = qColumn[t * kStreamTile];
+            left[t] = s.iLeft * i + s.qLeft * q;
+            right[t] = s.iRight * i + s.qRight * q;
+        }
+    }
+}
+
+} // namespace qbdsp
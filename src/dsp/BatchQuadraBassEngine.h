@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+
+namespace qbdsp {
+
+// FIR-mode widening for many independent mono streams at once, for server-side mass rendering. Streams are grouped
+// into tiles whose histories are interleaved into structure-of-arrays rows (row t holds each of the tile's samples
+// t), so each coefficient load feeds a whole vector of streams instead of one. A stream's output matches a
+// QuadraBassEngine in FIR mode fed the same mono signal; Q is bit-identical. Each stream has its own width, angle
+// and rotation; there is no output gain stage.
+class BatchQuadraBassEngine final {
+  public:
+    // Streams sharing one contiguous history; a tile's history (about 600 KB at 48 kHz) stays in L2 while a chunk
+    // is convolved.
+    static constexpr int kStreamTile = 16;
+    // Rows appended to the history between compactions.
+    static constexpr int kHistoryChunk = 1024;
+
+    void prepare(double sampleRate, int numStreams);
+    void reset() noexcept;
+
+    int getNumStreams() const noexcept;
+    int getLatencySamples() const noexcept;
+
+    // Values are clamped to the EngineParams ranges and take effect from the next processed block.
+    void setStreamParameters(int stream, float widthPercent, float phaseAngleDeg, float phaseRotationDeg) noexcept;
+    float getStreamWidthPercent(int stream) const noexcept;
+    float getStreamPhaseAngleDeg(int stream) const noexcept;
+    float getStreamPhaseRotationDeg(int stream) const noexcept;
+
+    // inputs, leftOutputs and rightOutputs each hold getNumStreams() pointers to numSamples floats. An input may
+    // share its buffer with either of its outputs. Never allocates.
+    void process(const float* const* inputs, float* const* leftOutputs, float* const* rightOutputs,
+                 int numSamples) noexcept;
+
+  private:
+    struct Stream {
+        float widthPercent = 0.0f;
+        float phaseAngleDeg = 90.0f;
+        float phaseRotationDeg = 0.0f;
+        float iLeft = 1.0f;
+        float qLeft = 0.0f;
+        float iRight = 1.0f;
+        float qRight = 0.0f;
+        bool usesQuadrature = false;
+    };
+
+    float* getTileHistory(int tile) noexcept;
+    void processTile(int tile, const float* const* inputs, float* const* leftOutputs, float* const* rightOutputs,
+                     int offset, int count) noexcept;
+
+    int numStreams_ = 0;
+    int numTiles_ = 0;
+    std::vector<Stream> streams_;
+
+    std::vector<float> packedCoeffs_;
+    int firstNonZeroTap_ = 0;
+    int tapCount_ = 0;
+    int latencySamples_ = 0;
+
+    // Per tile, the last tapCount_ - 1 rows followed by up to kHistoryChunk new ones, compacted back to the front
+    // when full. Rows are kStreamTile floats; lanes past the last stream stay zero.
+    std::vector<float> history_;
+    int historyRows_ = 0;
+    int historyRow_ = 0;
+    // Q for one tile over one chunk, row-major by sample.
+    std::vector<float> quadrature_;
+};
+
+} // namespace qbdsp
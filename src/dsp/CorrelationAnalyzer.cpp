@@ -0,0 +1,31 @@
+#include "CorrelationAnalyzer.h"
+#include "KernelDispatch.h"
+#include <cmath>
+
+namespace qbdsp {
+
+void CorrelationAnalyzer::reset() noexcept {
+    sumLR_ = 0.0f;
+    sumL2_ = 0.0f;
+    sumR2_ = 0.0f;
+    correlation_ = 1.0f;
+}
+
+void CorrelationAnalyzer::processBlock(const float* left, const float* right, int numSamples) noexcept {
+    // Decay to avoid overflow and limit window (~200ms time constant at 48kHz)
+    float sums[3] = {sumLR_, sumL2_, sumR2_};
+    KernelDispatch::get().accumulateCorrelation(left, right, numSamples, 0.9999f, sums);
+    sumLR_ = sums[0];
+    sumL2_ = sums[1];
+    sumR2_ = sums[2];
+
+    float denom = std::sqrt(sumL2_ * sumR2_);
+    float corr = (denom > 1e-6f) ? (sumLR_ / denom) : 0.0f;
+    correlation_ = juce::jlimit(-1.0f, 1.0f, corr);
+}
+
+float CorrelationAnalyzer::getCorrelation() const noexcept {
+    return correlation_;
+}
+
+} // namespace qbdsp
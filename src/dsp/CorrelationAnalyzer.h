@@ -0,0 +1,21 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+namespace qbdsp {
+
+// Running L/R correlation with an exponential window. Not thread-safe; owned by the analysis worker.
+class CorrelationAnalyzer final {
+  public:
+    void reset() noexcept;
+    void processBlock(const float* left, const float* right, int numSamples) noexcept;
+    float getCorrelation() const noexcept;
+
+  private:
+    float sumLR_ = 0.0f;
+    float sumL2_ = 0.0f;
+    float sumR2_ = 0.0f;
+    float correlation_ = 1.0f;
+};
+
+} // namespace qbdsp
@@ -0,0 +1,37 @@
+#pragma once
+
+namespace qbdsp {
+
+// Plain snapshot of the user-facing parameters, shared by the plugin's parameter layout and the C API so both
+// expose the same ranges and defaults.
+struct EngineParams {
+    static constexpr float kMinWidthPercent = 0.0f;
+    static constexpr float kMaxWidthPercent = 100.0f;
+    static constexpr int kNumHilbertModes = 6;
+    // Not a HilbertQuadratureProcessor::Mode value (Velvet, added later, follows it): the engine picks the fastest
+    // linear-phase mode for the prepared rate and block size (see HilbertEngineSelector).
+    static constexpr int kAutoHilbertModeIndex = 4;
+    static constexpr float kMinPhaseAngleDeg = 0.0f;
+    static constexpr float kMaxPhaseAngleDeg = 180.0f;
+    static constexpr float kMinPhaseRotationDeg = -180.0f;
+    static constexpr float kMaxPhaseRotationDeg = 180.0f;
+    static constexpr float kMinOutputGainDb = -60.0f;
+    static constexpr float kMaxOutputGainDb = 12.0f;
+    // Off, then the crossover frequencies in MonoBassCrossover::kFrequenciesHz.
+    static constexpr int kNumMonoBassOptions = 7;
+
+    float widthPercent = 0.0f;
+    int hilbertModeIndex = 1;
+    float phaseAngleDeg = 90.0f;
+    float phaseRotationDeg = 0.0f;
+    float outputGainDb = 0.0f;
+    int monoBassIndex = 0;
+};
+
+// Realtime keeps the cheap processing used during playback. Render (chosen automatically for non-realtime
+// bounces) trades CPU for accuracy: double-precision FIR convolution, a high-order IIR quadrature network designed
+// for the session rate, and per-sample interpolation of stereo matrix gains. Latency is identical in both, so
+// host delay compensation never changes between tracking and bouncing.
+enum class ProcessingProfile : int { Realtime = 0, Render = 1 };
+
+} // namespace qbdsp
@@ -0,0 +1,138 @@
+#include "FirDesign.h"
+#include <algorithm>
+#include <cmath>
+
+namespace qbdsp {
+
+namespace {
+
+double besselI0(double x) noexcept {
+    double sum = 1.0;
+    double term = 1.0;
+    const double halfX = 0.5 * x;
+    for (int k = 1; k < 64; ++k) {
+        term *= (halfX / static_cast<double>(k)) * (halfX / static_cast<double>(k));
+        sum += term;
+        if (term < sum * 1.0e-16)
+            break;
+    }
+    return sum;
+}
+
+double kaiserBeta(double stopbandDb) noexcept {
+    if (stopbandDb > 50.0)
+        return 0.1102 * (stopbandDb - 8.7);
+    if (stopbandDb >= 21.0)
+        return 0.5842 * std::pow(stopbandDb - 21.0, 0.4) + 0.07886 * (stopbandDb - 21.0);
+    return 0.0;
+}
+
+template <typename Sample>
+void designHilbertImpl(Sample* coeffs, int numTaps, double sampleRate, double normMinHz, double normMaxHz) {
+    std::fill(coeffs, coeffs + numTaps, Sample(0));
+
+    const int half = (numTaps - 1) / 2;
+    constexpr double pi = juce::MathConstants<double>::pi;
+    constexpr double twoPi = juce::MathConstants<double>::twoPi;
+    const double denom = static_cast<double>(numTaps - 1);
+
+    for (int d = 0; d < numTaps; ++d) {
+        const int n = d - half;
+        if (n == 0 || (n % 2) == 0)
+            continue;
+
+        const double base = 2.0 / (pi * static_cast<double>(n));
+        const double phase = twoPi * static_cast<double>(d) / denom;
+        const double blackman = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+        coeffs[d] = static_cast<Sample>(base * blackman);
+    }
+
+    // Least-squares passband normalization (do not force DC/Nyquist).
+    const double sampleRateSafe = sampleRate > 1.0 ? sampleRate : 48000.0;
+    const double minFn = normMinHz / sampleRateSafe; // cycles/sample, avoid DC singular behavior
+    const double maxFn = normMaxHz / sampleRateSafe;
+    constexpr int kNormBins = 512;
+
+    double sumMag = 0.0;
+    double sumMag2 = 0.0;
+    for (int k = 0; k < kNormBins; ++k) {
+        const double u = static_cast<double>(k) / static_cast<double>(kNormBins - 1);
+        const double fn = minFn + (maxFn - minFn) * u;
+        const double omega = twoPi * fn;
+
+        double real = 0.0;
+        double imag = 0.0;
+        for (int d = 0; d < numTaps; ++d) {
+            const double c = static_cast<double>(coeffs[d]);
+            const double angle = omega * static_cast<double>(d);
+            real += c * std::cos(angle);
+            imag -= c * std::sin(angle);
+        }
+
+        const double mag = std::hypot(real, imag);
+        sumMag += mag;
+        sumMag2 += mag * mag;
+    }
+
+    const double scale = sumMag2 > 1.0e-12 ? (sumMag / sumMag2) : 1.0;
+    const auto sampleScale = static_cast<Sample>(scale);
+    for (int d = 0; d < numTaps; ++d)
+        coeffs[d] *= sampleScale;
+}
+
+} // namespace
+
+int FirDesign::chooseHilbertTapCount(double sampleRate, int baseTaps, int maxTaps) noexcept {
+    if (sampleRate <= 0.0)
+        return baseTaps;
+
+    const double scaled = std::round(baseTaps * (sampleRate / 48000.0));
+    int taps = static_cast<int>(scaled);
+    taps = juce::jlimit(1023, maxTaps, taps);
+    if ((taps % 2) == 0)
+        ++taps;
+    return juce::jmin(taps, maxTaps);
+}
+
+void FirDesign::designHilbert(float* coeffs, int numTaps, double sampleRate, double normMinHz, double normMaxHz) {
+    designHilbertImpl(coeffs, numTaps, sampleRate, normMinHz, normMaxHz);
+}
+
+void FirDesign::designHilbert(double* coeffs, int numTaps, double sampleRate, double normMinHz, double normMaxHz) {
+    designHilbertImpl(coeffs, numTaps, sampleRate, normMinHz, normMaxHz);
+}
+
+int FirDesign::chooseKaiserLength(double transitionHz, double sampleRate, double stopbandDb) noexcept {
+    const double deltaOmega = juce::MathConstants<double>::twoPi * transitionHz / sampleRate;
+    int taps = static_cast<int>(std::ceil((stopbandDb - 8.0) / (2.285 * deltaOmega))) + 1;
+    if ((taps % 2) == 0)
+        ++taps;
+    return juce::jmax(3, taps);
+}
+
+void FirDesign::designKaiserLowpass(float* coeffs, int numTaps, double cutoffHz, double sampleRate,
+                                   double stopbandDb) {
+    const int half = (numTaps - 1) / 2;
+    const double fc = cutoffHz / sampleRate;
+    const double beta = kaiserBeta(stopbandDb);
+    const double i0Beta = besselI0(beta);
+
+    double sum = 0.0;
+    for (int d = 0; d < numTaps; ++d) {
+        const int n = d - half;
+        const double x = juce::MathConstants<double>::twoPi * fc * static_cast<double>(n);
+        const double sinc =
+            n == 0 ? 2.0 * fc : std::sin(x) / (juce::MathConstants<double>::pi * static_cast<double>(n));
+        const double r = half > 0 ? static_cast<double>(n) / static_cast<double>(half) : 0.0;
+        const double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / i0Beta;
+        const double c = sinc * window;
+        coeffs[d] = static_cast<float>(c);
+        sum += c;
+    }
+
+    const float scale = sum > 1.0e-12 ? static_cast<float>(1.0 / sum) : 1.0f;
+    for (int d = 0; d < numTaps; ++d)
+        coeffs[d] *= scale;
+}
+
+} // namespace qbdsp
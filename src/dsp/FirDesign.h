@@ -0,0 +1,27 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+namespace qbdsp {
+
+// Windowed FIR designs shared by the Hilbert engines. Every design is odd-length and linear-phase, so its group
+// delay is exactly (numTaps - 1) / 2 samples.
+class FirDesign final {
+  public:
+    // Odd tap count for a Blackman Hilbert kernel scaled from baseTaps at 48 kHz, limited to [1023, maxTaps].
+    static int chooseHilbertTapCount(double sampleRate, int baseTaps, int maxTaps) noexcept;
+
+    // Type III Blackman-windowed Hilbert transformer, gain-normalised in the least-squares sense over
+    // [normMinHz, normMaxHz]. Every other tap (the even offsets from the centre) is exactly zero.
+    static void designHilbert(float* coeffs, int numTaps, double sampleRate, double normMinHz, double normMaxHz);
+    static void designHilbert(double* coeffs, int numTaps, double sampleRate, double normMinHz, double normMaxHz);
+
+    // Odd length a Kaiser low-pass needs for the given transition width and stopband attenuation.
+    static int chooseKaiserLength(double transitionHz, double sampleRate, double stopbandDb) noexcept;
+
+    // Kaiser-windowed sinc low-pass with unity DC gain and its -6 dB point at cutoffHz.
+    static void designKaiserLowpass(float* coeffs, int numTaps, double cutoffHz, double sampleRate,
+                                    double stopbandDb);
+};
+
+} // namespace qbdsp
@@ -0,0 +1,290 @@
+#include "HilbertEngineSelector.h"
+#include "KernelDispatch.h"
+#include "util/Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+
+namespace qbdsp {
+
+namespace {
+
+using Mode = HilbertQuadratureProcessor::Mode;
+
+constexpr int kMainBandProbes = 400;
+
+struct DecisionCache {
+    juce::CriticalSection lock;
+    std::map<juce::String, Mode> decisions;
+    juce::File file;
+    // Serialises file writes so a slower writer never replaces a newer snapshot; never held with lock for long.
+    juce::CriticalSection fileLock;
+};
+
+DecisionCache& getCache() {
+    static DecisionCache cache;
+    return cache;
+}
+
+double percentile95(std::vector<double> values) {
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(std::floor(0.95 * static_cast<double>(values.size() - 1)))];
+}
+
+juce::String makeKey(double sampleRate, int maximumBlockSize) {
+    return juce::SystemStats::getCpuModel() + "|" + KernelDispatch::getIsaName(KernelDispatch::getActiveIsa()) + "|" +
+           juce::String(juce::roundToInt(sampleRate)) + "|" + juce::String(maximumBlockSize);
+}
+
+void loadDecisions(DecisionCache& cache, const juce::XmlElement& xml) {
+    for (const auto* entry : xml.getChildWithTagNameIterator("Decision")) {
+        const int modeIndex = entry->getIntAttribute("mode", -1);
+        const auto mode = HilbertQuadratureProcessor::modeFromIndex(modeIndex);
+        if (modeIndex == static_cast<int>(mode) && HilbertQuadratureProcessor::isLinearPhase(mode))
+            cache.decisions.emplace(entry->getStringAttribute("key"), mode);
+    }
+}
+
+void saveDecisions(DecisionCache& cache) {
+    const juce::ScopedLock fileLock(cache.fileLock);
+    juce::File file;
+    juce::XmlElement xml("QuadraBassEngineSelection");
+    {
+        const juce::ScopedLock scopedLock(cache.lock);
+        file = cache.file;
+        for (const auto& [key, mode] : cache.decisions) {
+            auto* entry = xml.createNewChildElement("Decision");
+            entry->setAttribute("key", key);
+            entry->setAttribute("mode", static_cast<int>(mode));
+        }
+    }
+
+    if (file == juce::File())
+        return;
+
+    // Best effort: a read-only location only costs re-benchmarking next session.
+    file.getParentDirectory().createDirectory();
+    xml.writeTo(file);
+}
+
+double timeCandidate(HilbertQuadratureProcessor& processor, const std::vector<float>& noise, int blockSize) {
+    juce::AudioBuffer<float> iBuffer(1, blockSize);
+    juce::AudioBuffer<float> qBuffer(1, blockSize);
+    const int total = static_cast<int>(noise.size());
+
+    double best = 0.0;
+    // The first pass only warms caches and the lazily grown histories up.
+    for (int run = 0; run <= HilbertEngineSelector::kBenchmarkRuns; ++run) {
+        processor.reset();
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int done = 0; done < total; done += blockSize) {
+            const int count = juce::jmin(blockSize, total - done);
+            iBuffer.setSize(1, count, false, false, true);
+            qBuffer.setSize(1, count, false, false, true);
+            iBuffer.copyFrom(0, 0, noise.data() + done, count);
+            processor.process(iBuffer, qBuffer, 90.0f);
+        }
+        const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        if (run == 1 || (run > 1 && seconds < best))
+            best = seconds;
+    }
+
+    return best;
+}
+
+bool findDecision(const juce::String& key, Mode& mode) {
+    auto& cache = getCache();
+    const juce::ScopedLock scopedLock(cache.lock);
+    const auto found = cache.decisions.find(key);
+    if (found == cache.decisions.end())
+        return false;
+
+    mode = found->second;
+    return true;
+}
+
+constexpr int kPendingModeIndex = -1;
+
+} // namespace
+
+struct HilbertEngineSelector::PendingMode::State {
+    std::atomic<int> modeIndex{kPendingModeIndex};
+    juce::WaitableEvent finished{true};
+
+    void finish(Mode mode) {
+        modeIndex.store(static_cast<int>(mode), std::memory_order_release);
+        finished.signal();
+    }
+};
+
+bool HilbertEngineSelector::PendingMode::isReady() const noexcept {
+    return state_ != nullptr && state_->modeIndex.load(std::memory_order_acquire) != kPendingModeIndex;
+}
+
+HilbertQuadratureProcessor::Mode HilbertEngineSelector::PendingMode::getMode() const noexcept {
+    return isReady() ? HilbertQuadratureProcessor::modeFromIndex(state_->modeIndex.load(std::memory_order_acquire))
+                     : Mode::FIR;
+}
+
+void HilbertEngineSelector::PendingMode::wait() const {
+    if (state_ != nullptr)
+        state_->finished.wait(-1);
+}
+
+HilbertEngineSelector::Worker::~Worker() = default;
+
+juce::ThreadPool& HilbertEngineSelector::Worker::getPool() {
+    const juce::ScopedLock lock(poolLock_);
+    if (pool_ == nullptr)
+        pool_ = std::make_unique<juce::ThreadPool>(1);
+
+    return *pool_;
+}
+
+HilbertQuadratureProcessor::Mode HilbertEngineSelector::select(double sampleRate, int maximumBlockSize) {
+    // A timed choice differs between machines, which would make deterministic renders differ too.
+    if (KernelDispatch::isDeterministic())
+        return Mode::FIR;
+
+    const double sampleRateSafe = sampleRate > 1.0 ? sampleRate : 48000.0;
+    const int blockSize = juce::jmax(1, maximumBlockSize);
+    const auto key = makeKey(sampleRateSafe, blockSize);
+
+    Mode mode = Mode::FIR;
+    if (findDecision(key, mode))
+        return mode;
+
+    const auto measured = chooseFastest(benchmark(sampleRateSafe, blockSize));
+    auto& cache = getCache();
+    {
+        const juce::ScopedLock scopedLock(cache.lock);
+        const auto [entry, inserted] = cache.decisions.emplace(key, measured);
+        if (!inserted)
+            return entry->second;
+    }
+
+    saveDecisions(cache);
+    return measured;
+}
+
+HilbertEngineSelector::PendingMode HilbertEngineSelector::selectInBackground(double sampleRate, int maximumBlockSize,
+                                                                             Worker& worker) {
+    PendingMode pending;
+    pending.state_ = std::make_shared<PendingMode::State>();
+
+    Mode mode = Mode::FIR;
+    if (KernelDispatch::isDeterministic() ||
+        findDecision(makeKey(sampleRate > 1.0 ? sampleRate : 48000.0, juce::jmax(1, maximumBlockSize)), mode)) {
+        pending.state_->finish(mode);
+        return pending;
+    }
+
+    // The job only shares the result, so it can finish after the engine that asked for it is gone.
+    worker.getPool().addJob([state = pending.state_, sampleRate, maximumBlockSize] {
+        state->finish(select(sampleRate, maximumBlockSize));
+    });
+    return pending;
+}
+
+std::vector<HilbertEngineSelector::Candidate> HilbertEngineSelector::benchmark(double sampleRate,
+                                                                               int maximumBlockSize) {
+    QB_TRACE_SCOPE("HilbertEngineSelector::benchmark");
+    const double sampleRateSafe = sampleRate > 1.0 ? sampleRate : 48000.0;
+    const int blockSize = juce::jmax(1, maximumBlockSize);
+
+    HilbertQuadratureProcessor processor;
+    processor.prepare({sampleRateSafe, static_cast<juce::uint32>(blockSize), 1});
+
+    std::vector<float> noise(static_cast<size_t>(kBenchmarkSamples));
+    juce::Random random(0x5142);
+    for (auto& sample : noise)
+        sample = random.nextFloat() * 2.0f - 1.0f;
+
+    std::vector<Candidate> candidates;
+    for (const auto mode : {Mode::FIR, Mode::Multirate, Mode::Spectral}) {
+        // Below 88.2 kHz Multirate runs the FIR path itself, so there is nothing separate to measure.
+        if (mode == Mode::Multirate && sampleRateSafe < 2.0 * MultirateHilbert::kMinBaseRate)
+            continue;
+
+        processor.setMode(mode);
+        Candidate candidate;
+        candidate.mode = mode;
+        candidate.latencySamples = processor.getLatencySamples();
+        candidate.meetsAccuracyTargets = meetsAccuracyTargets(processor.measureQuadratureResponse());
+        candidate.realtimeFraction =
+            timeCandidate(processor, noise, blockSize) * sampleRateSafe / static_cast<double>(kBenchmarkSamples);
+        candidates.push_back(candidate);
+    }
+
+    return candidates;
+}
+
+HilbertQuadratureProcessor::Mode
+HilbertEngineSelector::chooseFastest(const std::vector<Candidate>& candidates) noexcept {
+    const Candidate* best = nullptr;
+    for (const auto& candidate : candidates) {
+        if (candidate.meetsAccuracyTargets && (best == nullptr || candidate.realtimeFraction < best->realtimeFraction))
+            best = &candidate;
+    }
+
+    return best != nullptr ? best->mode : Mode::FIR;
+}
+
+bool HilbertEngineSelector::meetsAccuracyTargets(const HilbertQuadratureProcessor::QuadratureResponse& response) {
+    const double sampleRate = response.sampleRate;
+    std::vector<double> phaseErrors;
+    std::vector<double> magnitudeErrors;
+    for (int i = 0; i < kMainBandProbes; ++i) {
+        const double t = static_cast<double>(i) / static_cast<double>(kMainBandProbes - 1);
+        const double hz = 30.0 * std::pow(0.45 * sampleRate / 30.0, t);
+        phaseErrors.push_back(response.getQuadratureErrorDeg(hz));
+        magnitudeErrors.push_back(std::abs(response.getMagnitudeMatchDb(hz)));
+    }
+
+    double edgePhaseMax = 0.0;
+    const double edgeHz = juce::jmin(0.47 * sampleRate, 0.5 * sampleRate - 200.0);
+    for (double hz = 0.45 * sampleRate; hz <= edgeHz; hz += 0.0025 * sampleRate)
+        edgePhaseMax = juce::jmax(edgePhaseMax, response.getQuadratureErrorDeg(hz));
+    edgePhaseMax = juce::jmax(edgePhaseMax, response.getQuadratureErrorDeg(edgeHz));
+
+    return percentile95(phaseErrors) <= 3.0 && *std::max_element(phaseErrors.begin(), phaseErrors.end()) <= 8.0 &&
+           percentile95(magnitudeErrors) <= 0.5 &&
+           *std::max_element(magnitudeErrors.begin(), magnitudeErrors.end()) <= 1.5 && edgePhaseMax <= 12.0;
+}
+
+void HilbertEngineSelector::setCacheFile(const juce::File& file) {
+    // Every processor instance calls this from its constructor, so only the first one for a file touches the disk.
+    auto& cache = getCache();
+    {
+        const juce::ScopedLock scopedLock(cache.lock);
+        if (cache.file == file)
+            return;
+    }
+
+    const auto xml = file.existsAsFile() ? juce::XmlDocument::parse(file) : nullptr;
+
+    const juce::ScopedLock scopedLock(cache.lock);
+    if (cache.file == file)
+        return;
+
+    cache.file = file;
+    if (xml != nullptr)
+        loadDecisions(cache, *xml);
+}
+
+juce::File HilbertEngineSelector::getDefaultCacheFile() {
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("QuadraBass")
+        .getChildFile("EngineSelection.xml");
+}
+
+void HilbertEngineSelector::clearCache() {
+    auto& cache = getCache();
+    const juce::ScopedLock scopedLock(cache.lock);
+    cache.decisions.clear();
+}
+
+} // namespace qbdsp
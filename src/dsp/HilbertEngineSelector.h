@@ -0,0 +1,90 @@
+#pragma once
+
+#include "HilbertQuadratureProcessor.h"
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+
+namespace qbdsp {
+
+// Resolves the Auto Hilbert mode. The linear-phase backends (FIR, Multirate, Spectral) share one width law and only
+// differ in cost and latency, and which is cheapest depends on the block size, the sample rate and the CPU: direct
+// convolution wins for small blocks, the STFT for large ones, and the decimated path at high rates. select() times
+// each candidate at the prepared rate and block size, drops the ones that miss the FIR acceptance targets, and
+// returns the fastest. Decisions are cached per machine and spec, in memory and optionally in a file, so a session
+// keeps the same backend (and latency) every time it is prepared.
+class HilbertEngineSelector final {
+  public:
+    // Runs selections off the preparing thread. Shared by every engine through juce::SharedResourcePointer; it has a
+    // single thread, started by the first selection, so engines preparing together for one spec measure it once
+    // instead of skewing each other's timings.
+    class Worker final {
+      public:
+        Worker() = default;
+        ~Worker();
+
+      private:
+        friend class HilbertEngineSelector;
+        juce::ThreadPool& getPool();
+
+        juce::CriticalSection poolLock_;
+        std::unique_ptr<juce::ThreadPool> pool_;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+    };
+
+    // A decision that may still be measuring on a Worker. isReady() and getMode() are lock-free, so the audio thread
+    // can poll for the result; a default-constructed one is never ready.
+    class PendingMode final {
+      public:
+        bool isReady() const noexcept;
+        // FIR until ready.
+        HilbertQuadratureProcessor::Mode getMode() const noexcept;
+        // Blocks until the measurement has finished. Never call it on the audio thread.
+        void wait() const;
+
+      private:
+        friend class HilbertEngineSelector;
+        struct State;
+        std::shared_ptr<State> state_;
+    };
+
+    // Each candidate processes this many samples of noise per timing run; the fastest of kBenchmarkRuns counts.
+    static constexpr int kBenchmarkSamples = 1 << 15;
+    static constexpr int kBenchmarkRuns = 3;
+
+    struct Candidate {
+        HilbertQuadratureProcessor::Mode mode = HilbertQuadratureProcessor::Mode::FIR;
+        int latencySamples = 0;
+        bool meetsAccuracyTargets = false;
+        // Processing time divided by the audio duration processed.
+        double realtimeFraction = 0.0;
+    };
+
+    // Cached choice for this spec, benchmarking on first use (a few tens of milliseconds per candidate), so never
+    // call it on the audio thread. The cache lock is only held for the lookup and the insert; if two callers measure
+    // the same spec at once, the first result stored wins. Falls back to FIR if no candidate meets the targets, and
+    // always returns FIR in KernelDispatch's deterministic mode.
+    static HilbertQuadratureProcessor::Mode select(double sampleRate, int maximumBlockSize);
+    // Non-blocking select(): ready straight away when the decision is cached (or in deterministic mode), otherwise
+    // queued on worker.
+    static PendingMode selectInBackground(double sampleRate, int maximumBlockSize, Worker& worker);
+
+    // Always measures; Multirate is left out at rates where it is identical to FIR.
+    static std::vector<Candidate> benchmark(double sampleRate, int maximumBlockSize);
+    static HilbertQuadratureProcessor::Mode chooseFastest(const std::vector<Candidate>& candidates) noexcept;
+
+    // The FIR acceptance targets from README.md: main-band (30 Hz .. 0.45 Fs) phase error <= 3 deg at the 95th
+    // percentile and <= 8 deg max, magnitude match <= 0.5 dB / 1.5 dB, and edge-band phase error <= 12 deg.
+    static bool meetsAccuracyTargets(const HilbertQuadratureProcessor::QuadratureResponse& response);
+
+    // Loads earlier decisions from file and saves every new one to it. Decisions are keyed by CPU model and SIMD
+    // kernel set as well as the spec, so a file carried to another machine is re-measured there.
+    // Setting the file that is already in use does nothing.
+    static void setCacheFile(const juce::File& file);
+    static juce::File getDefaultCacheFile();
+    // Forgets the in-memory decisions (the file is left alone).
+    static void clearCache();
+};
+
+} // namespace qbdsp
@@ -1,73 +1,211 @@
 #include "HilbertQuadratureProcessor.h"
+#include "FirDesign.h"
+#include "KernelDispatch.h"
+#include "util/Trace.h"
 #include <algorithm>
 #include <cmath>
+#include <complex>
 
 namespace qbdsp {
 
+namespace {
+
+constexpr int kMinResponseFFTOrder = 14;
+constexpr int kMaxResponseFFTOrder = 20;
+constexpr int kResponseBlockSize = 4096;
+constexpr int kMaxResponseOffsets = 8;
+// The Render IIR network holds quadrature from this far above DC to the same distance below Nyquist.
+constexpr double kRenderIIRTransitionHz = 20.0;
+
+double wrapDegrees(double degrees) noexcept {
+    degrees = std::fmod(degrees, 360.0);
+    if (degrees > 180.0)
+        degrees -= 360.0;
+    else if (degrees < -180.0)
+        degrees += 360.0;
+    return degrees;
+}
+
+// Fractional bin position for hz, clamped to the measured bins.
+void locateBin(const HilbertQuadratureProcessor::QuadratureResponse& response, double hz, size_t& bin,
+               double& frac) noexcept {
+    bin = 0;
+    frac = 0.0;
+    const auto numBins = response.frequencyHz.size();
+    if (numBins < 2)
+        return;
+
+    const double binHz = response.frequencyHz[1];
+    const double position = juce::jlimit(0.0, static_cast<double>(numBins - 1), hz / binHz);
+    bin = juce::jmin(static_cast<size_t>(position), numBins - 2);
+    frac = position - static_cast<double>(bin);
+}
+
+// Coefficients for a pair of polyphase allpass chains, sections (a - z^-2) / (1 - a z^-2), whose outputs stay in
+// quadrature over [transition, 0.5 - transition] (as fractions of the sample rate). This is the elliptic halfband
+// design of Valenzuela and Constantinides, frequency-shifted by a quarter of the sample rate.
+void designPolyphaseHilbert(double* coeffs, int numCoeffs, double transition) noexcept {
+    constexpr double pi = juce::MathConstants<double>::pi;
+    double k = std::tan((1.0 - 2.0 * transition) * pi * 0.25);
+    k *= k;
+    const double kRoot = std::pow(1.0 - k * k, 0.25);
+    const double e = 0.5 * (1.0 - kRoot) / (1.0 + kRoot);
+    const double e4 = e * e * e * e;
+    const double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+    const double order = static_cast<double>(2 * numCoeffs + 1);
+
+    for (int index = 0; index < numCoeffs; ++index) {
+        const double c = static_cast<double>(index + 1);
+
+        double numerator = 0.0;
+        double sign = 1.0;
+        for (int i = 0; i < 64; ++i, sign = -sign) {
+            const double term = std::pow(q, i * (i + 1)) * std::sin((2 * i + 1) * c * pi / order) * sign;
+            numerator += term;
+            if (std::abs(term) < 1.0e-100)
+                break;
+        }
+        numerator *= std::pow(q, 0.25);
+
+        double denominator = 0.5;
+        sign = -1.0;
+        for (int i = 1; i < 64; ++i, sign = -sign) {
+            const double term = std::pow(q, i * i) * std::cos(2 * i * c * pi / order) * sign;
+            denominator += term;
+            if (std::abs(term) < 1.0e-100)
+                break;
+        }
+
+        const double ww = numerator / denominator;
+        const double wwSquared = ww * ww;
+        const double x = std::sqrt((1.0 - wwSquared * k) * (1.0 - wwSquared / k)) / (1.0 + wwSquared);
+        coeffs[index] = (1.0 - x) / (1.0 + x);
+    }
+}
+
+} // namespace
+
+double HilbertQuadratureProcessor::QuadratureResponse::getPhaseDifferenceDeg(double hz) const noexcept {
+    if (phaseDifferenceDeg.empty())
+        return 0.0;
+
+    size_t bin = 0;
+    double frac = 0.0;
+    locateBin(*this, hz, bin, frac);
+    if (bin + 1 >= phaseDifferenceDeg.size())
+        return phaseDifferenceDeg[bin];
+
+    // Interpolate along the short way round so bins either side of +/-180 do not average to zero.
+    const double step = wrapDegrees(phaseDifferenceDeg[bin + 1] - phaseDifferenceDeg[bin]);
+    return wrapDegrees(phaseDifferenceDeg[bin] + frac * step);
+}
+
+double HilbertQuadratureProcessor::QuadratureResponse::getMagnitudeMatchDb(double hz) const noexcept {
+    if (magnitudeMatchDb.empty())
+        return 0.0;
+
+    size_t bin = 0;
+    double frac = 0.0;
+    locateBin(*this, hz, bin, frac);
+    if (bin + 1 >= magnitudeMatchDb.size())
+        return magnitudeMatchDb[bin];
+
+    return magnitudeMatchDb[bin] + frac * (magnitudeMatchDb[bin + 1] - magnitudeMatchDb[bin]);
+}
+
+double HilbertQuadratureProcessor::QuadratureResponse::getQuadratureErrorDeg(double hz) const noexcept {
+    const double phase = getPhaseDifferenceDeg(hz);
+    return juce::jmin(std::abs(wrapDegrees(phase - 90.0)), std::abs(wrapDegrees(phase + 90.0)));
+}
+
 int HilbertQuadratureProcessor::chooseFIRTapCount(double sampleRate) noexcept {
-    if (sampleRate <= 0.0)
-        return kBaseFIRTaps;
+    return FirDesign::chooseHilbertTapCount(sampleRate, kBaseFIRTaps, kMaxFIRTaps);
+}
 
-    const double scaled = std::round(kBaseFIRTaps * (sampleRate / 48000.0));
-    int taps = static_cast<int>(scaled);
-    taps = juce::jlimit(1023, kMaxFIRTaps, taps);
-    if ((taps % 2) == 0)
-        ++taps;
-    return juce::jmin(taps, kMaxFIRTaps);
+HilbertQuadratureProcessor::PackedFIR HilbertQuadratureProcessor::designPackedFIR(double sampleRate, int tapCount) {
+    const double sampleRateSafe = sampleRate > 1.0 ? sampleRate : 48000.0;
+    std::vector<double> design(static_cast<size_t>(tapCount));
+    FirDesign::designHilbert(design.data(), tapCount, sampleRateSafe, kFIRDesignFloorHz, 0.45 * 0.5 * sampleRateSafe);
+
+    // The Hilbert kernel is zero on every other tap, so only the odd offsets from the centre are kept.
+    PackedFIR packed;
+    packed.tapCount = tapCount;
+    packed.firstNonZeroTap = (((tapCount - 1) / 2) % 2 == 0) ? 1 : 0;
+    packed.coeffs.reserve(static_cast<size_t>(tapCount / 2 + 1));
+    for (int d = packed.firstNonZeroTap; d < tapCount; d += 2)
+        packed.coeffs.push_back(design[static_cast<size_t>(d)]);
+
+    return packed;
 }
 
 void HilbertQuadratureProcessor::designFIR(double sampleRate) {
+    QB_TRACE_SCOPE("designFIR");
     firTapCount_ = chooseFIRTapCount(sampleRate);
-    firLatencySamples_ = (firTapCount_ - 1) / 2;
-    std::fill(firCoeffs_.begin(), firCoeffs_.end(), 0.0f);
 
-    const int half = firLatencySamples_;
-    constexpr double pi = juce::MathConstants<double>::pi;
-    constexpr double twoPi = juce::MathConstants<double>::twoPi;
-    const double denom = static_cast<double>(firTapCount_ - 1);
-
-    for (int d = 0; d < firTapCount_; ++d) {
-        const int n = d - half;
-        if (n == 0 || (n % 2) == 0)
-            continue;
+    // Designed once in double: the Render profile convolves with these taps and the realtime kernels with their
+    // float rounding.
+    auto packed = designPackedFIR(sampleRate, firTapCount_);
+    firFirstNonZeroTap_ = packed.firstNonZeroTap;
+    firNumPackedCoeffs_ = static_cast<int>(packed.coeffs.size());
+    for (int j = 0; j < firNumPackedCoeffs_; ++j)
+        firPackedCoeffs_[static_cast<size_t>(j)] = static_cast<float>(packed.coeffs[static_cast<size_t>(j)]);
+    firPackedCoeffsDouble_ = std::move(packed.coeffs);
+
+    // Packed tap j and tap (n - 1 - j) are negatives of each other, so the folded form stores their mean
+    // difference once, scaled so the largest tap uses the full 16-bit range.
+    firNumFoldedCoeffs_ = firNumPackedCoeffs_ / 2;
+    double largest = 0.0;
+    for (int j = 0; j < firNumFoldedCoeffs_; ++j)
+        largest = juce::jmax(largest, std::abs(static_cast<double>(firPackedCoeffs_[static_cast<size_t>(j)])));
+
+    firFoldedScale_ = static_cast<float>(largest / 32767.0);
+    const double toInt = largest > 0.0 ? 32767.0 / largest : 0.0;
+    for (int j = 0; j < firNumFoldedCoeffs_; ++j) {
+        const auto mirror = static_cast<size_t>(firNumPackedCoeffs_ - 1 - j);
+        const double tap = 0.5 * (static_cast<double>(firPackedCoeffs_[static_cast<size_t>(j)]) -
+                                  static_cast<double>(firPackedCoeffs_[mirror]));
+        firFoldedCoeffs_[static_cast<size_t>(j)] =
+            static_cast<std::int16_t>(juce::jlimit(-32767.0, 32767.0, std::round(tap * toInt)));
+    }
 
-        const double base = 2.0 / (pi * static_cast<double>(n));
-        const double phase = twoPi * static_cast<double>(d) / denom;
-        const double blackman = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
-        firCoeffs_[static_cast<size_t>(d)] = static_cast<float>(base * blackman);
+    // Each shorter kernel halves the taps (kept odd, so the kernel has a centre tap).
+    for (int k = 1; k < kNumFIRTiers; ++k) {
+        auto& tier = firTiers_[static_cast<size_t>(k - 1)];
+        tier.tapCount = (firTapCount_ >> k) | 1;
+        tier.latency = (tier.tapCount - 1) / 2;
+        auto tierPacked = designPackedFIR(sampleRate, tier.tapCount);
+        tier.firstNonZeroTap = tierPacked.firstNonZeroTap;
+        tier.packedCoeffs.assign(tierPacked.coeffs.begin(), tierPacked.coeffs.end());
+        tier.packedCoeffsDouble = std::move(tierPacked.coeffs);
     }
 
-    // Least-squares passband normalization (do not force DC/Nyquist).
-    const double sampleRateSafe = sampleRate > 1.0 ? sampleRate : 48000.0;
-    const double minFn = 30.0 / sampleRateSafe; // cycles/sample, avoid DC singular behavior
-    const double maxFn = 0.45 * 0.5;            // 0.45 * Nyquist (in cycles/sample)
-    constexpr int kNormBins = 512;
-
-    double sumMag = 0.0;
-    double sumMag2 = 0.0;
-    for (int k = 0; k < kNormBins; ++k) {
-        const double u = static_cast<double>(k) / static_cast<double>(kNormBins - 1);
-        const double fn = minFn + (maxFn - minFn) * u;
-        const double omega = juce::MathConstants<double>::twoPi * fn;
-
-        double real = 0.0;
-        double imag = 0.0;
-        for (int d = 0; d < firTapCount_; ++d) {
-            const double c = static_cast<double>(firCoeffs_[static_cast<size_t>(d)]);
-            const double angle = omega * static_cast<double>(d);
-            real += c * std::cos(angle);
-            imag -= c * std::sin(angle);
-        }
+    firLatencySamples_ = getFIRKernelLatency(firBaseKernel_);
+}
 
-        const double mag = std::hypot(real, imag);
-        sumMag += mag;
-        sumMag2 += mag * mag;
-    }
+int HilbertQuadratureProcessor::getFIRKernel(int tier) const noexcept {
+    if (profile_ == ProcessingProfile::Render)
+        return firBaseKernel_;
+
+    return juce::jmin(firBaseKernel_ + tier, kNumFIRTiers - 1);
+}
+
+int HilbertQuadratureProcessor::getFIRKernelLatency(int kernel) const noexcept {
+    return kernel == 0 ? (firTapCount_ - 1) / 2 : firTiers_[static_cast<size_t>(kernel - 1)].latency;
+}
+
+HilbertQuadratureProcessor::Mode HilbertQuadratureProcessor::modeFromIndex(int index) noexcept {
+    if (index == static_cast<int>(Mode::Velvet))
+        return Mode::Velvet;
 
-    const double scale = sumMag2 > 1.0e-12 ? (sumMag / sumMag2) : 1.0;
-    const float fScale = static_cast<float>(scale);
-    for (int d = 0; d < firTapCount_; ++d)
-        firCoeffs_[static_cast<size_t>(d)] *= fScale;
+    return static_cast<Mode>(juce::jlimit(static_cast<int>(Mode::IIR), static_cast<int>(Mode::Spectral), index));
+}
+
+bool HilbertQuadratureProcessor::isLinearPhase(Mode mode) noexcept {
+    return mode != Mode::IIR && mode != Mode::Velvet;
+}
+
+bool HilbertQuadratureProcessor::usesLinearWidthLaw(Mode mode) noexcept {
+    return mode != Mode::IIR;
 }
 
 void HilbertQuadratureProcessor::prepare(const juce::dsp::ProcessSpec& spec) {
@@ -85,6 +223,12 @@ void HilbertQuadratureProcessor::prepare(const juce::dsp::ProcessSpec& spec) {
     coeffsQ_[3] = -0.0537109f;
 
     designFIR(spec.sampleRate);
+    const double sampleRateSafe = spec.sampleRate > 1.0 ? spec.sampleRate : 48000.0;
+    designPolyphaseHilbert(renderIIRCoeffs_.data(), kRenderIIRCoefficients, kRenderIIRTransitionHz / sampleRateSafe);
+    firHistory_.assign(static_cast<size_t>(firTapCount_ - 1 + kFIRChunk), 0.0f);
+    multirate_.prepare(spec.sampleRate, kBaseFIRTaps, kMaxFIRTaps);
+    spectral_.prepare(spec.sampleRate);
+    velvet_.prepare(spec.sampleRate);
     reset();
 }
 
@@ -94,8 +238,17 @@ void HilbertQuadratureProcessor::reset() noexcept {
         stateQ_[i] = 0.0f;
     }
 
+    for (auto& section : renderIIRState_)
+        section.fill(0.0);
+    renderIIRPreviousInput_ = 0.0;
+
     std::fill(firHistory_.begin(), firHistory_.end(), 0.0f);
-    firWriteIndex_ = 0;
+    firHistoryPos_ = firTapCount_ - 1;
+    firPreviousTier_ = firTier_;
+    firCrossfadeDone_ = kFIRTierCrossfadeSamples;
+    multirate_.reset();
+    spectral_.reset();
+    velvet_.reset();
 }
 
 void HilbertQuadratureProcessor::setMode(Mode mode) noexcept {
@@ -106,23 +259,146 @@ void HilbertQuadratureProcessor::setMode(Mode mode) noexcept {
     reset();
 }
 
+void HilbertQuadratureProcessor::setOfflineRendering(bool shouldUseWorkers) noexcept {
+    offlineRendering_ = shouldUseWorkers;
+}
+
+bool HilbertQuadratureProcessor::isOfflineRendering() const noexcept {
+    return offlineRendering_;
+}
+
+void HilbertQuadratureProcessor::setFIRCoefficientStorage(FIRCoefficientStorage storage) noexcept {
+    firStorage_ = storage;
+}
+
+HilbertQuadratureProcessor::FIRCoefficientStorage
+HilbertQuadratureProcessor::getFIRCoefficientStorage() const noexcept {
+    return firStorage_;
+}
+
+void HilbertQuadratureProcessor::setProcessingProfile(ProcessingProfile profile) noexcept {
+    if (profile_ == profile)
+        return;
+
+    profile_ = profile;
+    for (int i = 0; i < 4; ++i) {
+        stateI_[i] = 0.0f;
+        stateQ_[i] = 0.0f;
+    }
+    for (auto& section : renderIIRState_)
+        section.fill(0.0);
+    renderIIRPreviousInput_ = 0.0;
+}
+
+ProcessingProfile HilbertQuadratureProcessor::getProcessingProfile() const noexcept {
+    return profile_;
+}
+
+void HilbertQuadratureProcessor::setFIRTier(int tier) noexcept {
+    tier = juce::jlimit(0, kNumFIRTiers - 1, tier);
+    if (tier == firTier_)
+        return;
+
+    // A change mid-crossfade starts a new one from the tier being left; the brief step is far below the error a
+    // tier change already introduces.
+    firPreviousTier_ = firTier_;
+    firTier_ = tier;
+    firCrossfadeDone_ = 0;
+}
+
+int HilbertQuadratureProcessor::getFIRTier() const noexcept {
+    return firTier_;
+}
+
+int HilbertQuadratureProcessor::getFIRTierTapCount(int tier) const noexcept {
+    const int kernel = juce::jmin(firBaseKernel_ + juce::jlimit(0, kNumFIRTiers - 1, tier), kNumFIRTiers - 1);
+    return kernel == 0 ? firTapCount_ : firTiers_[static_cast<size_t>(kernel - 1)].tapCount;
+}
+
+void HilbertQuadratureProcessor::setFIRLowestFrequency(double hz) noexcept {
+    firLowestFrequencyHz_ = juce::jmax(0.0, hz);
+
+    int kernel = 0;
+    while (kernel + 1 < kNumFIRTiers && kFIRDesignFloorHz * static_cast<double>(2 << kernel) <= firLowestFrequencyHz_)
+        ++kernel;
+
+    if (kernel == firBaseKernel_)
+        return;
+
+    firBaseKernel_ = kernel;
+    firLatencySamples_ = getFIRKernelLatency(firBaseKernel_);
+    reset();
+}
+
+double HilbertQuadratureProcessor::getFIRLowestFrequency() const noexcept {
+    return firLowestFrequencyHz_;
+}
+
+int HilbertQuadratureProcessor::getMaxLatencySamples() const noexcept {
+    return juce::jmax(getFIRKernelLatency(0), multirate_.getLatencySamples(), spectral_.getLatencySamples());
+}
+
+bool HilbertQuadratureProcessor::usesFIRTiers() const noexcept {
+    return profile_ == ProcessingProfile::Realtime &&
+           (mode_ == Mode::FIR || (mode_ == Mode::Multirate && !multirate_.isActive()));
+}
+
+void HilbertQuadratureProcessor::setQuadratureNeeded(bool needed) noexcept {
+    quadratureNeeded_ = needed;
+}
+
+bool HilbertQuadratureProcessor::isQuadratureNeeded() const noexcept {
+    return quadratureNeeded_;
+}
+
 HilbertQuadratureProcessor::Mode HilbertQuadratureProcessor::getMode() const noexcept {
     return mode_;
 }
 
 int HilbertQuadratureProcessor::getLatencySamples() const noexcept {
-    return mode_ == Mode::FIR ? firLatencySamples_ : 0;
+    if (mode_ == Mode::Multirate && multirate_.isActive())
+        return multirate_.getLatencySamples();
+    if (mode_ == Mode::Spectral)
+        return spectral_.getLatencySamples();
+
+    return isLinearPhase(mode_) ? firLatencySamples_ : 0;
 }
 
 void HilbertQuadratureProcessor::process(juce::AudioBuffer<float>& iBuffer, juce::AudioBuffer<float>& qBuffer,
                                          float phaseAngleDeg) noexcept {
     juce::ignoreUnused(phaseAngleDeg);
 
-    if (mode_ == Mode::FIR) {
+    if (mode_ == Mode::Multirate && multirate_.isActive()) {
+        multirate_.process(iBuffer.getWritePointer(0), qBuffer.getWritePointer(0), iBuffer.getNumSamples());
+        return;
+    }
+
+    if (mode_ == Mode::Spectral) {
+        spectral_.process(iBuffer.getWritePointer(0), qBuffer.getWritePointer(0), iBuffer.getNumSamples());
+        return;
+    }
+
+    if (mode_ == Mode::Velvet) {
+        const int numSamples = iBuffer.getNumSamples();
+        if (quadratureNeeded_) {
+            velvet_.process(iBuffer.getReadPointer(0), qBuffer.getWritePointer(0), numSamples);
+        } else {
+            velvet_.skip(iBuffer.getReadPointer(0), numSamples);
+            qBuffer.clear(0, 0, numSamples);
+        }
+        return;
+    }
+
+    if (isLinearPhase(mode_)) {
         processFIR(iBuffer, qBuffer);
         return;
     }
 
+    if (profile_ == ProcessingProfile::Render) {
+        processRenderIIR(iBuffer, qBuffer);
+        return;
+    }
+
     processIIR(iBuffer, qBuffer);
 }
 
@@ -155,40 +431,245 @@ void HilbertQuadratureProcessor::processIIR(juce::AudioBuffer<float>& iBuffer,
     }
 }
 
+void HilbertQuadratureProcessor::processRenderIIR(juce::AudioBuffer<float>& iBuffer,
+                                                  juce::AudioBuffer<float>& qBuffer) noexcept {
+    const int numSamples = iBuffer.getNumSamples();
+    float* iData = iBuffer.getWritePointer(0);
+    float* qData = qBuffer.getWritePointer(0);
+
+    const auto runSection = [this](int index, double x) noexcept {
+        auto& state = renderIIRState_[static_cast<size_t>(index)];
+        const double y = renderIIRCoeffs_[static_cast<size_t>(index)] * (x + state[3]) - state[1];
+        state[1] = state[0];
+        state[0] = x;
+        state[3] = state[2];
+        state[2] = y;
+        return y;
+    };
+
+    for (int s = 0; s < numSamples; ++s) {
+        const double x = static_cast<double>(iData[s]);
+
+        double q = x;
+        for (int index = 0; index < kRenderIIRCoefficients; index += 2)
+            q = runSection(index, q);
+
+        double i = renderIIRPreviousInput_;
+        renderIIRPreviousInput_ = x;
+        for (int index = 1; index < kRenderIIRCoefficients; index += 2)
+            i = runSection(index, i);
+
+        iData[s] = static_cast<float>(i);
+        qData[s] = static_cast<float>(q);
+    }
+}
+
+void HilbertQuadratureProcessor::convolveFIRRangeDouble(const double* coeffs, int numCoeffs, const float* firstTap,
+                                                        float* qOut, int numOutputs) noexcept {
+    int s = 0;
+    for (; s + 4 <= numOutputs; s += 4) {
+        double acc[4] = {};
+        const float* x = firstTap + s;
+        for (int j = 0; j < numCoeffs; ++j, x -= 2) {
+            const double c = coeffs[j];
+            for (int k = 0; k < 4; ++k)
+                acc[k] += c * static_cast<double>(x[k]);
+        }
+        for (int k = 0; k < 4; ++k)
+            qOut[s + k] = static_cast<float>(acc[k]);
+    }
+    for (; s < numOutputs; ++s) {
+        double acc = 0.0;
+        const float* x = firstTap + s;
+        for (int j = 0; j < numCoeffs; ++j, x -= 2)
+            acc += coeffs[j] * static_cast<double>(*x);
+        qOut[s] = static_cast<float>(acc);
+    }
+}
+
+void HilbertQuadratureProcessor::convolveFIRRange(int tier, const float* newest, float* qOut, int begin,
+                                                  int end) const noexcept {
+    const int kernel = getFIRKernel(tier);
+    if (kernel > 0) {
+        // Shorter kernels sit further behind the newest input by the padding up to the base kernel's delay.
+        const auto& shorter = firTiers_[static_cast<size_t>(kernel - 1)];
+        const int numCoeffs = static_cast<int>(shorter.packedCoeffs.size());
+        const float* firstTap = newest + begin - (firLatencySamples_ - shorter.latency + shorter.firstNonZeroTap);
+        if (profile_ == ProcessingProfile::Render)
+            convolveFIRRangeDouble(shorter.packedCoeffsDouble.data(), numCoeffs, firstTap, qOut + begin, end - begin);
+        else
+            KernelDispatch::get().convolveStride2(shorter.packedCoeffs.data(), numCoeffs, firstTap, qOut + begin,
+                                                  end - begin);
+        return;
+    }
+
+    const float* firstTap = newest + begin - firFirstNonZeroTap_;
+    if (profile_ == ProcessingProfile::Render) {
+        convolveFIRRangeDouble(firPackedCoeffsDouble_.data(), firNumPackedCoeffs_, firstTap, qOut + begin,
+                               end - begin);
+        return;
+    }
+
+    if (firStorage_ == FIRCoefficientStorage::Int16Folded) {
+        const float* lastTap = firstTap - 2 * (firNumPackedCoeffs_ - 1);
+        KernelDispatch::get().convolveStride2Folded(firFoldedCoeffs_.data(), firNumFoldedCoeffs_, firFoldedScale_,
+                                                    firstTap, lastTap, qOut + begin, end - begin);
+        return;
+    }
+
+    KernelDispatch::get().convolveStride2(firPackedCoeffs_.data(), firNumPackedCoeffs_, firstTap, qOut + begin,
+                                          end - begin);
+}
+
 void HilbertQuadratureProcessor::processFIR(juce::AudioBuffer<float>& iBuffer,
                                             juce::AudioBuffer<float>& qBuffer) noexcept {
     const int numSamples = iBuffer.getNumSamples();
     float* iData = iBuffer.getWritePointer(0);
     float* qData = qBuffer.getWritePointer(0);
-    const int firstNonZeroTap = ((firLatencySamples_ % 2) == 0) ? 1 : 0;
+    if (firHistory_.empty()) {
+        qBuffer.clear();
+        return;
+    }
 
-    for (int s = 0; s < numSamples; ++s) {
-        const float x = iData[s];
-        firHistory_[static_cast<size_t>(firWriteIndex_)] = x;
-
-        float q = 0.0f;
-        int tapIndex = firWriteIndex_ - firstNonZeroTap;
-        if (tapIndex < 0)
-            tapIndex += firTapCount_;
-
-        for (int d = firstNonZeroTap; d < firTapCount_; d += 2) {
-            q += firCoeffs_[static_cast<size_t>(d)] * firHistory_[static_cast<size_t>(tapIndex)];
-            tapIndex -= 2;
-            if (tapIndex < 0)
-                tapIndex += firTapCount_;
+    const int historySize = static_cast<int>(firHistory_.size());
+    const int keep = firTapCount_ - 1;
+
+    int done = 0;
+    while (done < numSamples) {
+        if (firHistoryPos_ == historySize) {
+            std::copy(firHistory_.end() - keep, firHistory_.end(), firHistory_.begin());
+            firHistoryPos_ = keep;
         }
 
-        int delayedIndex = firWriteIndex_ - firLatencySamples_;
-        if (delayedIndex < 0)
-            delayedIndex += firTapCount_;
+        const int count = juce::jmin(numSamples - done, historySize - firHistoryPos_);
+        float* newest = firHistory_.data() + firHistoryPos_;
+        std::copy(iData + done, iData + done + count, newest);
+
+        float* qOut = qData + done;
+        if (!quadratureNeeded_) {
+            juce::FloatVectorOperations::clear(qOut, count);
+        } else if (offlineRendering_ && count >= kMinParallelFIRSamples) {
+            // Each slice reads the shared history and writes a disjoint range of Q, running the same kernel as
+            // the serial path, so the result does not depend on how the block was split.
+            renderPool_->parallelFor(count, kMinParallelFIRSamples / 4, [this, newest, qOut](int begin, int end) {
+                convolveFIRRange(firTier_, newest, qOut, begin, end);
+            });
+        } else {
+            convolveFIRRange(firTier_, newest, qOut, 0, count);
+        }
+
+        if (firCrossfadeDone_ < kFIRTierCrossfadeSamples)
+            crossfadeFIRTier(newest, qOut, count);
+
+        const float* delayed = newest - firLatencySamples_;
+        std::copy(delayed, delayed + count, iData + done);
+
+        firHistoryPos_ += count;
+        done += count;
+    }
+}
+
+void HilbertQuadratureProcessor::crossfadeFIRTier(const float* newest, float* qOut, int count) noexcept {
+    const int fadeCount = juce::jmin(count, kFIRTierCrossfadeSamples - firCrossfadeDone_);
+    if (quadratureNeeded_ && getFIRKernel(firPreviousTier_) != getFIRKernel(firTier_)) {
+        float* previous = firCrossfadeBuffer_.data();
+        convolveFIRRange(firPreviousTier_, newest, previous, 0, fadeCount);
+        const float step = 1.0f / static_cast<float>(kFIRTierCrossfadeSamples);
+        for (int s = 0; s < fadeCount; ++s) {
+            const float gain = static_cast<float>(firCrossfadeDone_ + s + 1) * step;
+            qOut[s] = previous[s] + gain * (qOut[s] - previous[s]);
+        }
+    }
 
-        iData[s] = firHistory_[static_cast<size_t>(delayedIndex)];
-        qData[s] = q;
+    firCrossfadeDone_ += fadeCount;
+}
+
+HilbertQuadratureProcessor::QuadratureResponse HilbertQuadratureProcessor::measureQuadratureResponse() const {
+    return measureQuadratureResponse(mode_, spec_.sampleRate, firStorage_, profile_, firLowestFrequencyHz_);
+}
+
+HilbertQuadratureProcessor::QuadratureResponse
+HilbertQuadratureProcessor::measureQuadratureResponse(Mode mode, double sampleRate, FIRCoefficientStorage storage,
+                                                      ProcessingProfile profile, double firLowestHz) {
+    QB_TRACE_SCOPE("measureQuadratureResponse");
+    const double sampleRateSafe = sampleRate > 1.0 ? sampleRate : 48000.0;
 
-        ++firWriteIndex_;
-        if (firWriteIndex_ >= firTapCount_)
-            firWriteIndex_ = 0;
+    auto probe = std::make_unique<HilbertQuadratureProcessor>();
+    probe->prepare({sampleRateSafe, static_cast<juce::uint32>(kResponseBlockSize), 1});
+    probe->setMode(mode);
+    probe->setFIRCoefficientStorage(storage);
+    probe->setProcessingProfile(profile);
+    probe->setFIRLowestFrequency(firLowestHz);
+
+    // Both linear-phase kernels span twice the latency; the extra half second lets the IIR all-passes ring out.
+    const int latency = probe->getLatencySamples();
+    const int wanted = 2 * latency + static_cast<int>(std::ceil(0.5 * sampleRateSafe));
+    int order = kMinResponseFFTOrder;
+    while ((1 << order) < wanted && order < kMaxResponseFFTOrder)
+        ++order;
+    const int fftSize = 1 << order;
+
+    // Block-based modes are periodically time-varying (STFT hop, decimation phase), so a single impulse only sees
+    // one alignment. Averaging the re-aligned responses to impulses spread over one period gives the response a
+    // steady signal sees.
+    int period = 1;
+    if (mode == Mode::Spectral)
+        period = probe->spectral_.getFFTSize() / SpectralHilbert::kOverlap;
+    else if (mode == Mode::Multirate && probe->multirate_.isActive())
+        period = probe->multirate_.getDecimationFactor();
+    const int numOffsets = juce::jmin(period, kMaxResponseOffsets);
+
+    // I and Q are both real, so they share one complex FFT as the real and imaginary parts.
+    std::vector<std::complex<float>> packed(static_cast<size_t>(fftSize));
+    juce::AudioBuffer<float> iBuffer(1, kResponseBlockSize);
+    juce::AudioBuffer<float> qBuffer(1, kResponseBlockSize);
+    const float weight = 1.0f / static_cast<float>(numOffsets);
+    for (int k = 0; k < numOffsets; ++k) {
+        const int offset = k * period / numOffsets;
+        probe->reset();
+
+        for (int start = 0; start < fftSize + offset; start += kResponseBlockSize) {
+            const int count = juce::jmin(kResponseBlockSize, fftSize + offset - start);
+            iBuffer.setSize(1, count, false, false, true);
+            qBuffer.setSize(1, count, false, false, true);
+            iBuffer.clear();
+            if (offset >= start && offset < start + count)
+                iBuffer.setSample(0, offset - start, 1.0f);
+
+            probe->process(iBuffer, qBuffer, 90.0f);
+            for (int i = juce::jmax(0, offset - start); i < count; ++i)
+                packed[static_cast<size_t>(start + i - offset)] +=
+                    weight * std::complex<float>(iBuffer.getSample(0, i), qBuffer.getSample(0, i));
+        }
+    }
+
+    std::vector<std::complex<float>> spectrum(static_cast<size_t>(fftSize));
+    juce::dsp::FFT fft(order);
+    fft.perform(packed.data(), spectrum.data(), false);
+
+    QuadratureResponse response;
+    response.sampleRate = sampleRateSafe;
+    const int numBins = fftSize / 2 + 1;
+    response.frequencyHz.resize(static_cast<size_t>(numBins));
+    response.phaseDifferenceDeg.resize(static_cast<size_t>(numBins));
+    response.magnitudeMatchDb.resize(static_cast<size_t>(numBins));
+
+    constexpr double kRadToDeg = 180.0 / juce::MathConstants<double>::pi;
+    constexpr double kFloor = 1.0e-12;
+    for (int k = 0; k < numBins; ++k) {
+        const auto z = std::complex<double>(spectrum[static_cast<size_t>(k)]);
+        const auto zMirror = std::conj(std::complex<double>(spectrum[static_cast<size_t>((fftSize - k) % fftSize)]));
+        const auto iSpectrum = 0.5 * (z + zMirror);
+        const auto qSpectrum = std::complex<double>(0.0, -0.5) * (z - zMirror);
+
+        const auto index = static_cast<size_t>(k);
+        response.frequencyHz[index] = static_cast<double>(k) * sampleRateSafe / static_cast<double>(fftSize);
+        response.phaseDifferenceDeg[index] = wrapDegrees((std::arg(qSpectrum) - std::arg(iSpectrum)) * kRadToDeg);
+        response.magnitudeMatchDb[index] =
+            20.0 * std::log10(juce::jmax(std::abs(qSpectrum), kFloor) / juce::jmax(std::abs(iSpectrum), kFloor));
     }
+
+    return response;
 }
 
 } // namespace qbdsp
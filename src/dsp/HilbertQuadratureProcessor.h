@@ -1,15 +1,89 @@
 #pragma once
 
+#include "EngineParams.h"
+#include "MultirateHilbert.h"
+#include "OfflineRenderPool.h"
+#include "SpectralHilbert.h"
+#include "VelvetDecorrelator.h"
 #include <array>
+#include <cstdint>
 #include <juce_dsp/juce_dsp.h>
+#include <memory>
+#include <vector>
+
+// Build-time default for HilbertQuadratureProcessor::FIRCoefficientStorage (configure with
+// -DQUADRABASS_COMPACT_FIR_COEFFS=ON to make the plugin start with Int16Folded).
+#ifndef QUADRABASS_COMPACT_FIR_COEFFS
+#define QUADRABASS_COMPACT_FIR_COEFFS 0
+#endif
 
 namespace qbdsp {
 
 class HilbertQuadratureProcessor final {
   public:
-    enum class Mode : int { IIR = 0, FIR = 1 };
+    // Values are hilbert_mode parameter indices; 4 is the engine's Auto choice (EngineParams::kAutoHilbertModeIndex).
+    // Velvet is not a quadrature filter: Q is a sparse velvet-noise decorrelation of I (see VelvetDecorrelator), for
+    // cheap widening where phase accuracy does not matter.
+    enum class Mode : int { IIR = 0, FIR = 1, Multirate = 2, Spectral = 3, Velvet = 5 };
+    // How the FIR-mode kernel is held for convolution. Int16Folded keeps only the first half of the non-zero taps
+    // (the kernel is antisymmetric) as scaled 16-bit integers, a quarter of the Float32 coefficient bytes, at the
+    // accuracy cost documented in README.md.
+    enum class FIRCoefficientStorage : int { Float32 = 0, Int16Folded = 1 };
+    static constexpr FIRCoefficientStorage kDefaultFIRCoefficientStorage =
+        QUADRABASS_COMPACT_FIR_COEFFS ? FIRCoefficientStorage::Int16Folded : FIRCoefficientStorage::Float32;
     static constexpr int kBaseFIRTaps = 8191;
+    // Lowest frequency every FIR kernel is designed to hold quadrature from. Each halving of the taps roughly
+    // doubles the frequency it is actually accurate from.
+    static constexpr double kFIRDesignFloorHz = 30.0;
     static constexpr int kMaxFIRTaps = 16383;
+    // Samples appended to the linear FIR history between compactions.
+    static constexpr int kFIRChunk = 16384;
+    // Offline FIR blocks at least this long are split across the shared render pool.
+    static constexpr int kMinParallelFIRSamples = 2048;
+    // Allpass coefficients in the Render-profile IIR network (half per branch, each a section in z^-2).
+    static constexpr int kRenderIIRCoefficients = 16;
+    // FIR quality tiers for load-adaptive processing: tier t convolves a kernel of about 1 / 2^t of the base kernel's
+    // taps, centred on the base kernel's delay so latency never changes. Tier 0 is the base (normally full) kernel.
+    static constexpr int kNumFIRTiers = 3;
+    // Tier changes crossfade linearly from the old kernel's output to the new one's over this many samples.
+    static constexpr int kFIRTierCrossfadeSamples = 256;
+
+    // I/Q transfer relationship per FFT bin, from 0 Hz up to Nyquist.
+    struct QuadratureResponse {
+        double sampleRate = 0.0;
+        std::vector<double> frequencyHz;
+        // arg(Q) - arg(I) wrapped to [-180, 180]; +/-90 is ideal quadrature.
+        std::vector<double> phaseDifferenceDeg;
+        // 20 log10(|Q| / |I|); 0 dB is ideal.
+        std::vector<double> magnitudeMatchDb;
+
+        // Linearly interpolated between bins; frequencies are clamped to the measured range.
+        double getPhaseDifferenceDeg(double hz) const noexcept;
+        double getMagnitudeMatchDb(double hz) const noexcept;
+        // Distance from the nearest of +/-90 degrees.
+        double getQuadratureErrorDeg(double hz) const noexcept;
+    };
+
+    // A Hilbert kernel with only its non-zero taps (the odd offsets from the centre) kept, designed in double.
+    struct PackedFIR {
+        int tapCount = 0;
+        // Offset of coeffs[0] in the full kernel; the kept taps follow every second offset from there.
+        int firstNonZeroTap = 0;
+        std::vector<double> coeffs;
+    };
+
+    // Tap count of the full FIR-mode kernel at sampleRate.
+    static int chooseFIRTapCount(double sampleRate) noexcept;
+    // Designs the FIR mode's kernel with tapCount taps (odd) at sampleRate. BatchQuadraBassEngine uses it too, so both
+    // engines convolve identical taps.
+    static PackedFIR designPackedFIR(double sampleRate, int tapCount);
+
+    // Maps a hilbert_mode parameter index to a mode, clamping unknown values.
+    static Mode modeFromIndex(int index) noexcept;
+    // True for the modes with a linear-phase (latency-compensated) quadrature path.
+    static bool isLinearPhase(Mode mode) noexcept;
+    // True for the modes whose I output is the (delayed) input, so the stereo matrix uses its linear width law.
+    static bool usesLinearWidthLaw(Mode mode) noexcept;
 
     void prepare(const juce::dsp::ProcessSpec& spec);
     void reset() noexcept;
@@ -18,11 +92,70 @@ class HilbertQuadratureProcessor final {
     int getLatencySamples() const noexcept;
     void process(juce::AudioBuffer<float>& iBuffer, juce::AudioBuffer<float>& qBuffer, float phaseAngleDeg) noexcept;
 
+    // While enabled, large FIR blocks are convolved on several cores. Output is bit-identical either way; only
+    // enable this for non-realtime rendering since the audio thread blocks on the workers. Only flips a flag, so
+    // it is safe to call every block.
+    void setOfflineRendering(bool shouldUseWorkers) noexcept;
+    bool isOfflineRendering() const noexcept;
+
+    // Both forms are designed together, so switching is allocation-free and keeps the filter history.
+    void setFIRCoefficientStorage(FIRCoefficientStorage storage) noexcept;
+    FIRCoefficientStorage getFIRCoefficientStorage() const noexcept;
+
+    // Render convolves FIR mode in double precision (ignoring the coefficient storage) and swaps IIR mode to a
+    // 16-coefficient polyphase network designed for the prepared rate. Latency is the same in both profiles.
+    // Switching is allocation-free; the IIR network being switched to starts from silence.
+    void setProcessingProfile(ProcessingProfile profile) noexcept;
+    ProcessingProfile getProcessingProfile() const noexcept;
+
+    // Runs the realtime FIR path (FIR mode, and Multirate below 88.2 kHz) on a cheaper kernel with the same latency.
+    // Shorter kernels lose accuracy at the bottom of the band first: README.md lists each tier's lowest accurate
+    // frequency. Allocation-free; the change crossfades over kFIRTierCrossfadeSamples. Render always convolves the
+    // base kernel (see setFIRLowestFrequency()), and the other modes ignore the tier.
+    void setFIRTier(int tier) noexcept;
+    int getFIRTier() const noexcept;
+    // Taps of the kernel the tier currently runs; tiers past the shortest kernel share it.
+    int getFIRTierTapCount(int tier) const noexcept;
+
+    // Declares that nothing below hz reaches the FIR path (a crossover removes it), so the FIR path can use the
+    // shortest tier kernel still accurate from there as its base kernel, cutting both cost and latency. Tiers then
+    // count down from that kernel. 0 restores the full kernel. A change of base kernel changes the latency and
+    // clears the filter state, like setMode(). Int16Folded storage only applies to the full kernel; Multirate above
+    // 88.2 kHz, Spectral and IIR ignore this.
+    void setFIRLowestFrequency(double hz) noexcept;
+    double getFIRLowestFrequency() const noexcept;
+    // The longest latency any mode or base kernel has at the prepared rate.
+    int getMaxLatencySamples() const noexcept;
+    // True when the active mode runs the tiered FIR path, i.e. when setFIRTier() has an effect.
+    bool usesFIRTiers() const noexcept;
+
+    // When Q is not needed (the stereo matrix gives it zero gain), FIR and Velvet modes skip their convolution and
+    // write silence to Q. The input history keeps filling, so Q is exact again from the first block it is needed.
+    // The other modes derive Q from shared or recursive state and always compute it.
+    void setQuadratureNeeded(bool needed) noexcept;
+    bool isQuadratureNeeded() const noexcept;
+
+    // Runs an impulse through a freshly prepared processor with the same configuration and reads the I/Q response
+    // off a single complex FFT, so the live filter state is left untouched. Allocates; never call it on the audio
+    // thread.
+    QuadratureResponse measureQuadratureResponse() const;
+    static QuadratureResponse
+    measureQuadratureResponse(Mode mode, double sampleRate,
+                              FIRCoefficientStorage storage = kDefaultFIRCoefficientStorage,
+                              ProcessingProfile profile = ProcessingProfile::Realtime, double firLowestHz = 0.0);
+
   private:
     void processIIR(juce::AudioBuffer<float>& iBuffer, juce::AudioBuffer<float>& qBuffer) noexcept;
+    void processRenderIIR(juce::AudioBuffer<float>& iBuffer, juce::AudioBuffer<float>& qBuffer) noexcept;
     void processFIR(juce::AudioBuffer<float>& iBuffer, juce::AudioBuffer<float>& qBuffer) noexcept;
+    // Kernel index (0 full, k firTiers_[k - 1]) that a tier convolves with in the current profile.
+    int getFIRKernel(int tier) const noexcept;
+    int getFIRKernelLatency(int kernel) const noexcept;
+    void convolveFIRRange(int tier, const float* newest, float* qOut, int begin, int end) const noexcept;
+    void crossfadeFIRTier(const float* newest, float* qOut, int count) noexcept;
+    static void convolveFIRRangeDouble(const double* coeffs, int numCoeffs, const float* firstTap, float* qOut,
+                                       int numOutputs) noexcept;
     void designFIR(double sampleRate);
-    static int chooseFIRTapCount(double sampleRate) noexcept;
 
     juce::dsp::ProcessSpec spec_{};
     Mode mode_ = Mode::IIR;
@@ -34,11 +167,60 @@ class HilbertQuadratureProcessor final {
     float stateI_[4] = {0};
     float stateQ_[4] = {0};
 
-    std::array<float, kMaxFIRTaps> firCoeffs_{};
-    std::array<float, kMaxFIRTaps> firHistory_{};
+    ProcessingProfile profile_ = ProcessingProfile::Realtime;
+
+    // Render-profile IIR: Q runs the even coefficients on x[n], I the odd ones on x[n - 1]. Each section keeps
+    // {x[n-1], x[n-2], y[n-1], y[n-2]}.
+    std::array<double, kRenderIIRCoefficients> renderIIRCoeffs_{};
+    std::array<std::array<double, 4>, kRenderIIRCoefficients> renderIIRState_{};
+    double renderIIRPreviousInput_ = 0.0;
+
+    // The non-zero (odd-offset) taps only, in order, for the stride-2 convolution kernel.
+    std::array<float, (kMaxFIRTaps + 1) / 2> firPackedCoeffs_{};
+    // The same taps before rounding to float, for the Render profile.
+    std::vector<double> firPackedCoeffsDouble_;
+    int firNumPackedCoeffs_ = 0;
+    // First half of the packed taps, quantised as firFoldedScale_ * value; the second half is their negation.
+    std::array<std::int16_t, (kMaxFIRTaps + 1) / 4> firFoldedCoeffs_{};
+    int firNumFoldedCoeffs_ = 0;
+    float firFoldedScale_ = 0.0f;
+    FIRCoefficientStorage firStorage_ = kDefaultFIRCoefficientStorage;
+    bool quadratureNeeded_ = true;
+    int firFirstNonZeroTap_ = 0;
     int firTapCount_ = kBaseFIRTaps;
     int firLatencySamples_ = (kBaseFIRTaps - 1) / 2;
-    int firWriteIndex_ = 0;
+
+    // Shorter kernels 1 .. kNumFIRTiers - 1, packed like firPackedCoeffs_ (and firPackedCoeffsDouble_). Below the
+    // base kernel's latency they are padded to it, so switching between them never moves the output.
+    struct FIRTier {
+        std::vector<float> packedCoeffs;
+        std::vector<double> packedCoeffsDouble;
+        int tapCount = 0;
+        int latency = 0;
+        int firstNonZeroTap = 0;
+    };
+    std::array<FIRTier, kNumFIRTiers - 1> firTiers_;
+    int firBaseKernel_ = 0;
+    double firLowestFrequencyHz_ = 0.0;
+    int firTier_ = 0;
+    int firPreviousTier_ = 0;
+    int firCrossfadeDone_ = kFIRTierCrossfadeSamples;
+    std::array<float, kFIRTierCrossfadeSamples> firCrossfadeBuffer_{};
+
+    // Input history kept contiguous so any output sample can be convolved independently: the last
+    // firTapCount_ - 1 inputs followed by up to kFIRChunk new ones, compacted back to the front when full.
+    std::vector<float> firHistory_;
+    int firHistoryPos_ = 0;
+
+    // Held for the processor's lifetime so toggling offline rendering never constructs or tears down the shared
+    // pool on the audio thread; the pool's workers are only started by the first parallel block.
+    juce::SharedResourcePointer<OfflineRenderPool> renderPool_;
+    bool offlineRendering_ = false;
+
+    // Used by Mode::Multirate above 88.2 kHz; below that the mode falls back to the plain FIR path.
+    MultirateHilbert multirate_;
+    SpectralHilbert spectral_;
+    VelvetDecorrelator velvet_;
 };
 
 } // namespace qbdsp
@@ -0,0 +1,128 @@
+#include "KernelDispatch.h"
+#include <atomic>
+
+namespace qbdsp {
+
+namespace {
+
+constexpr KernelDispatch::Isa kAllIsas[] = {KernelDispatch::Isa::Scalar, KernelDispatch::Isa::SSE2,
+                                            KernelDispatch::Isa::AVX2, KernelDispatch::Isa::AVX512,
+                                            KernelDispatch::Isa::NEON};
+
+struct ActiveKernels {
+    ActiveKernels() {
+        auto isa = KernelDispatch::detectBestIsa();
+
+        const auto requested = juce::SystemStats::getEnvironmentVariable(KernelDispatch::kOverrideEnvVar, {});
+        KernelDispatch::Isa pinned = KernelDispatch::Isa::Scalar;
+        if (requested.isNotEmpty() && KernelDispatch::parseIsaName(requested, pinned) &&
+            KernelDispatch::isSupported(pinned))
+            isa = pinned;
+
+        const auto flag = juce::SystemStats::getEnvironmentVariable(KernelDispatch::kDeterministicEnvVar, {}).trim();
+        const bool deterministic = QUADRABASS_DETERMINISTIC != 0 || (flag.isNotEmpty() && flag != "0");
+
+        store(isa, deterministic);
+    }
+
+    void store(KernelDispatch::Isa isa, bool deterministic) noexcept {
+        table.store(KernelDispatch::getTable(isa, deterministic), std::memory_order_release);
+        activeIsa.store(static_cast<int>(isa), std::memory_order_release);
+        isDeterministic.store(deterministic, std::memory_order_release);
+    }
+
+    std::atomic<const simd::KernelTable*> table{nullptr};
+    std::atomic<int> activeIsa{0};
+    std::atomic<bool> isDeterministic{false};
+};
+
+ActiveKernels& activeKernels() noexcept {
+    static ActiveKernels active;
+    return active;
+}
+
+} // namespace
+
+const simd::KernelTable& KernelDispatch::get() noexcept {
+    return *activeKernels().table.load(std::memory_order_acquire);
+}
+
+KernelDispatch::Isa KernelDispatch::getActiveIsa() noexcept {
+    return static_cast<Isa>(activeKernels().activeIsa.load(std::memory_order_acquire));
+}
+
+bool KernelDispatch::setIsa(Isa isa) noexcept {
+    if (!isSupported(isa))
+        return false;
+
+    activeKernels().store(isa, isDeterministic());
+    return true;
+}
+
+void KernelDispatch::setDeterministic(bool shouldBeDeterministic) noexcept {
+    activeKernels().store(getActiveIsa(), shouldBeDeterministic);
+}
+
+bool KernelDispatch::isDeterministic() noexcept {
+    return activeKernels().isDeterministic.load(std::memory_order_acquire);
+}
+
+const simd::KernelTable* KernelDispatch::getTable(Isa isa, bool deterministic) noexcept {
+    switch (isa) {
+    case Isa::Scalar:
+        return &simd::getScalarKernels(deterministic);
+    case Isa::SSE2:
+        return juce::SystemStats::hasSSE2() ? simd::getSSE2Kernels(deterministic) : nullptr;
+    case Isa::AVX2:
+        return juce::SystemStats::hasAVX2() ? simd::getAVX2Kernels(deterministic) : nullptr;
+    case Isa::AVX512:
+        return juce::SystemStats::hasAVX512F() ? simd::getAVX512Kernels(deterministic) : nullptr;
+    case Isa::NEON:
+        return juce::SystemStats::hasNeon() ? simd::getNEONKernels(deterministic) : nullptr;
+    }
+
+    return nullptr;
+}
+
+bool KernelDispatch::isSupported(Isa isa) noexcept {
+    return getTable(isa) != nullptr;
+}
+
+KernelDispatch::Isa KernelDispatch::detectBestIsa() noexcept {
+    for (const auto isa : {Isa::AVX512, Isa::AVX2, Isa::NEON, Isa::SSE2})
+        if (isSupported(isa))
+            return isa;
+
+    return Isa::Scalar;
+}
+
+const char* KernelDispatch::getIsaName(Isa isa) noexcept {
+    switch (isa) {
+    case Isa::Scalar:
+        return "scalar";
+    case Isa::SSE2:
+        return "sse2";
+    case Isa::AVX2:
+        return "avx2";
+    case Isa::AVX512:
+        return "avx512";
+    case Isa::NEON:
+        return "neon";
+    }
+
+    return "scalar";
+}
+
+bool KernelDispatch::parseIsaName(const juce::String& name, Isa& isa) noexcept {
+    const auto wanted = name.trim().toLowerCase();
+    for (const auto candidate : kAllIsas) {
+        if (wanted == getIsaName(candidate)) {
+            isa = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace qbdsp
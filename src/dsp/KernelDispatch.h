@@ -0,0 +1,48 @@
+#pragma once
+
+#include "simd/KernelTable.h"
+#include <juce_dsp/juce_dsp.h>
+
+// Build with -DQUADRABASS_DETERMINISTIC=ON to start in deterministic mode (see KernelDispatch::setDeterministic).
+#ifndef QUADRABASS_DETERMINISTIC
+#define QUADRABASS_DETERMINISTIC 0
+#endif
+
+namespace qbdsp {
+
+// Picks the fastest kernel table this CPU supports, once, the first time any kernel is requested.
+//
+// Setting QUADRABASS_SIMD=scalar|sse2|avx2|avx512|neon in the environment pins a specific table (falling back to
+// auto-detection if it is unavailable), and setIsa() does the same from code for tests and benchmarks.
+//
+// Deterministic mode swaps in tables whose reductions sum in a fixed lane order (see simd::KernelTable), so output
+// on one machine is bit-identical whichever table runs. The other kernels already are. Filter designs still use the
+// maths library, so other machines may differ. Setting QUADRABASS_DETERMINISTIC=1 in the environment turns it on,
+// as does setDeterministic() from code.
+class KernelDispatch final {
+  public:
+    enum class Isa : int { Scalar = 0, SSE2, AVX2, AVX512, NEON };
+    static constexpr const char* kOverrideEnvVar = "QUADRABASS_SIMD";
+    static constexpr const char* kDeterministicEnvVar = "QUADRABASS_DETERMINISTIC";
+
+    static const simd::KernelTable& get() noexcept;
+    static Isa getActiveIsa() noexcept;
+
+    // Switches every caller to the given table; returns false (and changes nothing) if it is unsupported.
+    static bool setIsa(Isa isa) noexcept;
+
+    // Switches every caller between the fast and the fixed-order variant of the active table. Takes effect for
+    // kernels called afterwards, so flip it before preparing or rendering, not mid-render.
+    static void setDeterministic(bool shouldBeDeterministic) noexcept;
+    static bool isDeterministic() noexcept;
+
+    // True when the table was compiled into this binary and the CPU can run it.
+    static bool isSupported(Isa isa) noexcept;
+    static const simd::KernelTable* getTable(Isa isa, bool deterministic = false) noexcept;
+    static Isa detectBestIsa() noexcept;
+
+    static const char* getIsaName(Isa isa) noexcept;
+    static bool parseIsaName(const juce::String& name, Isa& isa) noexcept;
+};
+
+} // namespace qbdsp
@@ -0,0 +1,167 @@
+#include "LoudnessAnalyzer.h"
+#include <cmath>
+#include <limits>
+
+namespace qbdsp {
+
+namespace {
+
+// BS.1770-4 K-weighting, re-derived for any sample rate from its analogue prototypes (the published 48 kHz
+// coefficients come out exactly).
+constexpr double kShelfHz = 1681.974450955533;
+constexpr double kShelfGainDb = 3.999843853973347;
+constexpr double kShelfQ = 0.7071752369554196;
+constexpr double kHighpassHz = 38.13547087602444;
+constexpr double kHighpassQ = 0.5003270373238773;
+
+constexpr float kSilence = -std::numeric_limits<float>::infinity();
+
+double energyToLufs(double energy) noexcept {
+    return energy > 0.0 ? -0.691 + 10.0 * std::log10(energy) : -std::numeric_limits<double>::infinity();
+}
+
+} // namespace
+
+void LoudnessAnalyzer::prepare(double sampleRate) {
+    const double sampleRateSafe = sampleRate > 1.0 ? sampleRate : 48000.0;
+    const double pi = juce::MathConstants<double>::pi;
+
+    {
+        const double k = std::tan(pi * kShelfHz / sampleRateSafe);
+        const double vh = std::pow(10.0, kShelfGainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / kShelfQ + k * k;
+        shelf_.b0 = (vh + vb * k / kShelfQ + k * k) / a0;
+        shelf_.b1 = 2.0 * (k * k - vh) / a0;
+        shelf_.b2 = (vh - vb * k / kShelfQ + k * k) / a0;
+        shelf_.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf_.a2 = (1.0 - k / kShelfQ + k * k) / a0;
+    }
+
+    {
+        const double k = std::tan(pi * kHighpassHz / sampleRateSafe);
+        const double a0 = 1.0 + k / kHighpassQ + k * k;
+        highpass_.b0 = 1.0;
+        highpass_.b1 = -2.0;
+        highpass_.b2 = 1.0;
+        highpass_.a1 = 2.0 * (k * k - 1.0) / a0;
+        highpass_.a2 = (1.0 - k / kHighpassQ + k * k) / a0;
+    }
+
+    subBlockSamples_ = juce::jmax(1, juce::roundToInt(0.1 * sampleRateSafe));
+    histogramEnergy_.assign(static_cast<size_t>(kHistogramBins), 0.0);
+    histogramCount_.assign(static_cast<size_t>(kHistogramBins), 0);
+    reset();
+}
+
+void LoudnessAnalyzer::reset() noexcept {
+    for (auto& channel : state_)
+        channel.fill(0.0);
+    subBlockFill_ = 0;
+    subBlockEnergy_ = 0.0;
+    subBlocks_.fill(0.0);
+    subBlockIndex_ = 0;
+    numSubBlocks_ = 0;
+    std::fill(histogramEnergy_.begin(), histogramEnergy_.end(), 0.0);
+    std::fill(histogramCount_.begin(), histogramCount_.end(), 0);
+    momentaryLufs_ = kSilence;
+    shortTermLufs_ = kSilence;
+    integratedLufs_ = kSilence;
+}
+
+void LoudnessAnalyzer::processBlock(const float* left, const float* right, int numSamples) noexcept {
+    if (histogramCount_.empty())
+        return;
+
+    const float* inputs[2] = {left, right};
+    for (int i = 0; i < numSamples; ++i) {
+        for (size_t ch = 0; ch < state_.size(); ++ch) {
+            auto& z = state_[ch];
+            const double x = static_cast<double>(inputs[ch][i]);
+            const double shelved = shelf_.b0 * x + z[0];
+            z[0] = shelf_.b1 * x - shelf_.a1 * shelved + z[1];
+            z[1] = shelf_.b2 * x - shelf_.a2 * shelved;
+            const double weighted = highpass_.b0 * shelved + z[2];
+            z[2] = highpass_.b1 * shelved - highpass_.a1 * weighted + z[3];
+            z[3] = highpass_.b2 * shelved - highpass_.a2 * weighted;
+            subBlockEnergy_ += weighted * weighted;
+        }
+
+        if (++subBlockFill_ == subBlockSamples_)
+            finishSubBlock();
+    }
+}
+
+void LoudnessAnalyzer::finishSubBlock() noexcept {
+    subBlocks_[static_cast<size_t>(subBlockIndex_)] = subBlockEnergy_ / static_cast<double>(subBlockSamples_);
+    subBlockIndex_ = (subBlockIndex_ + 1) % kShortTermSubBlocks;
+    numSubBlocks_ = juce::jmin(numSubBlocks_ + 1, kShortTermSubBlocks);
+    subBlockFill_ = 0;
+    subBlockEnergy_ = 0.0;
+
+    // Windows are averaged over their full length from the start, as if preceded by silence.
+    double momentary = 0.0;
+    double shortTerm = 0.0;
+    for (int k = 1; k <= kShortTermSubBlocks; ++k) {
+        const double energy = subBlocks_[static_cast<size_t>((subBlockIndex_ - k + kShortTermSubBlocks) %
+                                                             kShortTermSubBlocks)];
+        shortTerm += energy;
+        if (k <= kMomentarySubBlocks)
+            momentary += energy;
+    }
+    momentary /= kMomentarySubBlocks;
+    shortTerm /= kShortTermSubBlocks;
+    momentaryLufs_ = static_cast<float>(energyToLufs(momentary));
+    shortTermLufs_ = static_cast<float>(energyToLufs(shortTerm));
+
+    // Gating blocks are 400 ms long with 75% overlap, so one ends on every sub-block once four have arrived.
+    if (numSubBlocks_ < kMomentarySubBlocks)
+        return;
+
+    const double blockLufs = energyToLufs(momentary);
+    if (!(blockLufs > kAbsoluteGateLufs))
+        return;
+
+    const int bin = juce::jmin(kHistogramBins - 1,
+                               static_cast<int>((blockLufs - kAbsoluteGateLufs) * kHistogramBinsPerLu));
+    histogramEnergy_[static_cast<size_t>(bin)] += momentary;
+    ++histogramCount_[static_cast<size_t>(bin)];
+    updateIntegrated();
+}
+
+void LoudnessAnalyzer::updateIntegrated() noexcept {
+    double energy = 0.0;
+    double count = 0.0;
+    for (int bin = 0; bin < kHistogramBins; ++bin) {
+        energy += histogramEnergy_[static_cast<size_t>(bin)];
+        count += histogramCount_[static_cast<size_t>(bin)];
+    }
+    if (count <= 0.0)
+        return;
+
+    // Bins whose centre clears the relative gate count in full.
+    const double relativeGate = energyToLufs(energy / count) + kRelativeGateLu;
+    const double firstBin = (relativeGate - kAbsoluteGateLufs) * kHistogramBinsPerLu - 0.5;
+    double gatedEnergy = 0.0;
+    double gatedCount = 0.0;
+    for (int bin = juce::jmax(0, static_cast<int>(std::ceil(firstBin))); bin < kHistogramBins; ++bin) {
+        gatedEnergy += histogramEnergy_[static_cast<size_t>(bin)];
+        gatedCount += histogramCount_[static_cast<size_t>(bin)];
+    }
+
+    integratedLufs_ = gatedCount > 0.0 ? static_cast<float>(energyToLufs(gatedEnergy / gatedCount)) : kSilence;
+}
+
+float LoudnessAnalyzer::getMomentaryLufs() const noexcept {
+    return momentaryLufs_;
+}
+
+float LoudnessAnalyzer::getShortTermLufs() const noexcept {
+    return shortTermLufs_;
+}
+
+float LoudnessAnalyzer::getIntegratedLufs() const noexcept {
+    return integratedLufs_;
+}
+
+} // namespace qbdsp
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <juce_dsp/juce_dsp.h>
+#include <limits>
+#include <vector>
+
+namespace qbdsp {
+
+// EBU R128 loudness of a stereo signal (ITU-R BS.1770-4 K-weighting, both channels weighted 1.0). Energy is
+// collected in 100 ms sub-blocks: momentary loudness covers the last 4 of them (400 ms), short-term the last 30
+// (3 s). Integrated loudness gates the overlapping 400 ms blocks at -70 LUFS and then 10 LU below their mean. The
+// gated blocks are binned into a 0.1 LU histogram, so memory stays constant however long it runs, at the cost of
+// resolving the relative gate to 0.1 LU. Not thread-safe; owned by the analysis worker.
+class LoudnessAnalyzer final {
+  public:
+    static constexpr double kAbsoluteGateLufs = -70.0;
+    static constexpr double kRelativeGateLu = -10.0;
+    static constexpr int kMomentarySubBlocks = 4;
+    static constexpr int kShortTermSubBlocks = 30;
+    static constexpr int kHistogramBinsPerLu = 10;
+    // Gated blocks from -70 up to +30 LUFS; louder blocks land in the top bin.
+    static constexpr int kHistogramBins = 100 * kHistogramBinsPerLu;
+
+    void prepare(double sampleRate);
+    void reset() noexcept;
+    void processBlock(const float* left, const float* right, int numSamples) noexcept;
+
+    // -inf until there is signal to measure.
+    float getMomentaryLufs() const noexcept;
+    float getShortTermLufs() const noexcept;
+    float getIntegratedLufs() const noexcept;
+
+  private:
+    struct Biquad {
+        double b0 = 1.0;
+        double b1 = 0.0;
+        double b2 = 0.0;
+        double a1 = 0.0;
+        double a2 = 0.0;
+    };
+
+    void finishSubBlock() noexcept;
+    void updateIntegrated() noexcept;
+
+    Biquad shelf_;
+    Biquad highpass_;
+    // Transposed direct form II state per channel: {shelf z1, shelf z2, high-pass z1, high-pass z2}.
+    std::array<std::array<double, 4>, 2> state_{};
+
+    int subBlockSamples_ = 4800;
+    int subBlockFill_ = 0;
+    double subBlockEnergy_ = 0.0;
+
+    // Mean-square energy of the newest kShortTermSubBlocks sub-blocks, as a ring.
+    std::array<double, kShortTermSubBlocks> subBlocks_{};
+    int subBlockIndex_ = 0;
+    int numSubBlocks_ = 0;
+
+    std::vector<double> histogramEnergy_;
+    std::vector<int> histogramCount_;
+
+    float momentaryLufs_ = -std::numeric_limits<float>::infinity();
+    float shortTermLufs_ = -std::numeric_limits<float>::infinity();
+    float integratedLufs_ = -std::numeric_limits<float>::infinity();
+};
+
+} // namespace qbdsp
@@ -0,0 +1,152 @@
+#include "MonoBassCrossover.h"
+#include "FirDesign.h"
+#include "KernelDispatch.h"
+#include "util/Trace.h"
+#include <juce_core/juce_core.h>
+#include <algorithm>
+
+namespace qbdsp {
+
+void MonoBassCrossover::prepare(double sampleRate, int maxLowBandDelay) {
+    QB_TRACE_SCOPE("MonoBassCrossover::prepare");
+    const double sampleRateSafe = sampleRate > 1.0 ? sampleRate : 48000.0;
+
+    int maxInputKeep = 0;
+    int maxDecimatedKeep = 0;
+    int maxInterpolatorKeep = 0;
+    int maxLatency = 0;
+    for (size_t option = 1; option < designs_.size(); ++option) {
+        auto& design = designs_[option];
+        const double crossoverHz = kFrequenciesHz[option];
+        design.factor = 1;
+        while (sampleRateSafe / static_cast<double>(design.factor * 2) >= kMinDecimatedRateRatio * crossoverHz)
+            design.factor *= 2;
+        const double decimatedRate = sampleRateSafe / static_cast<double>(design.factor);
+
+        // The anti-alias / anti-image filter keeps everything the low-pass passes or is still rolling off, and
+        // stops what would fold back onto it.
+        const double lowpassEdgeHz = crossoverHz * (1.0 + 0.5 * kTransitionRatio);
+        const double antiAliasStopHz = decimatedRate - lowpassEdgeHz;
+        const int antiAliasTaps =
+            FirDesign::chooseKaiserLength(antiAliasStopHz - lowpassEdgeHz, sampleRateSafe, kStopbandDb);
+        std::vector<float> coeffs(static_cast<size_t>(antiAliasTaps));
+        FirDesign::designKaiserLowpass(coeffs.data(), antiAliasTaps, 0.5 * (lowpassEdgeHz + antiAliasStopHz),
+                                       sampleRateSafe, kStopbandDb);
+        design.antiAlias.assign(coeffs.rbegin(), coeffs.rend());
+
+        design.tapsPerPhase = (antiAliasTaps + design.factor - 1) / design.factor;
+        design.polyphase.assign(static_cast<size_t>(design.factor * design.tapsPerPhase), 0.0f);
+        for (int p = 0; p < design.factor; ++p) {
+            float* branch = design.polyphase.data() + p * design.tapsPerPhase;
+            for (int j = 0; j < design.tapsPerPhase; ++j) {
+                const int tap = p + j * design.factor;
+                if (tap < antiAliasTaps)
+                    branch[design.tapsPerPhase - 1 - j] =
+                        static_cast<float>(design.factor) * coeffs[static_cast<size_t>(tap)];
+            }
+        }
+
+        const int lowpassTaps =
+            FirDesign::chooseKaiserLength(kTransitionRatio * crossoverHz, decimatedRate, kStopbandDb);
+        coeffs.assign(static_cast<size_t>(lowpassTaps), 0.0f);
+        FirDesign::designKaiserLowpass(coeffs.data(), lowpassTaps, crossoverHz, decimatedRate, kStopbandDb);
+        design.lowpass.assign(coeffs.rbegin(), coeffs.rend());
+
+        design.latency = 2 * ((antiAliasTaps - 1) / 2) + design.factor * ((lowpassTaps - 1) / 2);
+
+        maxInputKeep = juce::jmax(maxInputKeep, antiAliasTaps - 1);
+        maxDecimatedKeep = juce::jmax(maxDecimatedKeep, lowpassTaps - 1);
+        maxInterpolatorKeep = juce::jmax(maxInterpolatorKeep, design.tapsPerPhase - 1);
+        maxLatency = juce::jmax(maxLatency, design.latency);
+    }
+
+    maxLowBandDelay_ = juce::jmax(0, maxLowBandDelay);
+    lowBandDelay_ = juce::jmin(lowBandDelay_, maxLowBandDelay_);
+    input_.prepare(maxInputKeep);
+    decimated_.prepare(maxDecimatedKeep);
+    lowDecimated_.prepare(maxInterpolatorKeep);
+    dry_.prepare(maxLatency);
+    low_.prepare(maxLowBandDelay_);
+    reset();
+}
+
+void MonoBassCrossover::reset() noexcept {
+    phase_ = 0;
+    input_.reset();
+    decimated_.reset();
+    lowDecimated_.reset();
+    dry_.reset();
+    low_.reset();
+}
+
+void MonoBassCrossover::setFrequencyIndex(int index) noexcept {
+    index = juce::jlimit(0, EngineParams::kNumMonoBassOptions - 1, index);
+    if (index == index_)
+        return;
+
+    index_ = index;
+    reset();
+}
+
+int MonoBassCrossover::getFrequencyIndex() const noexcept {
+    return index_;
+}
+
+double MonoBassCrossover::getFrequencyHz() const noexcept {
+    return kFrequenciesHz[static_cast<size_t>(index_)];
+}
+
+bool MonoBassCrossover::isActive() const noexcept {
+    return index_ > 0 && !input_.data.empty();
+}
+
+int MonoBassCrossover::getDecimationFactor() const noexcept {
+    return isActive() ? designs_[static_cast<size_t>(index_)].factor : 1;
+}
+
+int MonoBassCrossover::getLatencySamples() const noexcept {
+    return isActive() ? designs_[static_cast<size_t>(index_)].latency : 0;
+}
+
+void MonoBassCrossover::setLowBandDelay(int samples) noexcept {
+    lowBandDelay_ = juce::jlimit(0, maxLowBandDelay_, samples);
+}
+
+void MonoBassCrossover::process(const float* input, float* low, float* high, int numSamples) noexcept {
+    if (!isActive()) {
+        std::fill(low, low + numSamples, 0.0f);
+        if (high != input)
+            std::copy(input, input + numSamples, high);
+        return;
+    }
+
+    const auto& kernels = KernelDispatch::get();
+    const auto& design = designs_[static_cast<size_t>(index_)];
+    const int antiAliasTaps = static_cast<int>(design.antiAlias.size());
+    const int lowpassTaps = static_cast<int>(design.lowpass.size());
+
+    for (int s = 0; s < numSamples; ++s) {
+        const float x = input[s];
+        dry_.push(x);
+        const float* in = input_.push(x);
+
+        // Decimate: only every factor-th anti-aliased sample is needed.
+        if (phase_ == 0) {
+            const float* decimated = decimated_.push(kernels.dot(design.antiAlias.data(), in - (antiAliasTaps - 1),
+                                                                 antiAliasTaps));
+            lowDecimated_.push(kernels.dot(design.lowpass.data(), decimated - (lowpassTaps - 1), lowpassTaps));
+        }
+
+        const float* branch = design.polyphase.data() + phase_ * design.tapsPerPhase;
+        const float lowBand = kernels.dot(branch, lowDecimated_.newest() - (design.tapsPerPhase - 1),
+                                          design.tapsPerPhase);
+        high[s] = dry_.read(design.latency) - lowBand;
+        low_.push(lowBand);
+        low[s] = low_.read(lowBandDelay_);
+
+        if (++phase_ == design.factor)
+            phase_ = 0;
+    }
+}
+
+} // namespace qbdsp
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "EngineParams.h"
+#include "SampleHistory.h"
+#include <array>
+#include <vector>
+
+namespace qbdsp {
+
+// Linear-phase two-way split of the mono signal for mono bass. The low band is a Kaiser low-pass at the crossover
+// frequency, run decimated by a power of two so its long transition costs a few taps per sample; the anti-alias
+// filter doubles as the polyphase interpolator. The high band is the delayed input minus the low band, so the two
+// always sum back to the delayed input exactly. Every option is designed in prepare(), so switching is
+// allocation-free.
+class MonoBassCrossover final {
+  public:
+    // Crossover frequency per EngineParams::monoBassIndex; index 0 is off.
+    static constexpr std::array<double, EngineParams::kNumMonoBassOptions> kFrequenciesHz{0.0,   60.0,  80.0, 100.0,
+                                                                                          120.0, 150.0, 200.0};
+    // The low-pass runs at the lowest power-of-two division of the sample rate that is still at least this
+    // multiple of the crossover frequency.
+    static constexpr double kMinDecimatedRateRatio = 16.0;
+    // Low-pass transition width as a multiple of the crossover frequency, centred on it: at 120 Hz the low band is
+    // flat to 30 Hz and down kStopbandDb from 210 Hz.
+    static constexpr double kTransitionRatio = 1.5;
+    static constexpr double kStopbandDb = 50.0;
+
+    // maxLowBandDelay bounds setLowBandDelay().
+    void prepare(double sampleRate, int maxLowBandDelay);
+    void reset() noexcept;
+
+    // A change clears the filter state.
+    void setFrequencyIndex(int index) noexcept;
+    int getFrequencyIndex() const noexcept;
+    double getFrequencyHz() const noexcept;
+    bool isActive() const noexcept;
+    int getDecimationFactor() const noexcept;
+    // Delay of both bands relative to the input (before setLowBandDelay()); 0 while off.
+    int getLatencySamples() const noexcept;
+
+    // Extra delay for the low band only, so it lines up with a Hilbert processor's I output for the high band.
+    void setLowBandDelay(int samples) noexcept;
+
+    // high may be the same buffer as input. While off, low is silent and high is the input.
+    void process(const float* input, float* low, float* high, int numSamples) noexcept;
+
+  private:
+    // Kernels are stored oldest-tap-first so each output is a forward dot product over a history.
+    struct Design {
+        int factor = 1;
+        std::vector<float> antiAlias;
+        // factor branches of tapsPerPhase taps each, gain factor folded in.
+        std::vector<float> polyphase;
+        int tapsPerPhase = 0;
+        // Runs at the decimated rate.
+        std::vector<float> lowpass;
+        int latency = 0;
+    };
+
+    std::array<Design, EngineParams::kNumMonoBassOptions> designs_;
+    int index_ = 0;
+    int phase_ = 0;
+    int lowBandDelay_ = 0;
+    int maxLowBandDelay_ = 0;
+
+    SampleHistory input_;
+    SampleHistory decimated_;
+    SampleHistory lowDecimated_;
+    DelayLine dry_;
+    DelayLine low_;
+};
+
+} // namespace qbdsp
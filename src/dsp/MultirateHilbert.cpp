@@ -0,0 +1,156 @@
+#include "MultirateHilbert.h"
+#include "FirDesign.h"
+#include "KernelDispatch.h"
+#include <algorithm>
+
+namespace qbdsp {
+
+void MultirateHilbert::Kernel::setFIR(const float* coeffs, int numTaps) {
+    reversed.assign(coeffs, coeffs + numTaps);
+    std::reverse(reversed.begin(), reversed.end());
+    span = numTaps;
+    stride = 1;
+    offset = 0;
+}
+
+void MultirateHilbert::Kernel::setHilbert(const float* coeffs, int numTaps) {
+    offset = (((numTaps - 1) / 2) % 2 == 0) ? 1 : 0;
+    reversed.clear();
+    for (int d = offset; d < numTaps; d += 2)
+        reversed.push_back(coeffs[d]);
+    std::reverse(reversed.begin(), reversed.end());
+    span = offset + 2 * static_cast<int>(reversed.size()) - 1;
+    stride = 2;
+}
+
+float MultirateHilbert::Kernel::apply(const simd::KernelTable& kernels, const float* newest) const noexcept {
+    const int numTaps = static_cast<int>(reversed.size());
+    const float* oldest = newest - (span - 1);
+    return stride == 1 ? kernels.dot(reversed.data(), oldest, numTaps)
+                       : kernels.dotStride2(reversed.data(), oldest, numTaps);
+}
+
+void MultirateHilbert::prepare(double sampleRate, int baseHilbertTaps, int maxHilbertTaps) {
+    factor_ = 1;
+    while (sampleRate / static_cast<double>(factor_ * 2) >= kMinBaseRate)
+        factor_ *= 2;
+
+    phase_ = 0;
+    if (!isActive()) {
+        latencySamples_ = 0;
+        return;
+    }
+
+    const double baseRate = sampleRate / static_cast<double>(factor_);
+
+    // Anti-alias / anti-image low-pass: flat to 0.375 * baseRate, stopband from the base-rate Nyquist so nothing
+    // folds back into the band the low-rate Hilbert sees.
+    const double passbandHz = 0.375 * baseRate;
+    const double stopbandHz = 0.5 * baseRate;
+    const int lowpassTaps = FirDesign::chooseKaiserLength(stopbandHz - passbandHz, sampleRate, kLowpassStopbandDb);
+    std::vector<float> coeffs(static_cast<size_t>(lowpassTaps));
+    FirDesign::designKaiserLowpass(coeffs.data(), lowpassTaps, 0.5 * (passbandHz + stopbandHz), sampleRate,
+                                   kLowpassStopbandDb);
+    lowpass_.setFIR(coeffs.data(), lowpassTaps);
+    lowpassDelay_ = (lowpassTaps - 1) / 2;
+
+    tapsPerPhase_ = (lowpassTaps + factor_ - 1) / factor_;
+    polyphase_.resize(static_cast<size_t>(factor_));
+    std::vector<float> branch(static_cast<size_t>(tapsPerPhase_));
+    for (int p = 0; p < factor_; ++p) {
+        for (int j = 0; j < tapsPerPhase_; ++j) {
+            const int tap = p + j * factor_;
+            branch[static_cast<size_t>(j)] =
+                tap < lowpassTaps ? static_cast<float>(factor_) * coeffs[static_cast<size_t>(tap)] : 0.0f;
+        }
+        polyphase_[static_cast<size_t>(p)].setFIR(branch.data(), tapsPerPhase_);
+    }
+
+    const int lowTaps = FirDesign::chooseHilbertTapCount(baseRate, baseHilbertTaps, maxHilbertTaps);
+    coeffs.assign(static_cast<size_t>(lowTaps), 0.0f);
+    FirDesign::designHilbert(coeffs.data(), lowTaps, baseRate, 30.0, 0.45 * 0.5 * baseRate);
+    lowHilbert_.setHilbert(coeffs.data(), lowTaps);
+    lowHilbertDelay_ = (lowTaps - 1) / 2;
+
+    // The residual band only carries energy above the low-pass passband edge, so the short kernel is sized for
+    // about four periods of that frequency (with a floor for the 2x case) and normalised from just below it to
+    // near Nyquist.
+    const double highEdgeHz = 0.9 * passbandHz;
+    int highTaps = juce::jmax(kMinHighBandTaps, static_cast<int>(std::ceil(4.0 * sampleRate / highEdgeHz)));
+    highTaps += (highTaps % 2) == 0 ? 1 : 0;
+    coeffs.assign(static_cast<size_t>(highTaps), 0.0f);
+    FirDesign::designHilbert(coeffs.data(), highTaps, sampleRate, highEdgeHz, 0.48 * sampleRate);
+    highHilbert_.setHilbert(coeffs.data(), highTaps);
+    highHilbertDelay_ = (highTaps - 1) / 2;
+
+    const int lowBandDelay = 2 * lowpassDelay_;
+    latencySamples_ = lowBandDelay + factor_ * lowHilbertDelay_;
+    jassert(factor_ * lowHilbertDelay_ >= highHilbertDelay_);
+
+    input_.prepare(lowpassTaps - 1);
+    lowInput_.prepare(lowTaps - 1);
+    lowBand_.prepare(tapsPerPhase_ - 1);
+    lowQuadrature_.prepare(tapsPerPhase_ - 1);
+    highBand_.prepare(highTaps - 1);
+    dry_.prepare(latencySamples_);
+    highQuadrature_.prepare(factor_ * lowHilbertDelay_ - highHilbertDelay_);
+}
+
+void MultirateHilbert::reset() noexcept {
+    phase_ = 0;
+    input_.reset();
+    lowInput_.reset();
+    lowBand_.reset();
+    lowQuadrature_.reset();
+    highBand_.reset();
+    dry_.reset();
+    highQuadrature_.reset();
+}
+
+bool MultirateHilbert::isActive() const noexcept {
+    return factor_ > 1;
+}
+
+int MultirateHilbert::getDecimationFactor() const noexcept {
+    return factor_;
+}
+
+int MultirateHilbert::getLatencySamples() const noexcept {
+    return latencySamples_;
+}
+
+void MultirateHilbert::process(float* iData, float* qData, int numSamples) noexcept {
+    const auto& kernels = KernelDispatch::get();
+    const int lowBandDelay = 2 * lowpassDelay_;
+    const int highAlignDelay = factor_ * lowHilbertDelay_ - highHilbertDelay_;
+
+    for (int s = 0; s < numSamples; ++s) {
+        const float x = iData[s];
+        dry_.push(x);
+        const float* in = input_.push(x);
+
+        // Decimate: only every factor_-th low-pass output is needed.
+        if (phase_ == 0) {
+            const float low = lowpass_.apply(kernels, in);
+            const float* lowIn = lowInput_.push(low);
+            lowBand_.push(low);
+            lowQuadrature_.push(lowHilbert_.apply(kernels, lowIn));
+        }
+
+        // Interpolate both low-rate streams back up with the polyphase branch for this output phase.
+        const auto& branch = polyphase_[static_cast<size_t>(phase_)];
+        const float lowBand = branch.apply(kernels, lowBand_.newest());
+        const float lowQ = branch.apply(kernels, lowQuadrature_.newest());
+
+        const float* highIn = highBand_.push(dry_.read(lowBandDelay) - lowBand);
+        highQuadrature_.push(highHilbert_.apply(kernels, highIn));
+
+        iData[s] = dry_.read(latencySamples_);
+        qData[s] = lowQ + highQuadrature_.read(highAlignDelay);
+
+        if (++phase_ == factor_)
+            phase_ = 0;
+    }
+}
+
+} // namespace qbdsp
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "SampleHistory.h"
+#include "simd/KernelTable.h"
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+namespace qbdsp {
+
+// Two-band Hilbert transformer whose cost stays roughly flat with sample rate.
+//
+// The input is low-passed and decimated by a power of two to a 44.1..88.2 kHz base rate. There, a full-length
+// Hilbert kernel (the same design the FIR mode uses at that rate) produces the low-band quadrature. The residual
+// above the base band is x minus the re-interpolated low band; a short full-rate Hilbert handles it, since it only
+// needs accuracy from the crossover upwards. Both bands are delay-matched before they are summed. I is the input
+// delayed by the same total latency.
+class MultirateHilbert final {
+  public:
+    // Below this rate no decimation happens and isActive() returns false.
+    static constexpr double kMinBaseRate = 44100.0;
+    static constexpr double kLowpassStopbandDb = 80.0;
+    static constexpr int kMinHighBandTaps = 63;
+
+    void prepare(double sampleRate, int baseHilbertTaps, int maxHilbertTaps);
+    void reset() noexcept;
+
+    bool isActive() const noexcept;
+    int getDecimationFactor() const noexcept;
+    int getLatencySamples() const noexcept;
+
+    // In-place: iData is replaced by the delayed input, qData receives the quadrature signal.
+    void process(float* iData, float* qData, int numSamples) noexcept;
+
+  private:
+    // Kernels are stored oldest-tap-first so each output is a forward dot product over the history.
+    struct Kernel {
+        void setFIR(const float* coeffs, int numTaps);
+        // Keeps only the non-zero odd-offset taps of a type III Hilbert kernel.
+        void setHilbert(const float* coeffs, int numTaps);
+        float apply(const simd::KernelTable& kernels, const float* newest) const noexcept;
+
+        std::vector<float> reversed;
+        int span = 0;   // history samples covered, newest included
+        int stride = 1; // 1 for plain FIR, 2 for Hilbert
+        int offset = 0; // first non-zero tap behind newest
+    };
+
+    int factor_ = 1;
+    int phase_ = 0;
+    int latencySamples_ = 0;
+
+    Kernel lowpass_;
+    int lowpassDelay_ = 0;
+    // Interpolation polyphase branches, one per output phase (gain factor_ folded in).
+    std::vector<Kernel> polyphase_;
+    int tapsPerPhase_ = 0;
+
+    Kernel lowHilbert_;
+    int lowHilbertDelay_ = 0;
+    Kernel highHilbert_;
+    int highHilbertDelay_ = 0;
+
+    SampleHistory input_;
+    SampleHistory lowInput_;
+    SampleHistory lowBand_;
+    SampleHistory lowQuadrature_;
+    SampleHistory highBand_;
+    DelayLine dry_;
+    DelayLine highQuadrature_;
+};
+
+} // namespace qbdsp
@@ -0,0 +1,55 @@
+#include "OfflineRenderPool.h"
+
+namespace qbdsp {
+
+OfflineRenderPool::~OfflineRenderPool() = default;
+
+int OfflineRenderPool::getNumWorkers() const noexcept {
+    return numWorkers_.load(std::memory_order_acquire);
+}
+
+juce::ThreadPool& OfflineRenderPool::getPool() {
+    const juce::ScopedLock lock(poolLock_);
+    if (pool_ == nullptr) {
+        const int numWorkers = juce::jmax(1, juce::SystemStats::getNumCpus() - 1);
+        pool_ = std::make_unique<juce::ThreadPool>(numWorkers);
+        numWorkers_.store(numWorkers, std::memory_order_release);
+    }
+
+    return *pool_;
+}
+
+void OfflineRenderPool::parallelFor(int numItems, int minItemsPerSlice, const RangeJob& job) {
+    if (numItems <= 0)
+        return;
+
+    const int maxSlices = juce::jmax(1, numItems / juce::jmax(1, minItemsPerSlice));
+    if (maxSlices == 1) {
+        job(0, numItems);
+        return;
+    }
+
+    auto& pool = getPool();
+    const int numSlices = juce::jmin(maxSlices, getNumWorkers() + 1);
+    const int sliceSize = (numItems + numSlices - 1) / numSlices;
+
+    std::atomic<int> remaining{numSlices - 1};
+    juce::WaitableEvent finished;
+
+    for (int slice = 1; slice < numSlices; ++slice) {
+        const int begin = slice * sliceSize;
+        const int end = juce::jmin(numItems, begin + sliceSize);
+        pool.addJob([&job, &remaining, &finished, begin, end] {
+            if (begin < end)
+                job(begin, end);
+
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                finished.signal();
+        });
+    }
+
+    job(0, juce::jmin(numItems, sliceSize));
+    finished.wait(-1);
+}
+
+} // namespace qbdsp
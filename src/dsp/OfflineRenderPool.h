@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <juce_dsp/juce_dsp.h>
+#include <memory>
+
+namespace qbdsp {
+
+// Worker pool shared by every plugin instance (via juce::SharedResourcePointer) for splitting heavy DSP across
+// cores during offline renders. The worker threads are only started the first time a render asks for them, so
+// realtime-only sessions never pay for the pool.
+class OfflineRenderPool final {
+  public:
+    using RangeJob = std::function<void(int begin, int end)>;
+
+    OfflineRenderPool() = default;
+    ~OfflineRenderPool();
+
+    // Splits [0, numItems) into contiguous slices of at least minItemsPerSlice and runs job on each. The calling
+    // thread takes the first slice itself; returns once every slice has finished.
+    void parallelFor(int numItems, int minItemsPerSlice, const RangeJob& job);
+
+    int getNumWorkers() const noexcept;
+
+  private:
+    juce::ThreadPool& getPool();
+
+    juce::CriticalSection poolLock_;
+    std::unique_ptr<juce::ThreadPool> pool_;
+    std::atomic<int> numWorkers_{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderPool)
+};
+
+} // namespace qbdsp
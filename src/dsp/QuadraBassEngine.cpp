@@ -0,0 +1,323 @@
+#include "QuadraBassEngine.h"
+#include "KernelDispatch.h"
+#include "util/Trace.h"
+#include <cmath>
+
+namespace qbdsp {
+
+void QuadraBassEngine::prepare(double sampleRate, int maximumBlockSize, int numChannels) {
+    maximumBlockSize_ = juce::jmax(1, maximumBlockSize);
+    sampleRate_ = sampleRate > 1.0 ? sampleRate : 48000.0;
+
+    juce::dsp::ProcessSpec spec{};
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = static_cast<juce::uint32>(maximumBlockSize_);
+    spec.numChannels = static_cast<juce::uint32>(juce::jmax(1, numChannels));
+
+    outputGain_.reset();
+    outputGain_.prepare(spec);
+    outputGain_.setRampDurationSeconds(0.02);
+    outputGain_.setGainDecibels(params_.outputGainDb);
+
+    hilbert_.prepare(spec);
+    if (params_.hilbertModeIndex == EngineParams::kAutoHilbertModeIndex) {
+        autoSelection_ = HilbertEngineSelector::selectInBackground(sampleRate_, maximumBlockSize_, *selectionWorker_);
+        autoSelectionApplied_ = false;
+        autoHilbertMode_ = HilbertQuadratureProcessor::Mode::FIR;
+        updateAutoHilbertMode();
+    }
+    activeHilbertMode_ = getRequestedHilbertMode();
+    hilbert_.setMode(activeHilbertMode_);
+    hilbert_.setFIRTier(0);
+    quality_.setNumTiers(HilbertQuadratureProcessor::kNumFIRTiers);
+    quality_.setSessionBudget(AdaptiveQualityController::kDefaultSessionBudgetPerCore *
+                              static_cast<double>(juce::jmax(1, juce::SystemStats::getNumCpus())));
+    sessionContribution_.set(0.0);
+    crossover_.prepare(sampleRate_, hilbert_.getMaxLatencySamples());
+    applyHilbertMode();
+    stereoMatrix_.prepare(spec);
+
+    monoBuffer_.setSize(1, maximumBlockSize_, false, true, true);
+    lowBuffer_.setSize(1, maximumBlockSize_, false, true, true);
+    xHighBuffer_.setSize(1, maximumBlockSize_, false, true, true);
+    qBuffer_.setSize(1, maximumBlockSize_, false, true, true);
+    zeroBuffer_.setSize(1, maximumBlockSize_, false, true, true);
+    numNonFiniteBlocks_ = 0;
+    nonFiniteRampDone_ = kNonFiniteRampSamples;
+    prepared_ = true;
+}
+
+void QuadraBassEngine::reset() noexcept {
+    // The filter history is cleared here anyway, so this is the one point besides prepare() where a finished Auto
+    // benchmark can change the backend (and the latency) without a dropout.
+    if (prepared_ && updateAutoHilbertMode())
+        applyHilbertMode();
+    hilbert_.reset();
+    crossover_.reset();
+    stereoMatrix_.reset();
+    outputGain_.reset();
+    nonFiniteRampDone_ = kNonFiniteRampSamples;
+}
+
+void QuadraBassEngine::setParameters(const EngineParams& newParams) noexcept {
+    params_.widthPercent =
+        juce::jlimit(EngineParams::kMinWidthPercent, EngineParams::kMaxWidthPercent, newParams.widthPercent);
+    params_.hilbertModeIndex = juce::jlimit(0, EngineParams::kNumHilbertModes - 1, newParams.hilbertModeIndex);
+    params_.phaseAngleDeg =
+        juce::jlimit(EngineParams::kMinPhaseAngleDeg, EngineParams::kMaxPhaseAngleDeg, newParams.phaseAngleDeg);
+    params_.phaseRotationDeg = juce::jlimit(EngineParams::kMinPhaseRotationDeg, EngineParams::kMaxPhaseRotationDeg,
+                                            newParams.phaseRotationDeg);
+    params_.outputGainDb =
+        juce::jlimit(EngineParams::kMinOutputGainDb, EngineParams::kMaxOutputGainDb, newParams.outputGainDb);
+    params_.monoBassIndex = juce::jlimit(0, EngineParams::kNumMonoBassOptions - 1, newParams.monoBassIndex);
+
+    // Switching mode or mono bass changes the reported latency, so hosts polling getLatencySamples() see it straight
+    // away.
+    if (prepared_)
+        applyHilbertMode();
+}
+
+const EngineParams& QuadraBassEngine::getParameters() const noexcept {
+    return params_;
+}
+
+int QuadraBassEngine::getLatencySamples() const noexcept {
+    return hilbert_.getLatencySamples() + crossover_.getLatencySamples();
+}
+
+HilbertQuadratureProcessor::Mode QuadraBassEngine::getActiveHilbertMode() const noexcept {
+    return activeHilbertMode_;
+}
+
+bool QuadraBassEngine::isAutoHilbertModePending() const noexcept {
+    return !autoSelectionApplied_;
+}
+
+void QuadraBassEngine::waitForAutoHilbertMode() {
+    autoSelection_.wait();
+    if (prepared_ && updateAutoHilbertMode())
+        applyHilbertMode();
+}
+
+void QuadraBassEngine::setOfflineRendering(bool shouldUseWorkers) noexcept {
+    hilbert_.setOfflineRendering(shouldUseWorkers);
+}
+
+void QuadraBassEngine::setProcessingProfile(ProcessingProfile profile) noexcept {
+    hilbert_.setProcessingProfile(profile);
+    stereoMatrix_.setProcessingProfile(profile);
+}
+
+ProcessingProfile QuadraBassEngine::getProcessingProfile() const noexcept {
+    return hilbert_.getProcessingProfile();
+}
+
+void QuadraBassEngine::setAdaptiveQuality(bool enabled) noexcept {
+    adaptiveQuality_ = enabled;
+}
+
+bool QuadraBassEngine::isAdaptiveQualityEnabled() const noexcept {
+    return adaptiveQuality_;
+}
+
+int QuadraBassEngine::getQualityTier() const noexcept {
+    return hilbert_.getFIRTier();
+}
+
+double QuadraBassEngine::getProcessingLoad() const noexcept {
+    return quality_.getLoad();
+}
+
+double QuadraBassEngine::getSessionLoad() const noexcept {
+    return sessionLoad_->getTotal();
+}
+
+int QuadraBassEngine::getNumQualityChanges() const noexcept {
+    return quality_.getNumTransitions();
+}
+
+int QuadraBassEngine::getNumNonFiniteBlocks() const noexcept {
+    return numNonFiniteBlocks_;
+}
+
+void QuadraBassEngine::applyHilbertMode() noexcept {
+    const auto requestedMode = getRequestedHilbertMode();
+    if (requestedMode != activeHilbertMode_) {
+        activeHilbertMode_ = requestedMode;
+        hilbert_.setMode(activeHilbertMode_);
+    }
+
+    // The Hilbert filter only sees the high band, so the FIR path can drop to a kernel that is accurate from the
+    // crossover up; the low band is held back by the Hilbert latency to stay aligned with I.
+    const bool linearPhase = HilbertQuadratureProcessor::isLinearPhase(activeHilbertMode_);
+    crossover_.setFrequencyIndex(linearPhase ? params_.monoBassIndex : 0);
+    hilbert_.setFIRLowestFrequency(crossover_.getFrequencyHz());
+    crossover_.setLowBandDelay(hilbert_.getLatencySamples());
+}
+
+bool QuadraBassEngine::updateAutoHilbertMode() noexcept {
+    if (autoSelectionApplied_ || !autoSelection_.isReady())
+        return false;
+
+    autoSelectionApplied_ = true;
+    if (autoSelection_.getMode() == autoHilbertMode_)
+        return false;
+
+    autoHilbertMode_ = autoSelection_.getMode();
+    return true;
+}
+
+HilbertQuadratureProcessor::Mode QuadraBassEngine::getRequestedHilbertMode() const noexcept {
+    if (params_.hilbertModeIndex == EngineParams::kAutoHilbertModeIndex)
+        return autoHilbertMode_;
+
+    return HilbertQuadratureProcessor::modeFromIndex(params_.hilbertModeIndex);
+}
+
+void QuadraBassEngine::process(juce::AudioBuffer<float>& buffer, int numInputChannels,
+                               int numOutputChannels) noexcept {
+    const int samples = buffer.getNumSamples();
+    if (!prepared_ || samples <= 0)
+        return;
+
+    // Offline renders have no deadline, and a timing-driven tier would make deterministic renders differ per run.
+    const bool adapt = adaptiveQuality_ && hilbert_.usesFIRTiers() && !hilbert_.isOfflineRendering() &&
+                       !KernelDispatch::isDeterministic();
+    if (!adapt) {
+        sessionContribution_.set(0.0);
+        if (hilbert_.getFIRTier() != 0) {
+            quality_.reset();
+            hilbert_.setFIRTier(0);
+        }
+    }
+    const auto startTicks = adapt ? juce::Time::getHighResolutionTicks() : 0;
+
+    if (samples <= maximumBlockSize_) {
+        processChunk(buffer, numInputChannels, numOutputChannels);
+    } else {
+        for (int start = 0; start < samples; start += maximumBlockSize_) {
+            juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start,
+                                           juce::jmin(maximumBlockSize_, samples - start));
+            processChunk(chunk, numInputChannels, numOutputChannels);
+        }
+    }
+
+    if (adapt) {
+        const double seconds =
+            juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        hilbert_.setFIRTier(
+            quality_.update(seconds, static_cast<double>(samples) / sampleRate_, sessionLoad_->getTotal()));
+        sessionContribution_.set(quality_.getLoad());
+    }
+}
+
+void QuadraBassEngine::processChunk(juce::AudioBuffer<float>& buffer, int numInputChannels,
+                                    int numOutputChannels) noexcept {
+    const int samples = buffer.getNumSamples();
+    numInputChannels = juce::jmin(numInputChannels, buffer.getNumChannels());
+    if (numInputChannels <= 0)
+        return;
+
+    monoBuffer_.setSize(1, samples, false, false, true);
+    lowBuffer_.setSize(1, samples, false, false, true);
+    xHighBuffer_.setSize(1, samples, false, false, true);
+    qBuffer_.setSize(1, samples, false, false, true);
+    zeroBuffer_.setSize(1, samples, false, false, true);
+    zeroBuffer_.clear();
+
+    bool nonFinite = false;
+    {
+        QB_TRACE_SCOPE("downmix");
+        // Keep widening full-band so width behavior stays consistent across the spectrum.
+        float* monoData = monoBuffer_.getWritePointer(0);
+        const float mixScale = 1.0f / static_cast<float>(numInputChannels);
+        // Any NaN or Inf in an input channel survives the downmix, so the kernel checks its sums as it writes them
+        // and the input costs no separate scan.
+        nonFinite = !KernelDispatch::get().downmix(buffer.getArrayOfReadPointers(), numInputChannels, mixScale,
+                                                   monoData, samples);
+        if (nonFinite)
+            scrubNonFiniteInput(monoData, samples);
+        xHighBuffer_.copyFrom(0, 0, monoBuffer_, 0, 0, samples);
+    }
+
+    const bool monoBass = crossover_.isActive();
+    if (monoBass) {
+        QB_TRACE_SCOPE("crossover");
+        float* monoData = monoBuffer_.getWritePointer(0);
+        crossover_.process(monoData, lowBuffer_.getWritePointer(0), monoData, samples);
+    }
+
+    {
+        QB_TRACE_SCOPE("hilbert");
+        const bool linearWidthLaw = HilbertQuadratureProcessor::usesLinearWidthLaw(activeHilbertMode_);
+        hilbert_.setQuadratureNeeded(stereoMatrix_.usesQuadrature(params_.widthPercent, params_.phaseAngleDeg,
+                                                                  params_.phaseRotationDeg, linearWidthLaw));
+        hilbert_.process(monoBuffer_, qBuffer_, params_.phaseAngleDeg);
+    }
+
+    {
+        QB_TRACE_SCOPE("stereoMatrix");
+        stereoMatrix_.process(monoBass ? lowBuffer_ : zeroBuffer_, xHighBuffer_, monoBuffer_, qBuffer_, buffer,
+                              params_.widthPercent, params_.phaseAngleDeg, params_.phaseRotationDeg,
+                              HilbertQuadratureProcessor::usesLinearWidthLaw(activeHilbertMode_));
+
+        if (numOutputChannels == 1 && buffer.getNumChannels() > 1)
+            buffer.clear(1, 0, samples);
+    }
+
+    {
+        QB_TRACE_SCOPE("outputGain");
+        outputGain_.setGainDecibels(params_.outputGainDb);
+        juce::dsp::AudioBlock<float> block(buffer);
+        juce::dsp::ProcessContextReplacing<float> context(block);
+        outputGain_.process(context);
+    }
+
+    QB_TRACE_SCOPE("nonFiniteGuard");
+    nonFinite = guardOutput(buffer, numOutputChannels, monoBass) || nonFinite;
+    if (nonFinite)
+        ++numNonFiniteBlocks_;
+}
+
+void QuadraBassEngine::scrubNonFiniteInput(float* mono, int numSamples) noexcept {
+    for (int s = 0; s < numSamples; ++s)
+        if (!std::isfinite(mono[s]))
+            mono[s] = 0.0f;
+}
+
+bool QuadraBassEngine::guardOutput(juce::AudioBuffer<float>& buffer, int numOutputChannels, bool monoBass) noexcept {
+    const auto& kernels = KernelDispatch::get();
+    const int samples = buffer.getNumSamples();
+    const int numGuarded = juce::jmin(numOutputChannels, buffer.getNumChannels());
+
+    // One pass over every output channel; the stage buffers are only scanned once something was found.
+    if (!kernels.allFinite(buffer.getArrayOfReadPointers(), numGuarded, samples)) {
+        // The input is already clean, so a non-finite output grew inside a stage. The stage buffers still hold this
+        // block's I, Q and low band, which shows whose state holds it; the stereo matrix and output gain only keep
+        // (finite) gains.
+        const float* const hilbertSignals[] = {monoBuffer_.getReadPointer(0), qBuffer_.getReadPointer(0)};
+        if (!kernels.allFinite(hilbertSignals, 2, samples))
+            hilbert_.reset();
+        if (monoBass && !kernels.allFinite(lowBuffer_.getArrayOfReadPointers(), 1, samples))
+            crossover_.reset();
+
+        for (int ch = 0; ch < numGuarded; ++ch)
+            buffer.clear(ch, 0, samples);
+        nonFiniteRampDone_ = 0;
+        return true;
+    }
+
+    if (nonFiniteRampDone_ < kNonFiniteRampSamples) {
+        const int count = juce::jmin(samples, kNonFiniteRampSamples - nonFiniteRampDone_);
+        const float step = 1.0f / static_cast<float>(kNonFiniteRampSamples);
+        const float startGain = static_cast<float>(nonFiniteRampDone_) * step;
+        const float endGain = static_cast<float>(nonFiniteRampDone_ + count) * step;
+        for (int ch = 0; ch < numGuarded; ++ch)
+            buffer.applyGainRamp(ch, 0, count, startGain, endGain);
+        nonFiniteRampDone_ += count;
+    }
+
+    return false;
+}
+
+} // namespace qbdsp
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "AdaptiveQualityController.h"
+#include "EngineParams.h"
+#include "HilbertEngineSelector.h"
+#include "HilbertQuadratureProcessor.h"
+#include "MonoBassCrossover.h"
+#include "StereoMatrixProcessor.h"
+#include <juce_dsp/juce_dsp.h>
+
+namespace qbdsp {
+
+// The complete QuadraBass signal chain (mono downmix, mono-bass crossover, Hilbert quadrature, stereo matrix, output
+// gain) with no dependency on the plugin wrapper or GUI modules. The plugin, the quadrabass_dsp library and its C API
+// all run audio through this class.
+class QuadraBassEngine final {
+  public:
+    // After the non-finite guard resets a stage, the output fades back in over this many samples.
+    static constexpr int kNonFiniteRampSamples = 1024;
+
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+    void reset() noexcept;
+
+    // Takes effect on the next processed block. Values outside the EngineParams ranges are clamped.
+    void setParameters(const EngineParams& newParams) noexcept;
+    const EngineParams& getParameters() const noexcept;
+
+    // Hilbert latency plus, while mono bass is on in a linear-phase mode, the crossover's.
+    int getLatencySamples() const noexcept;
+    // The mode actually running. For the Auto index that is FIR until the backend benchmark started by prepare()
+    // finishes on the selector's worker thread. The choice is only applied by the next prepare() or reset(), where
+    // the filter history starts over anyway, so the backend and latency never change in the middle of playback.
+    HilbertQuadratureProcessor::Mode getActiveHilbertMode() const noexcept;
+    bool isAutoHilbertModePending() const noexcept;
+    // Blocks until the Auto benchmark has finished and switches to its choice. Call it right after prepare(), before
+    // processing, from hosts that need the final latency up front (offline renders, the C API). Never call it on the
+    // audio thread.
+    void waitForAutoHilbertMode();
+    void setOfflineRendering(bool shouldUseWorkers) noexcept;
+
+    // Render trades CPU for accuracy (double-precision Hilbert filters, per-sample matrix gain ramps) without
+    // changing the reported latency. Switching clears the IIR filter state.
+    void setProcessingProfile(ProcessingProfile profile) noexcept;
+    ProcessingProfile getProcessingProfile() const noexcept;
+
+    // Opt-in load-adaptive quality: each block is timed against its real-time duration and, under sustained
+    // pressure on this instance or across all adaptive instances in the process, the FIR kernel steps down to a
+    // shorter tier (see HilbertQuadratureProcessor::setFIRTier) and back up when headroom returns. Latency never
+    // changes. Only the realtime FIR path adapts; offline, Render-profile and
+    // deterministic processing always run full quality.
+    void setAdaptiveQuality(bool enabled) noexcept;
+    bool isAdaptiveQualityEnabled() const noexcept;
+    // Telemetry for hosts and the editor: the FIR tier now running (0 is full quality), the smoothed processing
+    // load, the summed load of every adaptive instance in the process (in cores), and how many tier changes the
+    // controller has made since prepare().
+    int getQualityTier() const noexcept;
+    double getProcessingLoad() const noexcept;
+    double getSessionLoad() const noexcept;
+    int getNumQualityChanges() const noexcept;
+
+    // Every block is scanned for NaN and Inf on the way in and out. Non-finite input samples are zeroed before they
+    // reach any filter history. Non-finite output (e.g. an overflow inside a filter) is replaced by silence, only the
+    // stage that produced it (Hilbert filter or crossover) is reset, and the output ramps back in over
+    // kNonFiniteRampSamples. Counts the blocks where either happened since prepare().
+    int getNumNonFiniteBlocks() const noexcept;
+
+    // Processes in place: the first numInputChannels channels are downmixed and the widened result is written to
+    // the first numOutputChannels (1 or 2). Blocks longer than the prepared maximum are split, so this never
+    // allocates.
+    void process(juce::AudioBuffer<float>& buffer, int numInputChannels, int numOutputChannels) noexcept;
+
+  private:
+    void processChunk(juce::AudioBuffer<float>& buffer, int numInputChannels, int numOutputChannels) noexcept;
+    // Zeroes the non-finite samples of a downmix that the kernel reported as non-finite.
+    void scrubNonFiniteInput(float* mono, int numSamples) noexcept;
+    // Returns true when the output was non-finite and the guard reset the offending stage.
+    bool guardOutput(juce::AudioBuffer<float>& buffer, int numOutputChannels, bool monoBass) noexcept;
+    void applyHilbertMode() noexcept;
+    // Picks up a finished Auto benchmark; returns true when autoHilbertMode_ changed.
+    bool updateAutoHilbertMode() noexcept;
+    HilbertQuadratureProcessor::Mode getRequestedHilbertMode() const noexcept;
+
+    EngineParams params_;
+    bool prepared_ = false;
+    int maximumBlockSize_ = 0;
+    double sampleRate_ = 48000.0;
+    bool adaptiveQuality_ = false;
+    AdaptiveQualityController quality_;
+    juce::SharedResourcePointer<AdaptiveQualityController::SessionLoad> sessionLoad_;
+    AdaptiveQualityController::SessionLoad::Contribution sessionContribution_{*sessionLoad_};
+    int numNonFiniteBlocks_ = 0;
+    int nonFiniteRampDone_ = kNonFiniteRampSamples;
+
+    HilbertQuadratureProcessor hilbert_;
+    // Only runs in the linear-phase modes, so IIR keeps zero latency with mono bass ignored.
+    MonoBassCrossover crossover_;
+    StereoMatrixProcessor stereoMatrix_;
+    HilbertQuadratureProcessor::Mode activeHilbertMode_ = HilbertQuadratureProcessor::Mode::FIR;
+    // Only measured when prepare() runs in Auto, and never on the calling thread. Switching to Auto between prepares
+    // reuses that result, or runs FIR until the next prepare, so the audio thread never benchmarks.
+    juce::SharedResourcePointer<HilbertEngineSelector::Worker> selectionWorker_;
+    HilbertEngineSelector::PendingMode autoSelection_;
+    bool autoSelectionApplied_ = true;
+    HilbertQuadratureProcessor::Mode autoHilbertMode_ = HilbertQuadratureProcessor::Mode::FIR;
+    juce::AudioBuffer<float> monoBuffer_;
+    juce::AudioBuffer<float> lowBuffer_;
+    juce::AudioBuffer<float> xHighBuffer_;
+    juce::AudioBuffer<float> qBuffer_;
+    juce::AudioBuffer<float> zeroBuffer_;
+    juce::dsp::Gain<float> outputGain_;
+};
+
+} // namespace qbdsp
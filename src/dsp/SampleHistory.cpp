@@ -0,0 +1,67 @@
+#include "SampleHistory.h"
+#include <juce_core/juce_core.h>
+#include <algorithm>
+
+namespace qbdsp {
+
+void SampleHistory::prepare(int keepSamples) {
+    keep = juce::jmax(0, keepSamples);
+    data.assign(static_cast<size_t>(keep + kChunk), 0.0f);
+    reset();
+}
+
+void SampleHistory::reset() noexcept {
+    std::fill(data.begin(), data.end(), 0.0f);
+    pos = keep;
+}
+
+const float* SampleHistory::push(float x) noexcept {
+    if (pos == static_cast<int>(data.size())) {
+        std::copy(data.end() - keep, data.end(), data.begin());
+        pos = keep;
+    }
+
+    data[static_cast<size_t>(pos)] = x;
+    return data.data() + pos++;
+}
+
+const float* SampleHistory::push(const float* x, int numSamples) noexcept {
+    if (pos + numSamples > static_cast<int>(data.size())) {
+        std::copy(data.begin() + pos - keep, data.begin() + pos, data.begin());
+        pos = keep;
+    }
+
+    float* first = data.data() + pos;
+    std::copy(x, x + numSamples, first);
+    pos += numSamples;
+    return first;
+}
+
+const float* SampleHistory::newest() const noexcept {
+    return data.data() + pos - 1;
+}
+
+void DelayLine::prepare(int maxDelaySamples) {
+    data.assign(static_cast<size_t>(juce::jmax(0, maxDelaySamples) + 1), 0.0f);
+    reset();
+}
+
+void DelayLine::reset() noexcept {
+    std::fill(data.begin(), data.end(), 0.0f);
+    writeIndex = 0;
+}
+
+void DelayLine::push(float x) noexcept {
+    if (++writeIndex == static_cast<int>(data.size()))
+        writeIndex = 0;
+    data[static_cast<size_t>(writeIndex)] = x;
+}
+
+float DelayLine::read(int delaySamples) const noexcept {
+    int index = writeIndex - delaySamples;
+    if (index < 0)
+        index += static_cast<int>(data.size());
+    return data[static_cast<size_t>(index)];
+}
+
+} // namespace qbdsp
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+namespace qbdsp {
+
+// Contiguous history (the last `keep` samples followed by new ones) so FIR kernels can read backwards from the newest
+// sample without wrapping. Compacts back to the front when the chunk fills up.
+struct SampleHistory {
+    static constexpr int kChunk = 4096;
+
+    void prepare(int keepSamples);
+    void reset() noexcept;
+    const float* push(float x) noexcept;
+    // Appends numSamples (at most kChunk) and returns a pointer to the first of them.
+    const float* push(const float* x, int numSamples) noexcept;
+    const float* newest() const noexcept;
+
+    std::vector<float> data;
+    int keep = 0;
+    int pos = 0;
+};
+
+struct DelayLine {
+    void prepare(int maxDelaySamples);
+    void reset() noexcept;
+    void push(float x) noexcept;
+    float read(int delaySamples) const noexcept;
+
+    std::vector<float> data;
+    int writeIndex = 0;
+};
+
+} // namespace qbdsp
@@ -0,0 +1,109 @@
+#include "SpectralHilbert.h"
+#include <algorithm>
+#include <cmath>
+
+namespace qbdsp {
+
+void SpectralHilbert::prepare(double sampleRate) {
+    const double rateScale = sampleRate > 0.0 ? sampleRate / 48000.0 : 1.0;
+    const int scaledSize = juce::nextPowerOfTwo(static_cast<int>(std::round((1 << kBaseFFTOrder) * rateScale)));
+    int order = kMinFFTOrder;
+    while ((1 << order) < scaledSize && order < kMaxFFTOrder)
+        ++order;
+
+    fft_ = std::make_unique<juce::dsp::FFT>(order);
+    size_ = 1 << order;
+    mask_ = size_ - 1;
+    hop_ = size_ / kOverlap;
+
+    // Periodic Hann analysis and synthesis: the squared windows at 75% overlap sum to 1.5, folded into synthesis.
+    analysisWindow_.resize(static_cast<size_t>(size_));
+    synthesisWindow_.resize(static_cast<size_t>(size_));
+    const float olaScale = 2.0f / 3.0f;
+    for (int k = 0; k < size_; ++k) {
+        const double phase = juce::MathConstants<double>::twoPi * static_cast<double>(k) / static_cast<double>(size_);
+        const auto hann = static_cast<float>(0.5 - 0.5 * std::cos(phase));
+        analysisWindow_[static_cast<size_t>(k)] = hann;
+        synthesisWindow_[static_cast<size_t>(k)] = hann * olaScale;
+    }
+
+    input_.assign(static_cast<size_t>(size_), 0.0f);
+    accumI_.assign(static_cast<size_t>(size_), 0.0f);
+    accumQ_.assign(static_cast<size_t>(size_), 0.0f);
+    fftData_.assign(static_cast<size_t>(2 * size_), 0.0f);
+    spectrum_.assign(static_cast<size_t>(size_), {});
+    frame_.assign(static_cast<size_t>(size_), {});
+    reset();
+}
+
+void SpectralHilbert::reset() noexcept {
+    std::fill(input_.begin(), input_.end(), 0.0f);
+    std::fill(accumI_.begin(), accumI_.end(), 0.0f);
+    std::fill(accumQ_.begin(), accumQ_.end(), 0.0f);
+    writeIndex_ = 0;
+    hopCounter_ = 0;
+}
+
+int SpectralHilbert::getFFTSize() const noexcept {
+    return size_;
+}
+
+int SpectralHilbert::getLatencySamples() const noexcept {
+    return size_ > 0 ? size_ - 1 : 0;
+}
+
+void SpectralHilbert::process(float* iData, float* qData, int numSamples) noexcept {
+    if (fft_ == nullptr) {
+        std::fill(qData, qData + numSamples, 0.0f);
+        return;
+    }
+
+    for (int s = 0; s < numSamples; ++s) {
+        input_[static_cast<size_t>(writeIndex_)] = iData[s];
+
+        if (++hopCounter_ == hop_) {
+            hopCounter_ = 0;
+            processFrame();
+        }
+
+        // The oldest sample in the window is now complete: every frame that overlaps it has been added.
+        const auto oldest = static_cast<size_t>((writeIndex_ + 1) & mask_);
+        iData[s] = accumI_[oldest];
+        qData[s] = accumQ_[oldest];
+        accumI_[oldest] = 0.0f;
+        accumQ_[oldest] = 0.0f;
+
+        writeIndex_ = (writeIndex_ + 1) & mask_;
+    }
+}
+
+void SpectralHilbert::processFrame() noexcept {
+    const int start = (writeIndex_ + 1) & mask_;
+    for (int k = 0; k < size_; ++k)
+        fftData_[static_cast<size_t>(k)] =
+            input_[static_cast<size_t>((start + k) & mask_)] * analysisWindow_[static_cast<size_t>(k)];
+    std::fill(fftData_.begin() + size_, fftData_.end(), 0.0f);
+
+    fft_->performRealOnlyForwardTransform(fftData_.data(), true);
+
+    // One-sided analytic spectrum: X + j(-j sgn(k) X) doubles the positive bins and removes the negative ones,
+    // leaving DC and Nyquist untouched.
+    const int half = size_ / 2;
+    for (int k = 0; k <= half; ++k) {
+        const float gain = (k == 0 || k == half) ? 1.0f : 2.0f;
+        spectrum_[static_cast<size_t>(k)] = {gain * fftData_[static_cast<size_t>(2 * k)],
+                                             gain * fftData_[static_cast<size_t>(2 * k + 1)]};
+    }
+    std::fill(spectrum_.begin() + half + 1, spectrum_.end(), juce::dsp::Complex<float>{});
+
+    fft_->perform(spectrum_.data(), frame_.data(), true);
+
+    for (int k = 0; k < size_; ++k) {
+        const auto index = static_cast<size_t>((start + k) & mask_);
+        const float window = synthesisWindow_[static_cast<size_t>(k)];
+        accumI_[index] += frame_[static_cast<size_t>(k)].real() * window;
+        accumQ_[index] += frame_[static_cast<size_t>(k)].imag() * window;
+    }
+}
+
+} // namespace qbdsp
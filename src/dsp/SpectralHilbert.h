@@ -0,0 +1,56 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <memory>
+#include <vector>
+
+namespace qbdsp {
+
+// STFT-domain Hilbert transformer.
+//
+// Every hop, the last fftSize input samples are Hann-windowed and transformed with one real FFT. The Hilbert
+// transform there is just -j on the positive bins (+j on the negative ones), so I + jQ is the inverse of the
+// one-sided analytic spectrum and both outputs come out of a single complex inverse FFT. Hann synthesis at 75%
+// overlap reconstructs the input exactly, and the outputs are delayed by fftSize - 1 samples.
+class SpectralHilbert final {
+  public:
+    // 4096 points at 48 kHz (about 11.7 Hz bins, latency matching the FIR mode), scaled with sample rate up to
+    // 16384 points.
+    static constexpr int kBaseFFTOrder = 12;
+    static constexpr int kMinFFTOrder = 11;
+    static constexpr int kMaxFFTOrder = 14;
+    static constexpr int kOverlap = 4;
+
+    void prepare(double sampleRate);
+    void reset() noexcept;
+
+    int getFFTSize() const noexcept;
+    int getLatencySamples() const noexcept;
+
+    // In-place: iData is replaced by the delayed input, qData receives the quadrature signal.
+    void process(float* iData, float* qData, int numSamples) noexcept;
+
+  private:
+    void processFrame() noexcept;
+
+    std::unique_ptr<juce::dsp::FFT> fft_;
+    int size_ = 0;
+    int mask_ = 0;
+    int hop_ = 0;
+
+    std::vector<float> analysisWindow_;
+    std::vector<float> synthesisWindow_;
+
+    // Circular buffers indexed by sample time modulo size_.
+    std::vector<float> input_;
+    std::vector<float> accumI_;
+    std::vector<float> accumQ_;
+    int writeIndex_ = 0;
+    int hopCounter_ = 0;
+
+    std::vector<float> fftData_;
+    std::vector<juce::dsp::Complex<float>> spectrum_;
+    std::vector<juce::dsp::Complex<float>> frame_;
+};
+
+} // namespace qbdsp
@@ -1,4 +1,5 @@
 #include "StereoMatrixProcessor.h"
+#include "KernelDispatch.h"
 #include <cmath>
 
 namespace qbdsp {
@@ -7,18 +8,21 @@ void StereoMatrixProcessor::prepare(const juce::dsp::ProcessSpec& spec) {
     spec_ = spec;
 }
 
-void StereoMatrixProcessor::reset() noexcept {}
+void StereoMatrixProcessor::reset() noexcept {
+    hasPreviousGains_ = false;
+}
 
-void StereoMatrixProcessor::process(const juce::AudioBuffer<float>& lowBuffer,
-                                    const juce::AudioBuffer<float>& xHighBuffer,
-                                    const juce::AudioBuffer<float>& iBuffer, const juce::AudioBuffer<float>& qBuffer,
-                                    juce::AudioBuffer<float>& outputBuffer, float widthPercent, float phaseAngleDeg,
-                                    float phaseRotationDeg, bool useFirLinearWidthLaw) const noexcept {
-    const int samples = outputBuffer.getNumSamples();
-    const int numOutChannels = outputBuffer.getNumChannels();
-    if (samples <= 0 || numOutChannels <= 0)
-        return;
+void StereoMatrixProcessor::setProcessingProfile(ProcessingProfile profile) noexcept {
+    profile_ = profile;
+}
+
+ProcessingProfile StereoMatrixProcessor::getProcessingProfile() const noexcept {
+    return profile_;
+}
 
+void StereoMatrixProcessor::computeGains(float widthPercent, float phaseAngleDeg, float phaseRotationDeg,
+                                         bool useFirLinearWidthLaw, float* leftGains, float* rightGains,
+                                         bool* activeInputs) noexcept {
     const float w = juce::jlimit(0.0f, 1.0f, widthPercent * 0.01f);
     const float gmLegacy = std::sqrt(1.0f - w);
     const float gqLegacy = std::sqrt(w);
@@ -29,56 +33,149 @@ void StereoMatrixProcessor::process(const juce::AudioBuffer<float>& lowBuffer,
     const float gmFir = std::cos(firPhase);
     const float gsFir = std::sin(firPhase);
 
-    float angleDiffRad = (phaseAngleDeg - 90.0f) * juce::MathConstants<float>::pi / 180.0f;
-    float theta = angleDiffRad * 0.5f;
-    float cosTheta = std::cos(theta);
-    float sinTheta = std::sin(theta);
-
-    float rotRad = phaseRotationDeg * juce::MathConstants<float>::pi / 180.0f;
-    float cosRot = std::cos(rotRad);
-    float sinRot = std::sin(rotRad);
+    // phaseAngleDeg offsets the quadrature relationship around 90 deg by mixing Lh and Rh.
+    const float angleDiffRad = (phaseAngleDeg - 90.0f) * juce::MathConstants<float>::pi / 180.0f;
+    const float theta = angleDiffRad * 0.5f;
+    const float cosTheta = std::cos(theta);
+    const float sinTheta = std::sin(theta);
+
+    const float rotRad = phaseRotationDeg * juce::MathConstants<float>::pi / 180.0f;
+    const float cosRot = std::cos(rotRad);
+    const float sinRot = std::sin(rotRad);
+
+    // The whole chain (width law, angle mix, rotation, low sum) is linear in the four inputs, so it folds into one
+    // gain per input and output channel:
+    //   lh = aI*I + aQ*Q + aX*xHigh,  rh = bI*I + bQ*Q + bX*xHigh
+    //   L = lh*cosTheta - rh*sinTheta,  R = rh*cosTheta + lh*sinTheta
+    //   outL = low + L*cosRot - R*sinRot,  outR = low + L*sinRot + R*cosRot
+    // The low band joins after the rotation: rotating it would pan mono bass at 45 degrees and flip it out of phase
+    // at 90.
+    float lhGains[3] = {0.0f, 0.0f, 0.0f}; // I, Q, xHigh
+    float rhGains[3] = {0.0f, 0.0f, 0.0f};
+    if (useFirLinearWidthLaw) {
+        lhGains[0] = gmFir;
+        lhGains[1] = gsFir;
+        rhGains[0] = gmFir;
+        rhGains[1] = -gsFir;
+    } else {
+        lhGains[0] = gCompLegacy * gqLegacy;
+        lhGains[2] = gCompLegacy * gmLegacy;
+        rhGains[1] = gCompLegacy * gqLegacy;
+        rhGains[2] = gCompLegacy * gmLegacy;
+    }
 
-    const float* lowData = lowBuffer.getReadPointer(0);
-    const float* xHighData = xHighBuffer.getReadPointer(0);
-    const float* iData = iBuffer.getReadPointer(0);
-    const float* qData = qBuffer.getReadPointer(0);
+    leftGains[0] = 1.0f;
+    rightGains[0] = 1.0f;
+    for (int k = 1; k < kNumInputs; ++k) {
+        const float lh = lhGains[k - 1];
+        const float rh = rhGains[k - 1];
+        const float mixL = lh * cosTheta - rh * sinTheta;
+        const float mixR = rh * cosTheta + lh * sinTheta;
 
-    float* left = outputBuffer.getWritePointer(0);
-    float* right = numOutChannels > 1 ? outputBuffer.getWritePointer(1) : nullptr;
+        leftGains[k] = mixL * cosRot - mixR * sinRot;
+        rightGains[k] = mixL * sinRot + mixR * cosRot;
+    }
 
-    for (int s = 0; s < samples; ++s) {
-        float low = lowBuffer.getNumChannels() > 0 ? lowData[s] : 0.0f;
-        const float I = iBuffer.getNumChannels() > 0 ? iData[s] : 0.0f;
-        const float Q = qBuffer.getNumChannels() > 0 ? qData[s] : 0.0f;
-        const float xHigh = xHighBuffer.getNumChannels() > 0 ? xHighData[s] : 0.0f;
-
-        float lh = 0.0f;
-        float rh = 0.0f;
-
-        if (useFirLinearWidthLaw) {
-            lh = gmFir * I + gsFir * Q;
-            rh = gmFir * I - gsFir * Q;
-        } else {
-            lh = gCompLegacy * (gmLegacy * xHigh + gqLegacy * I);
-            rh = gCompLegacy * (gmLegacy * xHigh + gqLegacy * Q);
-        }
+    // The angle mix and rotation are rotations, so an input is silent exactly when the width law zeroes both lh and
+    // rh for it. Deciding that here avoids comparing the rotated gains against zero.
+    if (activeInputs != nullptr) {
+        const bool widened = w > 0.0f;
+        activeInputs[0] = true;
+        activeInputs[1] = useFirLinearWidthLaw || widened;
+        activeInputs[kQuadratureInput] = widened;
+        activeInputs[3] = !useFirLinearWidthLaw && w < 1.0f;
+    }
+}
 
-        // Advanced transforms requested AFTER this stage
-        // "phaseAngleDeg offsets quadrature relationship around 90 deg."
-        // Meaning we mix Lh and Rh together to adjust width/phase
-        float Lh_mix = lh * cosTheta - rh * sinTheta;
-        float Rh_mix = rh * cosTheta + lh * sinTheta;
+bool StereoMatrixProcessor::usesQuadrature(float widthPercent, float phaseAngleDeg, float phaseRotationDeg,
+                                           bool useFirLinearWidthLaw) const noexcept {
+    float leftGains[kNumInputs] = {};
+    float rightGains[kNumInputs] = {};
+    bool activeInputs[kNumInputs] = {};
+    computeGains(widthPercent, phaseAngleDeg, phaseRotationDeg, useFirLinearWidthLaw, leftGains, rightGains,
+                 activeInputs);
+    if (activeInputs[kQuadratureInput])
+        return true;
+
+    // A Render ramp still fades the previous block's Q gains out across this block.
+    return profile_ == ProcessingProfile::Render && hasPreviousGains_ && previousActiveInputs_[kQuadratureInput];
+}
 
-        float L = low + Lh_mix;
-        float R = low + Rh_mix;
+void StereoMatrixProcessor::process(const juce::AudioBuffer<float>& lowBuffer,
+                                    const juce::AudioBuffer<float>& xHighBuffer,
+                                    const juce::AudioBuffer<float>& iBuffer, const juce::AudioBuffer<float>& qBuffer,
+                                    juce::AudioBuffer<float>& outputBuffer, float widthPercent, float phaseAngleDeg,
+                                    float phaseRotationDeg, bool useFirLinearWidthLaw) noexcept {
+    const int samples = outputBuffer.getNumSamples();
+    const int numOutChannels = outputBuffer.getNumChannels();
+    if (samples <= 0 || numOutChannels <= 0)
+        return;
 
-        // Apply rotation to final stereo vector
-        float L_rot = L * cosRot - R * sinRot;
-        float R_rot = L * sinRot + R * cosRot;
+    float targetLeftGains[kNumInputs] = {};
+    float targetRightGains[kNumInputs] = {};
+    bool activeInputs[kNumInputs] = {};
+    computeGains(widthPercent, phaseAngleDeg, phaseRotationDeg, useFirLinearWidthLaw, targetLeftGains,
+                 targetRightGains, activeInputs);
+
+    const juce::AudioBuffer<float>* buffers[kNumInputs] = {&lowBuffer, &iBuffer, &qBuffer, &xHighBuffer};
+    const float* inputs[kNumInputs] = {};
+    float leftGains[kNumInputs] = {};
+    float rightGains[kNumInputs] = {};
+    float startLeftGains[kNumInputs] = {};
+    float startRightGains[kNumInputs] = {};
+    bool gainsChanged = false;
+    int numInputs = 0;
+    for (int k = 0; k < kNumInputs; ++k) {
+        const float gainL = targetLeftGains[k];
+        const float gainR = targetRightGains[k];
+        const float startL = hasPreviousGains_ ? previousLeftGains_[k] : gainL;
+        const float startR = hasPreviousGains_ ? previousRightGains_[k] : gainR;
+        const bool wasActive = hasPreviousGains_ ? previousActiveInputs_[k] : activeInputs[k];
+        previousLeftGains_[k] = gainL;
+        previousRightGains_[k] = gainR;
+        previousActiveInputs_[k] = activeInputs[k];
+
+        // Inputs that contribute nothing to either channel (at width extremes) are left out of the mix.
+        const bool silent = !activeInputs[k] && (profile_ != ProcessingProfile::Render || !wasActive);
+        if (buffers[k]->getNumChannels() <= 0 || silent)
+            continue;
+
+        startLeftGains[numInputs] = startL;
+        startRightGains[numInputs] = startR;
+        gainsChanged |= std::abs(gainL - startL) > kGainChangeThreshold ||
+                        std::abs(gainR - startR) > kGainChangeThreshold;
+
+        inputs[numInputs] = buffers[k]->getReadPointer(0);
+        leftGains[numInputs] = gainL;
+        rightGains[numInputs] = gainR;
+        ++numInputs;
+    }
+    hasPreviousGains_ = true;
 
-        left[s] = L_rot;
+    float* left = outputBuffer.getWritePointer(0);
+    float* right = numOutChannels > 1 ? outputBuffer.getWritePointer(1) : nullptr;
+    if (numInputs > 0 && profile_ == ProcessingProfile::Render && gainsChanged) {
+        // The ramp reaches the new gains on the last sample of the block.
+        const double step = 1.0 / static_cast<double>(samples);
+        for (int s = 0; s < samples; ++s) {
+            const double t = static_cast<double>(s + 1) * step;
+            double sumL = 0.0;
+            double sumR = 0.0;
+            for (int k = 0; k < numInputs; ++k) {
+                const double x = static_cast<double>(inputs[k][s]);
+                sumL += x * (startLeftGains[k] + (leftGains[k] - startLeftGains[k]) * t);
+                sumR += x * (startRightGains[k] + (rightGains[k] - startRightGains[k]) * t);
+            }
+            left[s] = static_cast<float>(sumL);
+            if (right != nullptr)
+                right[s] = static_cast<float>(sumR);
+        }
+    } else if (numInputs > 0) {
+        KernelDispatch::get().mixStereo(inputs, numInputs, leftGains, rightGains, left, right, samples);
+    } else {
+        juce::FloatVectorOperations::clear(left, samples);
         if (right != nullptr)
-            right[s] = R_rot;
+            juce::FloatVectorOperations::clear(right, samples);
     }
 
     for (int ch = 2; ch < numOutChannels; ++ch) {
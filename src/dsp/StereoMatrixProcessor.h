@@ -1,5 +1,6 @@
 #pragma once
 
+#include "EngineParams.h"
 #include <juce_dsp/juce_dsp.h>
 
 namespace qbdsp {
@@ -8,13 +9,45 @@ class StereoMatrixProcessor final {
   public:
     void prepare(const juce::dsp::ProcessSpec& spec);
     void reset() noexcept;
+
+    // In the Render profile each input's gains ramp per sample from the previous block's values to the new ones, so
+    // automation does not step at block boundaries; Realtime applies the new gains to the whole block.
+    void setProcessingProfile(ProcessingProfile profile) noexcept;
+    ProcessingProfile getProcessingProfile() const noexcept;
+
+    // Folds the width law, angle mix and rotation into one gain per input (low, I, Q, xHigh) and output channel;
+    // leftGains and rightGains receive four values each. The low band is never rotated, so it stays mono.
+    // activeInputs, when given, receives four flags that are false where the width law zeroes an input on both
+    // channels (Q at width 0, I at width 0 and xHigh at width 100 with the legacy law, xHigh always with the FIR law).
+    static void computeGains(float widthPercent, float phaseAngleDeg, float phaseRotationDeg,
+                             bool useFirLinearWidthLaw, float* leftGains, float* rightGains,
+                             bool* activeInputs = nullptr) noexcept;
+
+    // False when the given parameters give the Q input zero gain on both channels for the whole next block (e.g.
+    // width 0 with the FIR law), so the caller can skip computing it.
+    bool usesQuadrature(float widthPercent, float phaseAngleDeg, float phaseRotationDeg,
+                        bool useFirLinearWidthLaw) const noexcept;
+
     void process(const juce::AudioBuffer<float>& lowBuffer, const juce::AudioBuffer<float>& xHighBuffer,
                  const juce::AudioBuffer<float>& iBuffer, const juce::AudioBuffer<float>& qBuffer,
                  juce::AudioBuffer<float>& outputBuffer, float widthPercent, float phaseAngleDeg,
-                 float phaseRotationDeg, bool useFirLinearWidthLaw) const noexcept;
+                 float phaseRotationDeg, bool useFirLinearWidthLaw) noexcept;
 
   private:
+    static constexpr int kNumInputs = 4;
+    static constexpr int kQuadratureInput = 2;
+
     juce::dsp::ProcessSpec spec_{};
+    ProcessingProfile profile_ = ProcessingProfile::Realtime;
+
+    // Below this a gain change is inaudible (-120 dB), so Render applies it without a ramp.
+    static constexpr float kGainChangeThreshold = 1.0e-6f;
+
+    // Gains applied at the end of the previous block, indexed by input (low, I, Q, xHigh).
+    float previousLeftGains_[kNumInputs] = {};
+    float previousRightGains_[kNumInputs] = {};
+    bool previousActiveInputs_[kNumInputs] = {};
+    bool hasPreviousGains_ = false;
 };
 
 } // namespace qbdsp
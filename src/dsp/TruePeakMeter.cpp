@@ -0,0 +1,88 @@
+#include "TruePeakMeter.h"
+#include "FirDesign.h"
+#include "KernelDispatch.h"
+
+namespace qbdsp {
+
+namespace {
+
+constexpr double kStopbandDb = 70.0;
+constexpr float kSilenceDb = -100.0f;
+
+} // namespace
+
+void TruePeakMeter::prepare(double sampleRate) {
+    const double sampleRateSafe = sampleRate > 1.0 ? sampleRate : 48000.0;
+    factor_ = sampleRateSafe <= 48000.0 ? 4 : (sampleRateSafe <= 96000.0 ? 2 : 1);
+    tapsPerPhase_ = factor_ > 1 ? kTapsPerPhase : 1;
+
+    coeffs_.assign(static_cast<size_t>(factor_ * tapsPerPhase_), 0.0f);
+    if (factor_ > 1) {
+        // Odd-length prototype (the last tap of the final phase stays zero) cut off at the original Nyquist.
+        const int numTaps = factor_ * tapsPerPhase_ - 1;
+        std::vector<float> prototype(static_cast<size_t>(numTaps));
+        const double oversampledRate = sampleRateSafe * factor_;
+        FirDesign::designKaiserLowpass(prototype.data(), numTaps, 0.5 * sampleRateSafe, oversampledRate, kStopbandDb);
+        for (int d = 0; d < numTaps; ++d) {
+            const int phase = d % factor_;
+            const int tap = d / factor_;
+            coeffs_[static_cast<size_t>(phase * tapsPerPhase_ + tap)] =
+                prototype[static_cast<size_t>(d)] * static_cast<float>(factor_);
+        }
+    } else {
+        coeffs_[0] = 1.0f;
+    }
+
+    for (auto& channel : history_)
+        channel.assign(static_cast<size_t>(tapsPerPhase_ - 1 + kChunk), 0.0f);
+    reset();
+}
+
+void TruePeakMeter::reset() noexcept {
+    for (auto& channel : history_)
+        std::fill(channel.begin(), channel.end(), 0.0f);
+    historyPos_ = tapsPerPhase_ - 1;
+    peak_ = 0.0f;
+}
+
+void TruePeakMeter::processBlock(const float* left, const float* right, int numSamples) noexcept {
+    if (history_[0].empty())
+        return;
+
+    const auto& kernels = KernelDispatch::get();
+    const int historySize = static_cast<int>(history_[0].size());
+    const float* inputs[2] = {left, right};
+    int done = 0;
+    while (done < numSamples) {
+        if (historyPos_ == historySize) {
+            const int keep = tapsPerPhase_ - 1;
+            for (auto& channel : history_)
+                std::copy(channel.end() - keep, channel.end(), channel.begin());
+            historyPos_ = keep;
+        }
+
+        const int count = juce::jmin(numSamples - done, historySize - historyPos_);
+        for (size_t ch = 0; ch < history_.size(); ++ch) {
+            float* newest = history_[ch].data() + historyPos_;
+            std::copy(inputs[ch] + done, inputs[ch] + done + count, newest);
+            peak_ = juce::jmax(peak_, kernels.interpolatedPeak(coeffs_.data(), factor_, tapsPerPhase_, newest, count));
+        }
+
+        historyPos_ += count;
+        done += count;
+    }
+}
+
+int TruePeakMeter::getOversamplingFactor() const noexcept {
+    return factor_;
+}
+
+float TruePeakMeter::getPeak() const noexcept {
+    return peak_;
+}
+
+float TruePeakMeter::getPeakDb() const noexcept {
+    return juce::Decibels::gainToDecibels(peak_, kSilenceDb);
+}
+
+} // namespace qbdsp
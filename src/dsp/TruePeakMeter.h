@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+namespace qbdsp {
+
+// Stereo true-peak meter after ITU-R BS.1770-4 Annex 2. Each channel is upsampled by a polyphase Kaiser low-pass
+// (4x up to 48 kHz, 2x up to 96 kHz, none above) and the largest absolute interpolated value is held, so peaks
+// between samples that a sample-peak meter misses are caught. Not thread-safe; owned by the analysis worker.
+class TruePeakMeter final {
+  public:
+    static constexpr int kTapsPerPhase = 12;
+    // Samples appended to each channel's history between compactions.
+    static constexpr int kChunk = 1024;
+
+    void prepare(double sampleRate);
+    void reset() noexcept;
+    void processBlock(const float* left, const float* right, int numSamples) noexcept;
+
+    int getOversamplingFactor() const noexcept;
+    // Largest interpolated magnitude on either channel since the last reset (linear, and in dBTP).
+    float getPeak() const noexcept;
+    float getPeakDb() const noexcept;
+
+  private:
+    int factor_ = 1;
+    int tapsPerPhase_ = 1;
+    // Phase-major: phase p holds taps p, p + factor_, p + 2 * factor_ ... of the prototype, scaled by factor_.
+    std::vector<float> coeffs_{1.0f};
+
+    // Per channel, the last tapsPerPhase_ - 1 inputs followed by up to kChunk new ones.
+    std::array<std::vector<float>, 2> history_;
+    int historyPos_ = 0;
+    float peak_ = 0.0f;
+};
+
+} // namespace qbdsp
@@ -0,0 +1,68 @@
+#include "VelvetDecorrelator.h"
+#include <juce_dsp/juce_dsp.h>
+#include <cmath>
+
+namespace qbdsp {
+
+namespace {
+
+// Numerical Recipes LCG, spelled out so the sequence never depends on the standard library.
+std::uint32_t nextRandom(std::uint32_t& state) noexcept {
+    state = state * 1664525u + 1013904223u;
+    return state;
+}
+
+} // namespace
+
+void VelvetDecorrelator::prepare(double sampleRate) {
+    const double sampleRateSafe = sampleRate > 1.0 ? sampleRate : 48000.0;
+    const double gridSamples = sampleRateSafe / kPulsesPerSecond;
+    const int numPulses = static_cast<int>(std::lround(kPulsesPerSecond * kLengthSeconds));
+    const double lengthSamples = kLengthSeconds * sampleRateSafe;
+
+    std::vector<double> gains;
+    taps_.clear();
+    std::uint32_t state = kSeed;
+    double energy = 0.0;
+    for (int m = 0; m < numPulses; ++m) {
+        const double position = static_cast<double>(nextRandom(state) >> 8) / 16777216.0;
+        const int offset = static_cast<int>(std::floor(m * gridSamples + position * (gridSamples - 1.0)));
+        const double sign = (nextRandom(state) >> 31) != 0 ? 1.0 : -1.0;
+        const double gain = sign * std::pow(10.0, -kDecayDb / 20.0 * static_cast<double>(offset) / lengthSamples);
+        taps_.push_back({offset, 0.0f});
+        gains.push_back(gain);
+        energy += gain * gain;
+    }
+
+    const double norm = 1.0 / std::sqrt(energy);
+    for (size_t t = 0; t < taps_.size(); ++t)
+        taps_[t].gain = static_cast<float>(gains[t] * norm);
+
+    history_.prepare(taps_.empty() ? 0 : taps_.back().offset);
+}
+
+void VelvetDecorrelator::reset() noexcept {
+    history_.reset();
+}
+
+void VelvetDecorrelator::process(const float* input, float* output, int numSamples) noexcept {
+    for (int start = 0; start < numSamples; start += SampleHistory::kChunk) {
+        const int count = juce::jmin(SampleHistory::kChunk, numSamples - start);
+        const float* first = history_.push(input + start, count);
+        float* out = output + start;
+        juce::FloatVectorOperations::clear(out, count);
+        for (const auto& tap : taps_)
+            juce::FloatVectorOperations::addWithMultiply(out, first - tap.offset, tap.gain, count);
+    }
+}
+
+void VelvetDecorrelator::skip(const float* input, int numSamples) noexcept {
+    for (int start = 0; start < numSamples; start += SampleHistory::kChunk)
+        history_.push(input + start, juce::jmin(SampleHistory::kChunk, numSamples - start));
+}
+
+const std::vector<VelvetDecorrelator::Tap>& VelvetDecorrelator::getTaps() const noexcept {
+    return taps_;
+}
+
+} // namespace qbdsp
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "SampleHistory.h"
+#include <cstdint>
+#include <vector>
+
+namespace qbdsp {
+
+// Sparse decorrelation filter for Mode::Velvet. The kernel is velvet noise: one +/-1 pulse at a random position in
+// each grid cell of fs / kPulsesPerSecond samples, with an exponential decay so it sounds like a short diffuse tail
+// rather than an echo. The sequence is generated from a fixed seed and the pulse positions scale with the sample
+// rate, so every instance, rate and session gets the same filter. Feeding x and the filtered v * x to the stereo
+// matrix's linear-phase width law gives the complementary pair L = c x + s v * x, R = c x - s v * x: the mono fold
+// is exactly c x, and with a unit-energy kernel the channels decorrelate towards cos(2 phi) across the band above a
+// couple of hundred hertz (below that the 30 ms kernel is too short to average out).
+class VelvetDecorrelator final {
+  public:
+    static constexpr double kPulsesPerSecond = 1500.0;
+    static constexpr double kLengthSeconds = 0.03;
+    // Level of the last pulse relative to the first.
+    static constexpr double kDecayDb = 20.0;
+    // Chosen for the flattest L/R balance and lowest correlation across octave bands from 125 Hz.
+    static constexpr std::uint32_t kSeed = 17045u;
+
+    struct Tap {
+        int offset = 0;
+        float gain = 0.0f;
+    };
+
+    // Regenerates the taps (about 45) for sampleRate.
+    void prepare(double sampleRate);
+    void reset() noexcept;
+
+    // Writes the decorrelated input to output; the two must not overlap. Adds no latency.
+    void process(const float* input, float* output, int numSamples) noexcept;
+    // Keeps the history filling without filtering, so output is exact again from the next process() call.
+    void skip(const float* input, int numSamples) noexcept;
+
+    const std::vector<Tap>& getTaps() const noexcept;
+
+  private:
+    std::vector<Tap> taps_;
+    SampleHistory history_;
+};
+
+} // namespace qbdsp
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+// Plain C++ on purpose: the per-ISA translation units that fill these tables are compiled with extra target flags,
+// so they must not pull in JUCE (or any other) inline code that could be merged across ISAs by the linker.
+
+namespace qbdsp::simd {
+
+// Partial sums kept by the deterministic reductions, whatever the register width (the widest table holds 16 floats).
+constexpr int kDeterministicLanes = 16;
+
+// Hot DSP inner loops, one implementation per instruction set. All pointers may be unaligned.
+struct KernelTable {
+    const char* name;
+
+    // sum(a[k] * b[k]) for k in [0, n). The fast tables sum in whatever order suits the register width; the
+    // deterministic ones accumulate kDeterministicLanes partial sums (lane i takes k = i, i + 16, ...) and combine them
+    // by a fixed pairwise tree, so every deterministic table returns the same bits. The same applies to dotStride2
+    // and accumulateCorrelation.
+    float (*dot)(const float* a, const float* b, int n);
+
+    // sum(a[k] * b[2k]) for k in [0, n); reads b[0 .. 2n - 2] only.
+    float (*dotStride2)(const float* a, const float* b, int n);
+
+    // out[s] = sum(coeffs[j] * newest[s - 2j]) for s in [0, numOutputs). Vectorised across outputs with the
+    // taps accumulated in order and without FMA, so every table produces bit-identical results.
+    void (*convolveStride2)(const float* coeffs, int numCoeffs, const float* newest, float* out, int numOutputs);
+
+    // convolveStride2 for an antisymmetric kernel stored as its first half in scaled 16-bit form:
+    // out[s] = scale * sum(coeffs[j] * (newest[s - 2j] - oldest[s + 2j])) for s in [0, numOutputs). Same ordering
+    // and bit-identity guarantees as convolveStride2.
+    void (*convolveStride2Folded)(const std::int16_t* coeffs, int numCoeffs, float scale, const float* newest,
+                                  const float* oldest, float* out, int numOutputs);
+
+    // convolveStride2 for numStreams independent histories stored in structure-of-arrays rows of rowStride floats
+    // (row t holds every stream's sample t): out[t * rowStride + k] = sum(coeffs[j] * newest[(t - 2j) * rowStride +
+    // k]) for t in [0, numOutputs) and k in [0, numStreams). Vectorised across streams and blocked over outputs, with
+    // each stream's taps accumulated in the same order as convolveStride2, so a stream's output is bit-identical to
+    // convolving it on its own.
+    void (*convolveStride2Batch)(const float* coeffs, int numCoeffs, const float* newest, int rowStride, float* out,
+                                 int numStreams, int numOutputs);
+
+    // left[s] = sum(leftGains[k] * inputs[k][s]), right likewise (right may be null).
+    void (*mixStereo)(const float* const* inputs, int numInputs, const float* leftGains, const float* rightGains,
+                      float* left, float* right, int n);
+
+    // out[s] = sum(gain * inputs[k][s]), accumulated like mixStereo. Returns false when any input sample is NaN or
+    // infinite (the sum is then too), so a downmix doubles as a scan of its inputs.
+    bool (*downmix)(const float* const* inputs, int numInputs, float gain, float* out, int n);
+
+    // Exponentially decayed sums[0..2] += {l * r, l * l, r * r} with sums *= decay after every sample.
+    void (*accumulateCorrelation)(const float* left, const float* right, int n, float decay, float* sums);
+
+    // max |sum(coeffs[p * tapsPerPhase + j] * newest[s - j])| over s in [0, n), p in [0, numPhases) and j in
+    // [0, tapsPerPhase): the peak of a polyphase-interpolated signal. Reads newest[1 - tapsPerPhase .. n - 1]. Each
+    // output accumulates its taps in order without FMA, so every table returns the same value.
+    float (*interpolatedPeak)(const float* coeffs, int numPhases, int tapsPerPhase, const float* newest, int n);
+
+    // True when no channels[c][k] for c in [0, numChannels) and k in [0, n) is NaN or infinite. Exact in every
+    // table. Scanning every channel in one call shares the accumulators and the final reduction.
+    bool (*allFinite)(const float* const* channels, int numChannels, int n);
+};
+
+// With deterministic set, the reductions use the fixed lane order described above; everything else is shared.
+const KernelTable& getScalarKernels(bool deterministic = false) noexcept;
+
+// These return nullptr when the ISA was not compiled into this binary (e.g. AVX2 on ARM).
+const KernelTable* getSSE2Kernels(bool deterministic = false) noexcept;
+const KernelTable* getAVX2Kernels(bool deterministic = false) noexcept;
+const KernelTable* getAVX512Kernels(bool deterministic = false) noexcept;
+const KernelTable* getNEONKernels(bool deterministic = false) noexcept;
+
+} // namespace qbdsp::simd
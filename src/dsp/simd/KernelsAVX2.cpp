@@ -0,0 +1,60 @@
+#include "KernelsImpl.h"
+
+// Built with AVX2 code generation enabled (see CMakeLists.txt); only reached after a runtime CPU check.
+#if defined(__AVX2__)
+#define QUADRABASS_HAS_AVX2_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace qbdsp::simd {
+
+#if defined(QUADRABASS_HAS_AVX2_KERNELS)
+
+namespace {
+
+struct AVX2Traits {
+    using Reg = __m256;
+    static constexpr int kWidth = 8;
+
+    static Reg zero() { return _mm256_setzero_ps(); }
+    static Reg set1(float x) { return _mm256_set1_ps(x); }
+    static Reg load(const float* p) { return _mm256_loadu_ps(p); }
+    static Reg loadEven(const float* p) {
+        // [p0 p2 p8 p10 | p4 p6 p12 p14] -> [p0 p2 p4 p6 p8 p10 p12 p14]
+        const Reg evens = _mm256_shuffle_ps(_mm256_loadu_ps(p), _mm256_loadu_ps(p + 8), _MM_SHUFFLE(2, 0, 2, 0));
+        return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(evens), _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    static void store(float* p, Reg v) { _mm256_storeu_ps(p, v); }
+    static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+    static Reg sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+    static float hsum(Reg v) {
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        return _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1))));
+    }
+    static float hmax(Reg v) {
+        __m128 peak = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        peak = _mm_max_ps(peak, _mm_movehl_ps(peak, peak));
+        return _mm_cvtss_f32(_mm_max_ss(peak, _mm_shuffle_ps(peak, peak, _MM_SHUFFLE(1, 1, 1, 1))));
+    }
+};
+
+} // namespace
+
+const KernelTable* getAVX2Kernels(bool deterministic) noexcept {
+    static const KernelTable fast = detail::KernelsImpl<AVX2Traits>::makeTable("avx2", false);
+    static const KernelTable fixedOrder = detail::KernelsImpl<AVX2Traits>::makeTable("avx2", true);
+    return deterministic ? &fixedOrder : &fast;
+}
+
+#else
+
+const KernelTable* getAVX2Kernels(bool) noexcept {
+    return nullptr;
+}
+
+#endif
+
+} // namespace qbdsp::simd
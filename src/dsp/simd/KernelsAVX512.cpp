@@ -0,0 +1,62 @@
+#include "KernelsImpl.h"
+
+// Built with AVX-512F code generation enabled (see CMakeLists.txt); only reached after a runtime CPU check.
+#if defined(__AVX512F__)
+#define QUADRABASS_HAS_AVX512_KERNELS 1
+// GCC 12's AVX-512 intrinsics (_mm512_max_ps, _mm512_reduce_add_ps, ...) pass _mm512_undefined_ps() as the unused
+// merge source, which is a self-initialised local, so every inlined use warns at -O2. The warnings point into the
+// header, so silencing them here leaves the rest of this file checked.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+namespace qbdsp::simd {
+
+#if defined(QUADRABASS_HAS_AVX512_KERNELS)
+
+namespace {
+
+struct AVX512Traits {
+    using Reg = __m512;
+    static constexpr int kWidth = 16;
+
+    static Reg zero() { return _mm512_setzero_ps(); }
+    static Reg set1(float x) { return _mm512_set1_ps(x); }
+    static Reg load(const float* p) { return _mm512_loadu_ps(p); }
+    static Reg loadEven(const float* p) {
+        const __m512i evens = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+        return _mm512_permutex2var_ps(_mm512_loadu_ps(p), evens, _mm512_loadu_ps(p + 16));
+    }
+    static void store(float* p, Reg v) { _mm512_storeu_ps(p, v); }
+    static Reg add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+    static Reg sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm512_max_ps(a, b); }
+    static float hsum(Reg v) { return _mm512_reduce_add_ps(v); }
+    static float hmax(Reg v) { return _mm512_reduce_max_ps(v); }
+};
+
+} // namespace
+
+const KernelTable* getAVX512Kernels(bool deterministic) noexcept {
+    static const KernelTable fast = detail::KernelsImpl<AVX512Traits>::makeTable("avx512", false);
+    static const KernelTable fixedOrder = detail::KernelsImpl<AVX512Traits>::makeTable("avx512", true);
+    return deterministic ? &fixedOrder : &fast;
+}
+
+#else
+
+const KernelTable* getAVX512Kernels(bool) noexcept {
+    return nullptr;
+}
+
+#endif
+
+} // namespace qbdsp::simd
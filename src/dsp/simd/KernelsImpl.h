@@ -0,0 +1,472 @@
+#pragma once
+
+// Generic kernel bodies, instantiated by each Kernels*.cpp with its own vector traits V:
+//   V::Reg, V::kWidth, zero(), set1(x), load(p), loadEven(p) (p[0], p[2], ...), store(p, v), add(a, b),
+//   sub(a, b), mul(a, b), max(a, b), hsum(v), hmax(v).
+// Only include this from the per-ISA translation units. Each one defines its traits in an anonymous namespace, so
+// every instantiation has internal linkage and cannot be merged with another ISA's. For the same reason the bodies
+// call no inline library templates (std::max, std::abs, ...): those would be compiled with each TU's -m flags and
+// the linker would keep an arbitrary one. Scalar tails use the members below instead.
+
+#include "KernelTable.h"
+#include <cstddef>
+
+namespace qbdsp::simd::detail {
+
+template <typename V> struct KernelsImpl {
+    static float maxScalar(float a, float b) { return a < b ? b : a; }
+    static float absScalar(float x) { return x < 0.0f ? -x : x; }
+
+    static float dot(const float* a, const float* b, int n) {
+        auto acc0 = V::zero();
+        auto acc1 = V::zero();
+        int k = 0;
+        for (; k + 2 * V::kWidth <= n; k += 2 * V::kWidth) {
+            acc0 = V::add(acc0, V::mul(V::load(a + k), V::load(b + k)));
+            acc1 = V::add(acc1, V::mul(V::load(a + k + V::kWidth), V::load(b + k + V::kWidth)));
+        }
+        for (; k + V::kWidth <= n; k += V::kWidth)
+            acc0 = V::add(acc0, V::mul(V::load(a + k), V::load(b + k)));
+
+        float sum = V::hsum(V::add(acc0, acc1));
+        for (; k < n; ++k)
+            sum += a[k] * b[k];
+        return sum;
+    }
+
+    static float dotStride2(const float* a, const float* b, int n) {
+        auto acc = V::zero();
+        int k = 0;
+        // loadEven touches one float past the last even element, so stop a vector early.
+        for (; k + V::kWidth < n; k += V::kWidth)
+            acc = V::add(acc, V::mul(V::load(a + k), V::loadEven(b + 2 * k)));
+
+        float sum = V::hsum(acc);
+        for (; k < n; ++k)
+            sum += a[k] * b[2 * k];
+        return sum;
+    }
+
+    static void convolveStride2(const float* coeffs, int numCoeffs, const float* newest, float* out, int numOutputs) {
+        constexpr int w = V::kWidth;
+        int s = 0;
+        for (; s + 4 * w <= numOutputs; s += 4 * w) {
+            auto acc0 = V::zero();
+            auto acc1 = V::zero();
+            auto acc2 = V::zero();
+            auto acc3 = V::zero();
+            const float* x = newest + s;
+            for (int j = 0; j < numCoeffs; ++j, x -= 2) {
+                const auto c = V::set1(coeffs[j]);
+                acc0 = V::add(acc0, V::mul(c, V::load(x)));
+                acc1 = V::add(acc1, V::mul(c, V::load(x + w)));
+                acc2 = V::add(acc2, V::mul(c, V::load(x + 2 * w)));
+                acc3 = V::add(acc3, V::mul(c, V::load(x + 3 * w)));
+            }
+            V::store(out + s, acc0);
+            V::store(out + s + w, acc1);
+            V::store(out + s + 2 * w, acc2);
+            V::store(out + s + 3 * w, acc3);
+        }
+        for (; s + w <= numOutputs; s += w) {
+            auto acc = V::zero();
+            const float* x = newest + s;
+            for (int j = 0; j < numCoeffs; ++j, x -= 2)
+                acc = V::add(acc, V::mul(V::set1(coeffs[j]), V::load(x)));
+            V::store(out + s, acc);
+        }
+        for (; s < numOutputs; ++s) {
+            float q = 0.0f;
+            const float* x = newest + s;
+            for (int j = 0; j < numCoeffs; ++j, x -= 2) {
+                const float product = coeffs[j] * *x;
+                q += product;
+            }
+            out[s] = q;
+        }
+    }
+
+    static void convolveStride2Folded(const std::int16_t* coeffs, int numCoeffs, float scale, const float* newest,
+                                      const float* oldest, float* out, int numOutputs) {
+        constexpr int w = V::kWidth;
+        const auto gain = V::set1(scale);
+        int s = 0;
+        for (; s + 4 * w <= numOutputs; s += 4 * w) {
+            auto acc0 = V::zero();
+            auto acc1 = V::zero();
+            auto acc2 = V::zero();
+            auto acc3 = V::zero();
+            const float* x = newest + s;
+            const float* y = oldest + s;
+            for (int j = 0; j < numCoeffs; ++j, x -= 2, y += 2) {
+                const auto c = V::set1(static_cast<float>(coeffs[j]));
+                acc0 = V::add(acc0, V::mul(c, V::sub(V::load(x), V::load(y))));
+                acc1 = V::add(acc1, V::mul(c, V::sub(V::load(x + w), V::load(y + w))));
+                acc2 = V::add(acc2, V::mul(c, V::sub(V::load(x + 2 * w), V::load(y + 2 * w))));
+                acc3 = V::add(acc3, V::mul(c, V::sub(V::load(x + 3 * w), V::load(y + 3 * w))));
+            }
+            V::store(out + s, V::mul(acc0, gain));
+            V::store(out + s + w, V::mul(acc1, gain));
+            V::store(out + s + 2 * w, V::mul(acc2, gain));
+            V::store(out + s + 3 * w, V::mul(acc3, gain));
+        }
+        for (; s + w <= numOutputs; s += w) {
+            auto acc = V::zero();
+            const float* x = newest + s;
+            const float* y = oldest + s;
+            for (int j = 0; j < numCoeffs; ++j, x -= 2, y += 2)
+                acc = V::add(acc, V::mul(V::set1(static_cast<float>(coeffs[j])), V::sub(V::load(x), V::load(y))));
+            V::store(out + s, V::mul(acc, gain));
+        }
+        for (; s < numOutputs; ++s) {
+            float q = 0.0f;
+            const float* x = newest + s;
+            const float* y = oldest + s;
+            for (int j = 0; j < numCoeffs; ++j, x -= 2, y += 2) {
+                const float difference = *x - *y;
+                const float product = static_cast<float>(coeffs[j]) * difference;
+                q += product;
+            }
+            out[s] = q * scale;
+        }
+    }
+
+    static void convolveStride2Batch(const float* coeffs, int numCoeffs, const float* newest, int rowStride,
+                                     float* out, int numStreams, int numOutputs) {
+        constexpr int w = V::kWidth;
+        const std::ptrdiff_t row = rowStride;
+        const std::ptrdiff_t tapStep = 2 * row;
+        int k = 0;
+        for (; k + w <= numStreams; k += w) {
+            // Eight consecutive outputs share most of their input rows, so each row is fetched once per pass.
+            int t = 0;
+            for (; t + 8 <= numOutputs; t += 8) {
+                auto acc0 = V::zero();
+                auto acc1 = V::zero();
+                auto acc2 = V::zero();
+                auto acc3 = V::zero();
+                auto acc4 = V::zero();
+                auto acc5 = V::zero();
+                auto acc6 = V::zero();
+                auto acc7 = V::zero();
+                const float* x = newest + t * row + k;
+                for (int j = 0; j < numCoeffs; ++j, x -= tapStep) {
+                    const auto c = V::set1(coeffs[j]);
+                    acc0 = V::add(acc0, V::mul(c, V::load(x)));
+                    acc1 = V::add(acc1, V::mul(c, V::load(x + row)));
+                    acc2 = V::add(acc2, V::mul(c, V::load(x + 2 * row)));
+                    acc3 = V::add(acc3, V::mul(c, V::load(x + 3 * row)));
+                    acc4 = V::add(acc4, V::mul(c, V::load(x + 4 * row)));
+                    acc5 = V::add(acc5, V::mul(c, V::load(x + 5 * row)));
+                    acc6 = V::add(acc6, V::mul(c, V::load(x + 6 * row)));
+                    acc7 = V::add(acc7, V::mul(c, V::load(x + 7 * row)));
+                }
+                float* o = out + t * row + k;
+                V::store(o, acc0);
+                V::store(o + row, acc1);
+                V::store(o + 2 * row, acc2);
+                V::store(o + 3 * row, acc3);
+                V::store(o + 4 * row, acc4);
+                V::store(o + 5 * row, acc5);
+                V::store(o + 6 * row, acc6);
+                V::store(o + 7 * row, acc7);
+            }
+            for (; t < numOutputs; ++t) {
+                auto acc = V::zero();
+                const float* x = newest + t * row + k;
+                for (int j = 0; j < numCoeffs; ++j, x -= tapStep)
+                    acc = V::add(acc, V::mul(V::set1(coeffs[j]), V::load(x)));
+                V::store(out + t * row + k, acc);
+            }
+        }
+        for (; k < numStreams; ++k) {
+            for (int t = 0; t < numOutputs; ++t) {
+                float q = 0.0f;
+                const float* x = newest + t * row + k;
+                for (int j = 0; j < numCoeffs; ++j, x -= tapStep) {
+                    const float product = coeffs[j] * *x;
+                    q += product;
+                }
+                out[t * row + k] = q;
+            }
+        }
+    }
+
+    static void mixStereo(const float* const* inputs, int numInputs, const float* leftGains, const float* rightGains,
+                          float* left, float* right, int n) {
+        int s = 0;
+        for (; s + V::kWidth <= n; s += V::kWidth) {
+            auto l = V::zero();
+            auto r = V::zero();
+            for (int k = 0; k < numInputs; ++k) {
+                const auto x = V::load(inputs[k] + s);
+                l = V::add(l, V::mul(V::set1(leftGains[k]), x));
+                r = V::add(r, V::mul(V::set1(rightGains[k]), x));
+            }
+            V::store(left + s, l);
+            if (right != nullptr)
+                V::store(right + s, r);
+        }
+        for (; s < n; ++s) {
+            float l = 0.0f;
+            float r = 0.0f;
+            for (int k = 0; k < numInputs; ++k) {
+                const float x = inputs[k][s];
+                l += leftGains[k] * x;
+                r += rightGains[k] * x;
+            }
+            left[s] = l;
+            if (right != nullptr)
+                right[s] = r;
+        }
+    }
+
+    static bool downmix(const float* const* inputs, int numInputs, float gain, float* out, int n) {
+        // As in allFinite: sum * 0 stays 0 while the sum is finite and turns NaN once any input was NaN or +/-Inf.
+        const auto g = V::set1(gain);
+        const auto zero = V::zero();
+        auto check = V::zero();
+        int s = 0;
+        for (; s + V::kWidth <= n; s += V::kWidth) {
+            auto sum = V::zero();
+            for (int k = 0; k < numInputs; ++k)
+                sum = V::add(sum, V::mul(g, V::load(inputs[k] + s)));
+            V::store(out + s, sum);
+            check = V::add(check, V::mul(sum, zero));
+        }
+
+        float tail = 0.0f;
+        for (; s < n; ++s) {
+            float sum = 0.0f;
+            for (int k = 0; k < numInputs; ++k)
+                sum += gain * inputs[k][s];
+            out[s] = sum;
+            tail += sum * 0.0f;
+        }
+        return V::hsum(check) + tail <= 0.0f;
+    }
+
+    static void accumulateCorrelation(const float* left, const float* right, int n, float decay, float* sums) {
+        constexpr int w = V::kWidth;
+        int s = 0;
+        if (n >= w) {
+            // Within a vector of w samples, sample k is decayed (w - k) times before the block ends, and the
+            // running sums decay w times per block.
+            float weights[static_cast<unsigned>(w)];
+            double power = 1.0;
+            for (int k = w - 1; k >= 0; --k) {
+                power *= static_cast<double>(decay);
+                weights[k] = static_cast<float>(power);
+            }
+            const auto weight = V::load(weights);
+            const auto blockDecay = V::set1(static_cast<float>(power));
+
+            auto lr = V::zero();
+            auto ll = V::zero();
+            auto rr = V::zero();
+            double totalDecay = 1.0;
+            for (; s + w <= n; s += w) {
+                const auto l = V::load(left + s);
+                const auto r = V::load(right + s);
+                lr = V::add(V::mul(lr, blockDecay), V::mul(weight, V::mul(l, r)));
+                ll = V::add(V::mul(ll, blockDecay), V::mul(weight, V::mul(l, l)));
+                rr = V::add(V::mul(rr, blockDecay), V::mul(weight, V::mul(r, r)));
+                totalDecay *= power;
+            }
+
+            const auto carried = static_cast<float>(totalDecay);
+            sums[0] = sums[0] * carried + V::hsum(lr);
+            sums[1] = sums[1] * carried + V::hsum(ll);
+            sums[2] = sums[2] * carried + V::hsum(rr);
+        }
+
+        for (; s < n; ++s) {
+            const float l = left[s];
+            const float r = right[s];
+            sums[0] = (sums[0] + l * r) * decay;
+            sums[1] = (sums[1] + l * l) * decay;
+            sums[2] = (sums[2] + r * r) * decay;
+        }
+    }
+
+    static float interpolatedPeak(const float* coeffs, int numPhases, int tapsPerPhase, const float* newest, int n) {
+        constexpr int w = V::kWidth;
+        auto peak = V::zero();
+        int s = 0;
+        for (; s + w <= n; s += w) {
+            const float* phase = coeffs;
+            for (int p = 0; p < numPhases; ++p, phase += tapsPerPhase) {
+                auto acc = V::zero();
+                const float* x = newest + s;
+                for (int j = 0; j < tapsPerPhase; ++j, --x)
+                    acc = V::add(acc, V::mul(V::set1(phase[j]), V::load(x)));
+                peak = V::max(peak, V::max(acc, V::sub(V::zero(), acc)));
+            }
+        }
+
+        float result = V::hmax(peak);
+        for (; s < n; ++s) {
+            const float* phase = coeffs;
+            for (int p = 0; p < numPhases; ++p, phase += tapsPerPhase) {
+                float y = 0.0f;
+                const float* x = newest + s;
+                for (int j = 0; j < tapsPerPhase; ++j, --x) {
+                    const float product = phase[j] * *x;
+                    y += product;
+                }
+                result = maxScalar(result, absScalar(y));
+            }
+        }
+        return result;
+    }
+
+    static bool allFinite(const float* const* channels, int numChannels, int n) {
+        // x * 0 is 0 for every finite x and NaN for NaN or +/-Inf, and a NaN survives any later additions.
+        // Four independent chains, so a typical block costs a few cycles per vector rather than the add latency.
+        constexpr int w = V::kWidth;
+        const auto zero = V::zero();
+        auto acc0 = V::zero();
+        auto acc1 = V::zero();
+        auto acc2 = V::zero();
+        auto acc3 = V::zero();
+        float tail = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const float* x = channels[ch];
+            int k = 0;
+            for (; k + 4 * w <= n; k += 4 * w) {
+                acc0 = V::add(acc0, V::mul(V::load(x + k), zero));
+                acc1 = V::add(acc1, V::mul(V::load(x + k + w), zero));
+                acc2 = V::add(acc2, V::mul(V::load(x + k + 2 * w), zero));
+                acc3 = V::add(acc3, V::mul(V::load(x + k + 3 * w), zero));
+            }
+            for (; k + w <= n; k += w)
+                acc0 = V::add(acc0, V::mul(V::load(x + k), zero));
+            for (; k < n; ++k)
+                tail += x[k] * 0.0f;
+        }
+
+        // The sum is now +/-0 or NaN, and every comparison with NaN is false.
+        return V::hsum(V::add(V::add(acc0, acc1), V::add(acc2, acc3))) + tail <= 0.0f;
+    }
+
+    // Deterministic reductions: kDeterministicLanes partial sums held in kRegs registers, so the lanes (and the
+    // order each one accumulates in) are the same for every register width.
+    static_assert(kDeterministicLanes % V::kWidth == 0, "register width must divide the deterministic lane count");
+    static constexpr int kRegs = kDeterministicLanes / V::kWidth;
+    using Lanes = typename V::Reg[static_cast<size_t>(kRegs)];
+
+    static void zeroLanes(Lanes& acc) {
+        for (auto& reg : acc)
+            reg = V::zero();
+    }
+
+    static float reduceLanes(const Lanes& acc) {
+        float lanes[kDeterministicLanes];
+        for (int r = 0; r < kRegs; ++r)
+            V::store(lanes + r * V::kWidth, acc[r]);
+        for (int half = kDeterministicLanes / 2; half > 0; half /= 2)
+            for (int k = 0; k < half; ++k)
+                lanes[k] += lanes[k + half];
+        return lanes[0];
+    }
+
+    static float dotDeterministic(const float* a, const float* b, int n) {
+        Lanes acc;
+        zeroLanes(acc);
+        int k = 0;
+        for (; k + kDeterministicLanes <= n; k += kDeterministicLanes)
+            for (int r = 0; r < kRegs; ++r) {
+                const int i = k + r * V::kWidth;
+                acc[r] = V::add(acc[r], V::mul(V::load(a + i), V::load(b + i)));
+            }
+
+        float sum = reduceLanes(acc);
+        for (; k < n; ++k)
+            sum += a[k] * b[k];
+        return sum;
+    }
+
+    static float dotStride2Deterministic(const float* a, const float* b, int n) {
+        Lanes acc;
+        zeroLanes(acc);
+        int k = 0;
+        // As in dotStride2, the last loadEven reads one float past its last even element.
+        for (; k + kDeterministicLanes < n; k += kDeterministicLanes)
+            for (int r = 0; r < kRegs; ++r) {
+                const int i = k + r * V::kWidth;
+                acc[r] = V::add(acc[r], V::mul(V::load(a + i), V::loadEven(b + 2 * i)));
+            }
+
+        float sum = reduceLanes(acc);
+        for (; k < n; ++k)
+            sum += a[k] * b[2 * k];
+        return sum;
+    }
+
+    static void accumulateCorrelationDeterministic(const float* left, const float* right, int n, float decay,
+                                                   float* sums) {
+        constexpr int w = V::kWidth;
+        int s = 0;
+        if (n >= kDeterministicLanes) {
+            float weights[kDeterministicLanes];
+            double power = 1.0;
+            for (int k = kDeterministicLanes - 1; k >= 0; --k) {
+                power *= static_cast<double>(decay);
+                weights[k] = static_cast<float>(power);
+            }
+            const auto blockDecay = V::set1(static_cast<float>(power));
+
+            Lanes lr;
+            Lanes ll;
+            Lanes rr;
+            zeroLanes(lr);
+            zeroLanes(ll);
+            zeroLanes(rr);
+            double totalDecay = 1.0;
+            for (; s + kDeterministicLanes <= n; s += kDeterministicLanes) {
+                for (int r = 0; r < kRegs; ++r) {
+                    const auto weight = V::load(weights + r * w);
+                    const auto l = V::load(left + s + r * w);
+                    const auto rt = V::load(right + s + r * w);
+                    lr[r] = V::add(V::mul(lr[r], blockDecay), V::mul(weight, V::mul(l, rt)));
+                    ll[r] = V::add(V::mul(ll[r], blockDecay), V::mul(weight, V::mul(l, l)));
+                    rr[r] = V::add(V::mul(rr[r], blockDecay), V::mul(weight, V::mul(rt, rt)));
+                }
+                totalDecay *= power;
+            }
+
+            const auto carried = static_cast<float>(totalDecay);
+            sums[0] = sums[0] * carried + reduceLanes(lr);
+            sums[1] = sums[1] * carried + reduceLanes(ll);
+            sums[2] = sums[2] * carried + reduceLanes(rr);
+        }
+
+        for (; s < n; ++s) {
+            const float l = left[s];
+            const float r = right[s];
+            sums[0] = (sums[0] + l * r) * decay;
+            sums[1] = (sums[1] + l * l) * decay;
+            sums[2] = (sums[2] + r * r) * decay;
+        }
+    }
+
+    static KernelTable makeTable(const char* name, bool deterministic) {
+        if (deterministic)
+            return {name,
+                    &dotDeterministic,
+                    &dotStride2Deterministic,
+                    &convolveStride2,
+                    &convolveStride2Folded,
+                    &convolveStride2Batch,
+                    &mixStereo,
+                    &downmix,
+                    &accumulateCorrelationDeterministic,
+                    &interpolatedPeak,
+                    &allFinite};
+
+        return {name, &dot, &dotStride2, &convolveStride2, &convolveStride2Folded, &convolveStride2Batch,
+                &mixStereo, &downmix, &accumulateCorrelation, &interpolatedPeak, &allFinite};
+    }
+};
+
+} // namespace qbdsp::simd::detail
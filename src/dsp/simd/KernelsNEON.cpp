@@ -0,0 +1,48 @@
+#include "KernelsImpl.h"
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define QUADRABASS_HAS_NEON_KERNELS 1
+#include <arm_neon.h>
+#endif
+
+namespace qbdsp::simd {
+
+#if defined(QUADRABASS_HAS_NEON_KERNELS)
+
+namespace {
+
+struct NEONTraits {
+    using Reg = float32x4_t;
+    static constexpr int kWidth = 4;
+
+    static Reg zero() { return vdupq_n_f32(0.0f); }
+    static Reg set1(float x) { return vdupq_n_f32(x); }
+    static Reg load(const float* p) { return vld1q_f32(p); }
+    static Reg loadEven(const float* p) { return vld2q_f32(p).val[0]; }
+    static void store(float* p, Reg v) { vst1q_f32(p, v); }
+    // Separate multiply and add (not vfmaq) so results match the x86 tables bit for bit where they promise to.
+    static Reg add(Reg a, Reg b) { return vaddq_f32(a, b); }
+    static Reg sub(Reg a, Reg b) { return vsubq_f32(a, b); }
+    static Reg mul(Reg a, Reg b) { return vmulq_f32(a, b); }
+    static Reg max(Reg a, Reg b) { return vmaxq_f32(a, b); }
+    static float hsum(Reg v) { return vaddvq_f32(v); }
+    static float hmax(Reg v) { return vmaxvq_f32(v); }
+};
+
+} // namespace
+
+const KernelTable* getNEONKernels(bool deterministic) noexcept {
+    static const KernelTable fast = detail::KernelsImpl<NEONTraits>::makeTable("neon", false);
+    static const KernelTable fixedOrder = detail::KernelsImpl<NEONTraits>::makeTable("neon", true);
+    return deterministic ? &fixedOrder : &fast;
+}
+
+#else
+
+const KernelTable* getNEONKernels(bool) noexcept {
+    return nullptr;
+}
+
+#endif
+
+} // namespace qbdsp::simd
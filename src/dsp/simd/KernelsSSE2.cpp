@@ -0,0 +1,55 @@
+#include "KernelsImpl.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define QUADRABASS_HAS_SSE2_KERNELS 1
+#include <emmintrin.h>
+#endif
+
+namespace qbdsp::simd {
+
+#if defined(QUADRABASS_HAS_SSE2_KERNELS)
+
+namespace {
+
+struct SSE2Traits {
+    using Reg = __m128;
+    static constexpr int kWidth = 4;
+
+    static Reg zero() { return _mm_setzero_ps(); }
+    static Reg set1(float x) { return _mm_set1_ps(x); }
+    static Reg load(const float* p) { return _mm_loadu_ps(p); }
+    static Reg loadEven(const float* p) {
+        return _mm_shuffle_ps(_mm_loadu_ps(p), _mm_loadu_ps(p + 4), _MM_SHUFFLE(2, 0, 2, 0));
+    }
+    static void store(float* p, Reg v) { _mm_storeu_ps(p, v); }
+    static Reg add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+    static Reg sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+    static float hsum(Reg v) {
+        const Reg pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+    }
+    static float hmax(Reg v) {
+        const Reg pairs = _mm_max_ps(v, _mm_movehl_ps(v, v));
+        return _mm_cvtss_f32(_mm_max_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+    }
+};
+
+} // namespace
+
+const KernelTable* getSSE2Kernels(bool deterministic) noexcept {
+    static const KernelTable fast = detail::KernelsImpl<SSE2Traits>::makeTable("sse2", false);
+    static const KernelTable fixedOrder = detail::KernelsImpl<SSE2Traits>::makeTable("sse2", true);
+    return deterministic ? &fixedOrder : &fast;
+}
+
+#else
+
+const KernelTable* getSSE2Kernels(bool) noexcept {
+    return nullptr;
+}
+
+#endif
+
+} // namespace qbdsp::simd
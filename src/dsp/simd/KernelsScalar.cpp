@@ -0,0 +1,32 @@
+#include "KernelsImpl.h"
+
+namespace qbdsp::simd {
+
+namespace {
+
+struct ScalarTraits {
+    using Reg = float;
+    static constexpr int kWidth = 1;
+
+    static Reg zero() { return 0.0f; }
+    static Reg set1(float x) { return x; }
+    static Reg load(const float* p) { return *p; }
+    static Reg loadEven(const float* p) { return *p; }
+    static void store(float* p, Reg v) { *p = v; }
+    static Reg add(Reg a, Reg b) { return a + b; }
+    static Reg sub(Reg a, Reg b) { return a - b; }
+    static Reg mul(Reg a, Reg b) { return a * b; }
+    static Reg max(Reg a, Reg b) { return a > b ? a : b; }
+    static float hsum(Reg v) { return v; }
+    static float hmax(Reg v) { return v; }
+};
+
+} // namespace
+
+const KernelTable& getScalarKernels(bool deterministic) noexcept {
+    static const KernelTable fast = detail::KernelsImpl<ScalarTraits>::makeTable("scalar", false);
+    static const KernelTable fixedOrder = detail::KernelsImpl<ScalarTraits>::makeTable("scalar", true);
+    return deterministic ? fixedOrder : fast;
+}
+
+} // namespace qbdsp::simd
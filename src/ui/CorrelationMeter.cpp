@@ -1,63 +1,55 @@
 #include "CorrelationMeter.h"
+#include "util/Trace.h"
+#include <cmath>
 
 namespace qbui {
 
 CorrelationMeter::CorrelationMeter() {
-    startTimerHz(30);
+    setOpaque(true);
 }
 
-void CorrelationMeter::reset() {
-    sumLR_ = 0.0f;
-    sumL2_ = 0.0f;
-    sumR2_ = 0.0f;
-    currentCorrelation_.store(1.0f, std::memory_order_relaxed);
-    displayCorrelation_ = 1.0f;
+CorrelationMeter::~CorrelationMeter() {
+    setSource(nullptr);
 }
 
-void CorrelationMeter::processBlock(const float* left, const float* right, int numSamples) {
-    for (int i = 0; i < numSamples; ++i) {
-        float l = left[i];
-        float r = right[i];
-
-        sumLR_ += l * r;
-        sumL2_ += l * l;
-        sumR2_ += r * r;
+void CorrelationMeter::setSource(util::TelemetryChannel* source) {
+    if (source_ == source)
+        return;
 
-        // Decay to avoid overflow and limit window (~200ms time constant at 48kHz)
-        sumLR_ *= 0.9999f;
-        sumL2_ *= 0.9999f;
-        sumR2_ *= 0.9999f;
-    }
+    if (source_ != nullptr)
+        source_->unsubscribe();
 
-    float denom = std::sqrt(sumL2_ * sumR2_);
-    float corr = (denom > 1e-6f) ? (sumLR_ / denom) : 0.0f;
-    corr = juce::jlimit(-1.0f, 1.0f, corr);
+    source_ = source;
+    displayCorrelation_ = 1.0f;
 
-    currentCorrelation_.store(corr, std::memory_order_relaxed);
+    if (source_ != nullptr)
+        source_->subscribe();
 }
 
-float CorrelationMeter::getCorrelation() const {
-    return currentCorrelation_.load(std::memory_order_relaxed);
-}
+bool CorrelationMeter::advanceFrame() {
+    float target = source_ != nullptr ? source_->getCorrelation() : 1.0f;
+    if (std::abs(target - displayCorrelation_) < 1.0e-3f)
+        return false;
 
-void CorrelationMeter::timerCallback() {
-    float target = currentCorrelation_.load(std::memory_order_relaxed);
     // Smooth the display
     displayCorrelation_ += (target - displayCorrelation_) * 0.2f;
     repaint();
+    return true;
 }
 
 void CorrelationMeter::paint(juce::Graphics& g) {
+    QB_TRACE_SCOPE("paint CorrelationMeter");
     auto bounds = getLocalBounds().toFloat();
     float height = bounds.getHeight();
     float width = bounds.getWidth();
-    float midY = height * 0.5f;
 
-    g.setColour(juce::Colours::black);
-    g.fillRect(bounds);
+    backgroundLayer_.draw(g, getLocalBounds(), [](juce::Graphics& background, juce::Rectangle<float> area) {
+        background.setColour(juce::Colours::black);
+        background.fillRect(area);
 
-    g.setColour(juce::Colours::darkgrey);
-    g.drawLine(0, midY, width, midY);
+        background.setColour(juce::Colours::darkgrey);
+        background.drawLine(0, area.getCentreY(), area.getWidth(), area.getCentreY());
+    });
 
     float val = displayCorrelation_;
     float mappedY = juce::jmap(val, 1.0f, -1.0f, 0.0f, height);
@@ -1,26 +1,25 @@
 #pragma once
 
-#include <atomic>
+#include "LayerCache.h"
+#include "RepaintScheduler.h"
+#include "util/TelemetryChannel.h"
 #include <juce_gui_basics/juce_gui_basics.h>
 
 namespace qbui {
 
-class CorrelationMeter : public juce::Component, public juce::Timer {
+class CorrelationMeter : public juce::Component, public RepaintScheduler::Client {
   public:
     CorrelationMeter();
+    ~CorrelationMeter() override;
     void paint(juce::Graphics& g) override;
-    void timerCallback() override;
+    bool advanceFrame() override;
 
-    void processBlock(const float* left, const float* right, int numSamples);
-    void reset();
-    float getCorrelation() const;
+    // Subscribes to the processor's telemetry; pass nullptr to detach.
+    void setSource(util::TelemetryChannel* source);
 
   private:
-    float sumLR_ = 0.0f;
-    float sumL2_ = 0.0f;
-    float sumR2_ = 0.0f;
-
-    std::atomic<float> currentCorrelation_{1.0f};
+    util::TelemetryChannel* source_ = nullptr;
+    LayerCache backgroundLayer_;
 
     // Smoothing
     float displayCorrelation_ = 1.0f;
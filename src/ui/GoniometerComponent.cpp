@@ -1,12 +1,33 @@
 #include "GoniometerComponent.h"
+#include "util/Trace.h"
 #include <cmath>
 
 namespace qbui {
 
 GoniometerComponent::GoniometerComponent() {
-    bufferL_.resize(2048, 0.0f);
-    bufferR_.resize(2048, 0.0f);
-    startTimerHz(30);
+    points_.resize(util::TelemetryChannel::kGoniometerRingFrames);
+    setOpaque(true);
+}
+
+GoniometerComponent::~GoniometerComponent() {
+    setSource(nullptr);
+}
+
+void GoniometerComponent::setSource(util::TelemetryChannel* source) {
+    if (source_ == source)
+        return;
+
+    if (source_ != nullptr)
+        source_->unsubscribe();
+
+    source_ = source;
+    numPoints_ = 0;
+    showingSilence_ = true;
+
+    if (source_ != nullptr) {
+        source_->subscribe();
+        lastSequence_ = source_->getAnalysisSequence();
+    }
 }
 
 void GoniometerComponent::mapXY(float L, float R, float& x, float& y) {
@@ -14,33 +35,38 @@ void GoniometerComponent::mapXY(float L, float R, float& x, float& y) {
     y = (L + R) / 1.41421356f;
 }
 
-void GoniometerComponent::pushSample(float L, float R) {
-    if (fifo_.getFreeSpace() > 0) {
-        int start1, size1, start2, size2;
-        fifo_.prepareToWrite(1, start1, size1, start2, size2);
+bool GoniometerComponent::advanceFrame() {
+    if (source_ == nullptr)
+        return false;
 
-        if (size1 > 0) {
-            bufferL_[(size_t)start1] = L;
-            bufferR_[(size_t)start1] = R;
-        }
+    const auto sequence = source_->getAnalysisSequence();
+    if (sequence == lastSequence_)
+        return false;
 
-        fifo_.finishedWrite(size1 + size2);
-    }
-}
+    lastSequence_ = sequence;
+    const int numNew = source_->popGoniometerPoints(points_.data(), static_cast<int>(points_.size()));
+    if (numNew <= 0)
+        return false;
 
-void GoniometerComponent::processBlock(const float* left, const float* right, int numSamples) {
-    // Decimate to not overwhelm UI buffer
-    const int decimationFactor = 4;
-    for (int i = 0; i < numSamples; i += decimationFactor) {
-        pushSample(left[i], right[i]);
+    float peak = 0.0f;
+    for (int i = 0; i < numNew; ++i) {
+        const auto& point = points_[static_cast<size_t>(i)];
+        peak = juce::jmax(peak, std::abs(point.left), std::abs(point.right));
     }
-}
 
-void GoniometerComponent::timerCallback() {
+    // Hosts often keep feeding silence while stopped; once the scope shows silence there is nothing to redraw.
+    const bool silent = peak < 1.0e-5f;
+    if (silent && showingSilence_)
+        return false;
+
+    showingSilence_ = silent;
+    numPoints_ = numNew;
     repaint();
+    return true;
 }
 
 void GoniometerComponent::paint(juce::Graphics& g) {
+    QB_TRACE_SCOPE("paint Goniometer");
     auto bounds = getLocalBounds().toFloat();
     float width = bounds.getWidth();
     float height = bounds.getHeight();
@@ -48,35 +74,26 @@ void GoniometerComponent::paint(juce::Graphics& g) {
     float cy = height * 0.5f;
     float scale = std::min(width, height) * 0.4f;
 
-    g.setColour(juce::Colours::black);
-    g.fillRect(bounds);
+    gridLayer_.draw(g, getLocalBounds(), [](juce::Graphics& grid, juce::Rectangle<float> area) {
+        grid.setColour(juce::Colours::black);
+        grid.fillRect(area);
 
-    g.setColour(juce::Colours::darkgrey.withAlpha(0.5f));
-    g.drawLine(cx, 0, cx, height);
-    g.drawLine(0, cy, width, cy);
-
-    int start1, size1, start2, size2;
-    fifo_.prepareToRead(fifo_.getNumReady(), start1, size1, start2, size2);
+        grid.setColour(juce::Colours::darkgrey.withAlpha(0.5f));
+        grid.drawLine(area.getCentreX(), 0, area.getCentreX(), area.getHeight());
+        grid.drawLine(0, area.getCentreY(), area.getWidth(), area.getCentreY());
+    });
 
     g.setColour(juce::Colours::cyan.withAlpha(0.6f));
-    auto drawPoints = [&](int start, int size) {
-        for (int i = 0; i < size; ++i) {
-            float L = bufferL_[(size_t)(start + i)];
-            float R = bufferR_[(size_t)(start + i)];
-            float x, y;
-            mapXY(L, R, x, y);
-
-            float screenX = cx + x * scale;
-            float screenY = cy - y * scale; // Y inverted for screen coordinates
+    for (int i = 0; i < numPoints_; ++i) {
+        const auto& point = points_[static_cast<size_t>(i)];
+        float x, y;
+        mapXY(point.left, point.right, x, y);
 
-            g.fillEllipse(screenX - 1.0f, screenY - 1.0f, 2.0f, 2.0f);
-        }
-    };
+        float screenX = cx + x * scale;
+        float screenY = cy - y * scale; // Y inverted for screen coordinates
 
-    drawPoints(start1, size1);
-    drawPoints(start2, size2);
-
-    fifo_.finishedRead(size1 + size2);
+        g.fillEllipse(screenX - 1.0f, screenY - 1.0f, 2.0f, 2.0f);
+    }
 }
 
 } // namespace qbui
@@ -1,30 +1,34 @@
 #pragma once
 
-#include <atomic>
+#include "LayerCache.h"
+#include "RepaintScheduler.h"
+#include "util/TelemetryChannel.h"
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <vector>
 
 namespace qbui {
 
-class GoniometerComponent : public juce::Component, public juce::Timer {
+class GoniometerComponent : public juce::Component, public RepaintScheduler::Client {
   public:
     GoniometerComponent();
+    ~GoniometerComponent() override;
     void paint(juce::Graphics& g) override;
-    void timerCallback() override;
+    bool advanceFrame() override;
 
-    void processBlock(const float* left, const float* right, int numSamples);
+    // Subscribes to the processor's telemetry; pass nullptr to detach.
+    void setSource(util::TelemetryChannel* source);
 
     // XY mapping for tests
     static void mapXY(float L, float R, float& x, float& y);
 
   private:
-    void pushSample(float L, float R);
+    util::TelemetryChannel* source_ = nullptr;
+    std::vector<util::StereoFrame> points_;
+    int numPoints_ = 0;
+    juce::uint32 lastSequence_ = 0;
+    bool showingSilence_ = true;
 
-    juce::AbstractFifo fifo_{2048};
-    std::vector<float> bufferL_;
-    std::vector<float> bufferR_;
-
-    juce::Image displayImage_;
+    LayerCache gridLayer_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GoniometerComponent)
 };
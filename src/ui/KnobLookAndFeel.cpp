@@ -0,0 +1,96 @@
+#include "KnobLookAndFeel.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace qbui {
+
+namespace {
+
+struct KnobGeometry {
+    juce::Rectangle<float> bounds;
+    float lineWidth = 0.0f;
+    float arcRadius = 0.0f;
+};
+
+KnobGeometry makeGeometry(juce::Rectangle<float> area) {
+    KnobGeometry geometry;
+    geometry.bounds = area.reduced(10.0f);
+    const float radius = juce::jmin(geometry.bounds.getWidth(), geometry.bounds.getHeight()) / 2.0f;
+    geometry.lineWidth = juce::jmin(8.0f, radius * 0.5f);
+    geometry.arcRadius = radius - geometry.lineWidth * 0.5f;
+    return geometry;
+}
+
+// Everything the cached face depends on besides its size.
+juce::uint64 makeFaceKey(juce::Colour outline, bool enabled, float rotaryStartAngle, float rotaryEndAngle) {
+    std::uint32_t startBits = 0;
+    std::uint32_t endBits = 0;
+    std::memcpy(&startBits, &rotaryStartAngle, sizeof(startBits));
+    std::memcpy(&endBits, &rotaryEndAngle, sizeof(endBits));
+
+    // FNV-1a over the words.
+    juce::uint64 key = 14695981039346656037ull;
+    for (const juce::uint64 word : {static_cast<juce::uint64>(outline.getARGB()), static_cast<juce::uint64>(enabled),
+                                    static_cast<juce::uint64>(startBits), static_cast<juce::uint64>(endBits)}) {
+        key ^= word;
+        key *= 1099511628211ull;
+    }
+    return key;
+}
+
+} // namespace
+
+KnobLookAndFeel::~KnobLookAndFeel() {
+    for (auto& entry : faceCaches_)
+        entry.first->removeComponentListener(this);
+}
+
+void KnobLookAndFeel::componentBeingDeleted(juce::Component& component) {
+    faceCaches_.erase(&component);
+}
+
+void KnobLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height, float sliderPos,
+                                       float rotaryStartAngle, float rotaryEndAngle, juce::Slider& slider) {
+    const auto area = juce::Rectangle<int>(x, y, width, height);
+    const auto outline = slider.findColour(juce::Slider::rotarySliderOutlineColourId);
+
+    auto cache = faceCaches_.find(&slider);
+    if (cache == faceCaches_.end()) {
+        cache = faceCaches_.emplace(&slider, LayerCache()).first;
+        slider.addComponentListener(this);
+    }
+
+    const auto key = makeFaceKey(outline, slider.isEnabled(), rotaryStartAngle, rotaryEndAngle);
+    cache->second.draw(g, area, [&](juce::Graphics& face, juce::Rectangle<float> faceArea) {
+        const auto geometry = makeGeometry(faceArea);
+        juce::Path backgroundArc;
+        backgroundArc.addCentredArc(geometry.bounds.getCentreX(), geometry.bounds.getCentreY(), geometry.arcRadius,
+                                    geometry.arcRadius, 0.0f, rotaryStartAngle, rotaryEndAngle, true);
+        face.setColour(outline);
+        face.strokePath(backgroundArc,
+                        juce::PathStrokeType(geometry.lineWidth, juce::PathStrokeType::curved,
+                                             juce::PathStrokeType::rounded));
+    }, key);
+
+    const auto geometry = makeGeometry(area.toFloat());
+    const float toAngle = rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
+
+    if (slider.isEnabled()) {
+        juce::Path valueArc;
+        valueArc.addCentredArc(geometry.bounds.getCentreX(), geometry.bounds.getCentreY(), geometry.arcRadius,
+                               geometry.arcRadius, 0.0f, rotaryStartAngle, toAngle, true);
+        g.setColour(slider.findColour(juce::Slider::rotarySliderFillColourId));
+        g.strokePath(valueArc, juce::PathStrokeType(geometry.lineWidth, juce::PathStrokeType::curved,
+                                                    juce::PathStrokeType::rounded));
+    }
+
+    const float thumbWidth = geometry.lineWidth * 2.0f;
+    const juce::Point<float> thumbPoint(
+        geometry.bounds.getCentreX() + geometry.arcRadius * std::cos(toAngle - juce::MathConstants<float>::halfPi),
+        geometry.bounds.getCentreY() + geometry.arcRadius * std::sin(toAngle - juce::MathConstants<float>::halfPi));
+    g.setColour(slider.findColour(juce::Slider::thumbColourId));
+    g.fillEllipse(juce::Rectangle<float>(thumbWidth, thumbWidth).withCentre(thumbPoint));
+}
+
+} // namespace qbui
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "LayerCache.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <map>
+
+namespace qbui {
+
+// LookAndFeel_V4 rotary knobs with the static track arc cached per slider; only the value arc and thumb are drawn
+// on each repaint. A cached face is re-rendered when the slider's outline colour, enablement or rotary range
+// changes, and dropped when the slider is deleted, so a new slider at a reused address never inherits it.
+class KnobLookAndFeel final : public juce::LookAndFeel_V4, private juce::ComponentListener {
+  public:
+    ~KnobLookAndFeel() override;
+
+    void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height, float sliderPos,
+                          float rotaryStartAngle, float rotaryEndAngle, juce::Slider& slider) override;
+
+  private:
+    void componentBeingDeleted(juce::Component& component) override;
+
+    std::map<juce::Component*, LayerCache> faceCaches_;
+};
+
+} // namespace qbui
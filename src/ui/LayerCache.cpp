@@ -0,0 +1,31 @@
+#include "LayerCache.h"
+#include <cmath>
+
+namespace qbui {
+
+void LayerCache::draw(juce::Graphics& g, juce::Rectangle<int> area, const Renderer& render, juce::uint64 contentKey) {
+    if (area.isEmpty())
+        return;
+
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const bool scaleChanged = scale < scale_ || scale > scale_;
+    if (image_.isNull() || area.getWidth() != width_ || area.getHeight() != height_ || scaleChanged ||
+        contentKey != contentKey_) {
+        width_ = area.getWidth();
+        height_ = area.getHeight();
+        scale_ = scale;
+        contentKey_ = contentKey;
+
+        const int pixelWidth = juce::jmax(1, static_cast<int>(std::ceil(static_cast<float>(width_) * scale_)));
+        const int pixelHeight = juce::jmax(1, static_cast<int>(std::ceil(static_cast<float>(height_) * scale_)));
+        image_ = juce::Image(juce::Image::ARGB, pixelWidth, pixelHeight, true);
+
+        juce::Graphics layer(image_);
+        layer.addTransform(juce::AffineTransform::scale(scale_));
+        render(layer, juce::Rectangle<float>(static_cast<float>(width_), static_cast<float>(height_)));
+    }
+
+    g.drawImage(image_, area.toFloat());
+}
+
+} // namespace qbui
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <functional>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace qbui {
+
+// Keeps a static layer (background, grid, knob face) as an image rendered at the target's physical pixel scale.
+// The layer is redrawn only when the area size, the display scale factor or the caller's content key changes;
+// otherwise draw() is one blit.
+class LayerCache final {
+  public:
+    using Renderer = std::function<void(juce::Graphics&, juce::Rectangle<float>)>;
+
+    // Draws the cached layer into area, calling render (in zero-origin layer coordinates) if it is stale.
+    // contentKey stands for whatever else render depends on (colours, enablement); any change re-renders.
+    void draw(juce::Graphics& g, juce::Rectangle<int> area, const Renderer& render, juce::uint64 contentKey = 0);
+
+  private:
+    juce::Image image_;
+    int width_ = 0;
+    int height_ = 0;
+    float scale_ = 0.0f;
+    juce::uint64 contentKey_ = 0;
+};
+
+} // namespace qbui
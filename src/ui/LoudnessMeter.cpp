@@ -0,0 +1,104 @@
+#include "LoudnessMeter.h"
+#include "util/Trace.h"
+#include <cmath>
+
+namespace qbui {
+
+namespace {
+
+// Readouts only change visibly in 0.1 steps.
+bool changed(float a, float b) {
+    if (!std::isfinite(a) || !std::isfinite(b))
+        return std::isfinite(a) != std::isfinite(b);
+    return std::abs(a - b) >= 0.05f;
+}
+
+} // namespace
+
+LoudnessMeter::LoudnessMeter() {
+    setOpaque(true);
+}
+
+LoudnessMeter::~LoudnessMeter() {
+    setSource(nullptr);
+}
+
+void LoudnessMeter::setSource(util::TelemetryChannel* source) {
+    if (source_ == source)
+        return;
+
+    if (source_ != nullptr)
+        source_->unsubscribe();
+
+    source_ = source;
+
+    if (source_ != nullptr)
+        source_->subscribe();
+}
+
+juce::String LoudnessMeter::formatLevel(float value) {
+    if (!std::isfinite(value) || value <= -100.0f)
+        return "-inf";
+    return juce::String(value, 1);
+}
+
+void LoudnessMeter::mouseDoubleClick(const juce::MouseEvent& event) {
+    juce::ignoreUnused(event);
+    if (source_ != nullptr)
+        source_->resetLoudness();
+}
+
+bool LoudnessMeter::advanceFrame() {
+    if (source_ == nullptr)
+        return false;
+
+    const float truePeak = source_->getTruePeakDb();
+    const float shortTerm = source_->getShortTermLufs();
+    const float integrated = source_->getIntegratedLufs();
+    if (!changed(truePeak, truePeakDb_) && !changed(shortTerm, shortTermLufs_) &&
+        !changed(integrated, integratedLufs_))
+        return false;
+
+    truePeakDb_ = truePeak;
+    shortTermLufs_ = shortTerm;
+    integratedLufs_ = integrated;
+    repaint();
+    return true;
+}
+
+void LoudnessMeter::paint(juce::Graphics& g) {
+    QB_TRACE_SCOPE("paint LoudnessMeter");
+    backgroundLayer_.draw(g, getLocalBounds(), [](juce::Graphics& background, juce::Rectangle<float> area) {
+        background.setColour(juce::Colours::black);
+        background.fillRect(area);
+    });
+
+    auto bounds = getLocalBounds().reduced(4);
+    auto bar = bounds.removeFromBottom(6).toFloat();
+    const float shortTerm = std::isfinite(shortTermLufs_) ? shortTermLufs_ : kMinBarLufs;
+    const float fill = juce::jmap(juce::jlimit(kMinBarLufs, kMaxBarLufs, shortTerm), kMinBarLufs, kMaxBarLufs, 0.0f,
+                                  bar.getWidth());
+    g.setColour(juce::Colour::fromRGB(41, 51, 68));
+    g.fillRect(bar);
+    g.setColour(juce::Colour::fromRGB(89, 174, 255));
+    g.fillRect(bar.withWidth(fill));
+
+    const int column = bounds.getWidth() / 3;
+    auto drawReadout = [&g](juce::Rectangle<int> area, const juce::String& label, const juce::String& value,
+                            juce::Colour colour) {
+        g.setColour(juce::Colour::fromRGB(192, 205, 220));
+        g.setFont(juce::FontOptions(11.0f));
+        g.drawText(label, area.removeFromTop(area.getHeight() / 2), juce::Justification::centred);
+        g.setColour(colour);
+        g.setFont(juce::FontOptions(14.0f, juce::Font::bold));
+        g.drawText(value, area, juce::Justification::centred);
+    };
+
+    const auto valueColour = juce::Colour::fromRGB(220, 230, 242);
+    const auto peakColour = truePeakDb_ > kTruePeakWarningDb ? juce::Colours::red : valueColour;
+    drawReadout(bounds.removeFromLeft(column), "dBTP", formatLevel(truePeakDb_), peakColour);
+    drawReadout(bounds.removeFromLeft(column), "Short-term", formatLevel(shortTermLufs_), valueColour);
+    drawReadout(bounds, "Integrated", formatLevel(integratedLufs_), valueColour);
+}
+
+} // namespace qbui
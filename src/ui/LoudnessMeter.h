@@ -0,0 +1,43 @@
+#pragma once
+
+#include "LayerCache.h"
+#include "RepaintScheduler.h"
+#include "util/TelemetryChannel.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace qbui {
+
+// True-peak, short-term and integrated loudness readouts with a short-term bar. Double-click to restart the
+// integrated measurement and the peak hold.
+class LoudnessMeter : public juce::Component, public RepaintScheduler::Client {
+  public:
+    // True peaks above this are drawn as overs.
+    static constexpr float kTruePeakWarningDb = -1.0f;
+    // Range of the short-term bar.
+    static constexpr float kMinBarLufs = -60.0f;
+    static constexpr float kMaxBarLufs = 0.0f;
+
+    LoudnessMeter();
+    ~LoudnessMeter() override;
+    void paint(juce::Graphics& g) override;
+    void mouseDoubleClick(const juce::MouseEvent& event) override;
+    bool advanceFrame() override;
+
+    // Subscribes to the processor's telemetry; pass nullptr to detach.
+    void setSource(util::TelemetryChannel* source);
+
+    // One decimal place, or "-inf" for silence.
+    static juce::String formatLevel(float value);
+
+  private:
+    util::TelemetryChannel* source_ = nullptr;
+    LayerCache backgroundLayer_;
+
+    float truePeakDb_ = -100.0f;
+    float shortTermLufs_ = kMinBarLufs;
+    float integratedLufs_ = kMinBarLufs;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
+
+} // namespace qbui
@@ -0,0 +1,49 @@
+#include "QualityIndicator.h"
+#include "util/Trace.h"
+
+namespace qbui {
+
+void QualityIndicator::setSource(const util::TelemetryChannel* source) noexcept {
+    source_ = source;
+}
+
+juce::String QualityIndicator::formatTier(int tier) {
+    return tier <= 0 ? juce::String("Full") : "Tier " + juce::String(tier);
+}
+
+juce::String QualityIndicator::formatLoad(int loadPercent, int numNonFiniteBlocks) {
+    const auto load = juce::String(loadPercent) + "% load";
+    return numNonFiniteBlocks > 0 ? load + ", " + juce::String(numNonFiniteBlocks) + " NaN/Inf" : load;
+}
+
+bool QualityIndicator::advanceFrame() {
+    if (source_ == nullptr)
+        return false;
+
+    const int tier = source_->getQualityTier();
+    const int loadPercent = juce::roundToInt(100.0f * source_->getProcessingLoad());
+    const int numNonFiniteBlocks = source_->getNumNonFiniteBlocks();
+    if (tier == tier_ && loadPercent == loadPercent_ && numNonFiniteBlocks == numNonFiniteBlocks_)
+        return false;
+
+    tier_ = tier;
+    loadPercent_ = loadPercent;
+    numNonFiniteBlocks_ = numNonFiniteBlocks;
+    repaint();
+    return true;
+}
+
+void QualityIndicator::paint(juce::Graphics& g) {
+    QB_TRACE_SCOPE("paint QualityIndicator");
+    auto bounds = getLocalBounds();
+    g.setColour(tier_ > 0 ? juce::Colour::fromRGB(255, 184, 77) : juce::Colour::fromRGB(220, 230, 242));
+    g.setFont(juce::FontOptions(13.0f, juce::Font::bold));
+    g.drawText(formatTier(tier_), bounds.removeFromLeft(bounds.getWidth() / 2), juce::Justification::centredRight);
+
+    g.setColour(numNonFiniteBlocks_ > 0 ? juce::Colours::red : juce::Colour::fromRGB(192, 205, 220));
+    g.setFont(juce::FontOptions(11.0f));
+    g.drawText(formatLoad(loadPercent_, numNonFiniteBlocks_), bounds.withTrimmedLeft(6),
+               juce::Justification::centredLeft);
+}
+
+} // namespace qbui
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "RepaintScheduler.h"
+#include "util/TelemetryChannel.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace qbui {
+
+// Header readout for adaptive quality: the FIR tier the engine is running ("Full" at tier 0) and the smoothed
+// processing load as a share of the block deadline. Reduced tiers are drawn in amber. Once the engine's non-finite
+// guard has tripped, the load readout turns red and counts the affected blocks.
+class QualityIndicator : public juce::Component, public RepaintScheduler::Client {
+  public:
+    void paint(juce::Graphics& g) override;
+    bool advanceFrame() override;
+
+    // The quality telemetry is published every block, so unlike the meters this does not subscribe.
+    void setSource(const util::TelemetryChannel* source) noexcept;
+
+    // "Full" for tier 0, otherwise "Tier n".
+    static juce::String formatTier(int tier);
+    // "12% load", with ", 3 NaN/Inf" appended once the guard has tripped.
+    static juce::String formatLoad(int loadPercent, int numNonFiniteBlocks);
+
+  private:
+    const util::TelemetryChannel* source_ = nullptr;
+    int tier_ = 0;
+    int loadPercent_ = 0;
+    int numNonFiniteBlocks_ = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(QualityIndicator)
+};
+
+} // namespace qbui
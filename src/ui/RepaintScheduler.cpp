@@ -0,0 +1,41 @@
+#include "RepaintScheduler.h"
+#include "util/Trace.h"
+#include <algorithm>
+
+namespace qbui {
+
+RepaintScheduler::RepaintScheduler(juce::Component& host)
+    : vblank_(&host, [this] { advance(juce::Time::getMillisecondCounterHiRes()); }) {}
+
+void RepaintScheduler::addClient(Client& client) {
+    if (std::find(clients_.begin(), clients_.end(), &client) == clients_.end())
+        clients_.push_back(&client);
+    quietFrames_ = 0;
+}
+
+void RepaintScheduler::removeClient(Client& client) {
+    clients_.erase(std::remove(clients_.begin(), clients_.end(), &client), clients_.end());
+}
+
+bool RepaintScheduler::isIdle() const noexcept {
+    return quietFrames_ >= kQuietFramesBeforeIdle;
+}
+
+void RepaintScheduler::advance(double nowMs) {
+    const double interval = isIdle() ? kIdleFrameIntervalMs : kActiveFrameIntervalMs;
+    // Small slack so a 60 Hz display is not decimated to 30 Hz by vblank jitter.
+    if (nowMs - lastFrameMs_ < interval - 2.0)
+        return;
+
+    // Advance on a fixed grid so faster displays average out to the target rate; resync after long gaps.
+    lastFrameMs_ = nowMs - lastFrameMs_ > 2.0 * interval ? nowMs : lastFrameMs_ + interval;
+
+    QB_TRACE_SCOPE("pollMeters");
+    bool anyChanged = false;
+    for (auto* client : clients_)
+        anyChanged |= client->advanceFrame();
+
+    quietFrames_ = anyChanged ? 0 : juce::jmin(quietFrames_ + 1, kQuietFramesBeforeIdle);
+}
+
+} // namespace qbui
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <vector>
+
+namespace qbui {
+
+// Drives every live view of one editor from the display's vblank instead of a timer per component.
+//
+// Each frame, clients pull whatever new data they have and repaint only if it changed. While clients keep
+// reporting no change, the scheduler drops to a slow polling rate so idle editors cost close to nothing.
+class RepaintScheduler final {
+  public:
+    class Client {
+      public:
+        virtual ~Client() = default;
+
+        // Message thread. Pull new data, call repaint() if the view changed, and return whether it did.
+        virtual bool advanceFrame() = 0;
+    };
+
+    static constexpr double kActiveFrameIntervalMs = 1000.0 / 60.0;
+    static constexpr double kIdleFrameIntervalMs = 1000.0 / 4.0;
+    static constexpr int kQuietFramesBeforeIdle = 30;
+
+    explicit RepaintScheduler(juce::Component& host);
+
+    void addClient(Client& client);
+    void removeClient(Client& client);
+    bool isIdle() const noexcept;
+
+    // Runs one scheduling step as if a vblank had arrived at nowMs.
+    void advance(double nowMs);
+
+  private:
+    std::vector<Client*> clients_;
+    double lastFrameMs_ = 0.0;
+    int quietFrames_ = 0;
+    juce::VBlankAttachment vblank_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RepaintScheduler)
+};
+
+} // namespace qbui
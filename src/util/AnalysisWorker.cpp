@@ -0,0 +1,41 @@
+#include "AnalysisWorker.h"
+#include "Trace.h"
+#include <algorithm>
+
+namespace util {
+
+AnalysisWorker::AnalysisWorker() : juce::Thread("QuadraBass Analysis") {}
+
+AnalysisWorker::~AnalysisWorker() {
+    stopThread(1000);
+}
+
+void AnalysisWorker::addChannel(TelemetryChannel& channel) {
+    {
+        const juce::ScopedLock sl(lock_);
+        if (std::find(channels_.begin(), channels_.end(), &channel) == channels_.end())
+            channels_.push_back(&channel);
+    }
+
+    startThread();
+}
+
+void AnalysisWorker::removeChannel(TelemetryChannel& channel) {
+    const juce::ScopedLock sl(lock_);
+    channels_.erase(std::remove(channels_.begin(), channels_.end(), &channel), channels_.end());
+}
+
+void AnalysisWorker::run() {
+    QB_TRACE_THREAD_NAME("Analysis");
+    while (!threadShouldExit()) {
+        {
+            const juce::ScopedLock sl(lock_);
+            for (auto* channel : channels_)
+                channel->drain();
+        }
+
+        wait(kDrainIntervalMs);
+    }
+}
+
+} // namespace util
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "TelemetryChannel.h"
+#include <juce_core/juce_core.h>
+#include <vector>
+
+namespace util {
+
+// One background thread shared by every processor instance (hold it through juce::SharedResourcePointer). It
+// periodically drains each registered TelemetryChannel, so meter math never runs on the audio thread.
+//
+// The channel list is only touched under lock_ by the worker and by add/removeChannel, which are called from the
+// processor's constructor and destructor. removeChannel() therefore returns only once the worker has finished
+// with that channel.
+class AnalysisWorker final : private juce::Thread {
+  public:
+    static constexpr int kDrainIntervalMs = 10;
+
+    AnalysisWorker();
+    ~AnalysisWorker() override;
+
+    void addChannel(TelemetryChannel& channel);
+    void removeChannel(TelemetryChannel& channel);
+
+  private:
+    void run() override;
+
+    juce::CriticalSection lock_;
+    std::vector<TelemetryChannel*> channels_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisWorker)
+};
+
+} // namespace util
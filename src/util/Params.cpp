@@ -1,4 +1,5 @@
 #include "Params.h"
+#include "dsp/EngineParams.h"
 
 namespace util {
 
@@ -8,12 +9,16 @@ Params::Params(juce::AudioProcessor& processor) : apvts(processor, nullptr, "PAR
     phaseAngleDeg_ = apvts.getRawParameterValue(IDs::phaseAngleDeg);
     phaseRotationDeg_ = apvts.getRawParameterValue(IDs::phaseRotationDeg);
     outputGainDb_ = apvts.getRawParameterValue(IDs::outputGainDb);
+    adaptiveQuality_ = apvts.getRawParameterValue(IDs::adaptiveQuality);
+    monoBass_ = apvts.getRawParameterValue(IDs::monoBass);
 
     jassert(widthPercent_ != nullptr);
     jassert(hilbertMode_ != nullptr);
     jassert(phaseAngleDeg_ != nullptr);
     jassert(phaseRotationDeg_ != nullptr);
     jassert(outputGainDb_ != nullptr);
+    jassert(adaptiveQuality_ != nullptr);
+    jassert(monoBass_ != nullptr);
 }
 
 float Params::getWidthPercent() const noexcept {
@@ -22,7 +27,7 @@ float Params::getWidthPercent() const noexcept {
 
 int Params::getHilbertModeIndex() const noexcept {
     const int idx = static_cast<int>(hilbertMode_->load(std::memory_order_relaxed));
-    return juce::jlimit(0, 1, idx);
+    return juce::jlimit(0, qbdsp::EngineParams::kNumHilbertModes - 1, idx);
 }
 
 float Params::getPhaseAngleDeg() const noexcept {
@@ -37,25 +42,50 @@ float Params::getOutputGainDb() const noexcept {
     return outputGainDb_->load(std::memory_order_relaxed);
 }
 
+bool Params::getAdaptiveQuality() const noexcept {
+    return adaptiveQuality_->load(std::memory_order_relaxed) >= 0.5f;
+}
+
+int Params::getMonoBassIndex() const noexcept {
+    const int idx = static_cast<int>(monoBass_->load(std::memory_order_relaxed));
+    return juce::jlimit(0, qbdsp::EngineParams::kNumMonoBassOptions - 1, idx);
+}
+
 juce::AudioProcessorValueTreeState::ParameterLayout Params::createLayout() {
+    using Limits = qbdsp::EngineParams;
+    const qbdsp::EngineParams defaults;
     std::vector<std::unique_ptr<juce::RangedAudioParameter>> parameters;
 
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID(IDs::widthPercent, 1), "Width", juce::NormalisableRange<float>(0.0f, 100.0f, 0.01f), 0.0f));
+        juce::ParameterID(IDs::widthPercent, 1), "Width",
+        juce::NormalisableRange<float>(Limits::kMinWidthPercent, Limits::kMaxWidthPercent, 0.01f),
+        defaults.widthPercent));
 
     parameters.push_back(std::make_unique<juce::AudioParameterChoice>(
-        juce::ParameterID(IDs::hilbertMode, 1), "Hilbert Mode", juce::StringArray{"IIR", "FIR"}, 1));
+        juce::ParameterID(IDs::hilbertMode, 1), "Hilbert Mode",
+        juce::StringArray{"IIR", "FIR", "Multirate", "Spectral", "Auto", "Velvet"}, defaults.hilbertModeIndex));
 
-    parameters.push_back(
-        std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(IDs::phaseAngleDeg, 1), "Phase Angle",
-                                                    juce::NormalisableRange<float>(0.0f, 180.0f, 0.01f), 90.0f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(IDs::phaseAngleDeg, 1), "Phase Angle",
+        juce::NormalisableRange<float>(Limits::kMinPhaseAngleDeg, Limits::kMaxPhaseAngleDeg, 0.01f),
+        defaults.phaseAngleDeg));
 
-    parameters.push_back(
-        std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(IDs::phaseRotationDeg, 1), "Phase Rotation",
-                                                    juce::NormalisableRange<float>(-180.0f, 180.0f, 0.01f), 0.0f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(IDs::phaseRotationDeg, 1), "Phase Rotation",
+        juce::NormalisableRange<float>(Limits::kMinPhaseRotationDeg, Limits::kMaxPhaseRotationDeg, 0.01f),
+        defaults.phaseRotationDeg));
 
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID(IDs::outputGainDb, 1), "Gain", juce::NormalisableRange<float>(-60.0f, 12.0f, 0.01f), 0.0f));
+        juce::ParameterID(IDs::outputGainDb, 1), "Gain",
+        juce::NormalisableRange<float>(Limits::kMinOutputGainDb, Limits::kMaxOutputGainDb, 0.01f),
+        defaults.outputGainDb));
+
+    parameters.push_back(std::make_unique<juce::AudioParameterBool>(juce::ParameterID(IDs::adaptiveQuality, 1),
+                                                                    "Adaptive Quality", false));
+
+    parameters.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID(IDs::monoBass, 1), "Mono Bass",
+        juce::StringArray{"Off", "60 Hz", "80 Hz", "100 Hz", "120 Hz", "150 Hz", "200 Hz"}, defaults.monoBassIndex));
 
     return {parameters.begin(), parameters.end()};
 }
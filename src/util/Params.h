@@ -13,6 +13,8 @@ class Params final {
         static constexpr const char* phaseAngleDeg = "phase_angle_deg";
         static constexpr const char* phaseRotationDeg = "phase_rotation_deg";
         static constexpr const char* outputGainDb = "output_gain_db";
+        static constexpr const char* adaptiveQuality = "adaptive_quality";
+        static constexpr const char* monoBass = "mono_bass";
     };
 
     explicit Params(juce::AudioProcessor& processor);
@@ -24,6 +26,8 @@ class Params final {
     float getPhaseAngleDeg() const noexcept;
     float getPhaseRotationDeg() const noexcept;
     float getOutputGainDb() const noexcept;
+    bool getAdaptiveQuality() const noexcept;
+    int getMonoBassIndex() const noexcept;
 
     static juce::AudioProcessorValueTreeState::ParameterLayout createLayout();
 
@@ -33,6 +37,8 @@ class Params final {
     std::atomic<float>* phaseAngleDeg_ = nullptr;
     std::atomic<float>* phaseRotationDeg_ = nullptr;
     std::atomic<float>* outputGainDb_ = nullptr;
+    std::atomic<float>* adaptiveQuality_ = nullptr;
+    std::atomic<float>* monoBass_ = nullptr;
 };
 
 } // namespace util
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace util {
+
+// Single-producer/single-consumer ring buffer. Storage is allocated once in the constructor, and push/pop are
+// wait-free, so either end may live on the audio thread. Positions are free-running counters masked into a
+// power-of-two capacity.
+template <typename T> class SpscRing final {
+  public:
+    explicit SpscRing(int minimumCapacity) {
+        std::uint32_t capacity = 1;
+        while (capacity < static_cast<std::uint32_t>(minimumCapacity))
+            capacity <<= 1;
+
+        storage_.resize(capacity);
+        mask_ = capacity - 1;
+    }
+
+    int getCapacity() const noexcept { return static_cast<int>(storage_.size()); }
+
+    int getNumReady() const noexcept {
+        const auto read = readPos_.load(std::memory_order_acquire);
+        const auto write = writePos_.load(std::memory_order_acquire);
+        return static_cast<int>(write - read);
+    }
+
+    // Producer: stores makeItem(i) for i in [0, count) and returns how many items fit. Items that do not fit are
+    // dropped rather than waited for.
+    template <typename MakeItem> int pushWith(int count, MakeItem&& makeItem) noexcept {
+        const auto write = writePos_.load(std::memory_order_relaxed);
+        const auto read = readPos_.load(std::memory_order_acquire);
+        const int freeSpace = getCapacity() - static_cast<int>(write - read);
+        const int numToWrite = count < freeSpace ? count : freeSpace;
+
+        for (int i = 0; i < numToWrite; ++i)
+            storage_[(write + static_cast<std::uint32_t>(i)) & mask_] = makeItem(i);
+
+        writePos_.store(write + static_cast<std::uint32_t>(numToWrite), std::memory_order_release);
+        return numToWrite;
+    }
+
+    int push(const T* items, int count) noexcept {
+        return pushWith(count, [items](int i) { return items[i]; });
+    }
+
+    // Consumer: copies up to maxCount items into dest and returns how many were read.
+    int pop(T* dest, int maxCount) noexcept {
+        const auto read = readPos_.load(std::memory_order_relaxed);
+        const auto write = writePos_.load(std::memory_order_acquire);
+        const int available = static_cast<int>(write - read);
+        const int numToRead = maxCount < available ? maxCount : available;
+
+        for (int i = 0; i < numToRead; ++i)
+            dest[i] = storage_[(read + static_cast<std::uint32_t>(i)) & mask_];
+
+        readPos_.store(read + static_cast<std::uint32_t>(numToRead), std::memory_order_release);
+        return numToRead;
+    }
+
+    // Consumer: drops everything currently queued.
+    void discardAll() noexcept { readPos_.store(writePos_.load(std::memory_order_acquire), std::memory_order_release); }
+
+  private:
+    std::vector<T> storage_;
+    std::uint32_t mask_ = 0;
+    std::atomic<std::uint32_t> writePos_{0};
+    std::atomic<std::uint32_t> readPos_{0};
+};
+
+} // namespace util
@@ -0,0 +1,110 @@
+#include "StateCodec.h"
+#include <cstring>
+
+namespace util {
+
+namespace {
+
+constexpr size_t kHeaderBytes = 8;
+
+juce::RangedAudioParameter* findParameter(const Params& params, const juce::uint8* id, size_t idLength) {
+    for (auto* parameter : params.apvts.processor.getParameters()) {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+        if (ranged == nullptr)
+            continue;
+
+        const auto& paramId = ranged->paramID;
+        if (static_cast<size_t>(paramId.getNumBytesAsUTF8()) == idLength &&
+            std::memcmp(paramId.toRawUTF8(), id, idLength) == 0)
+            return ranged;
+    }
+
+    return nullptr;
+}
+
+} // namespace
+
+void StateCodec::write(const Params& params, juce::MemoryBlock& destData) {
+    juce::Array<juce::RangedAudioParameter*> parameters;
+    for (auto* parameter : params.apvts.processor.getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            parameters.add(ranged);
+
+    destData.reset();
+    juce::MemoryOutputStream out(destData, false);
+    out.writeInt(static_cast<int>(kMagic));
+    out.writeShort(static_cast<short>(kFormatVersion));
+    out.writeShort(static_cast<short>(parameters.size()));
+
+    for (auto* parameter : parameters) {
+        const auto& id = parameter->paramID;
+        const auto idLength = juce::jmin(static_cast<int>(id.getNumBytesAsUTF8()), 255);
+        out.writeByte(static_cast<char>(idLength));
+        out.write(id.toRawUTF8(), static_cast<size_t>(idLength));
+        out.writeFloat(parameter->convertFrom0to1(parameter->getValue()));
+    }
+}
+
+bool StateCodec::read(Params& params, const void* data, int sizeInBytes) {
+    if (data == nullptr || sizeInBytes <= 0)
+        return false;
+
+    const auto* bytes = static_cast<const juce::uint8*>(data);
+    const auto size = static_cast<size_t>(sizeInBytes);
+    if (size >= kHeaderBytes && juce::ByteOrder::littleEndianInt(bytes) == kMagic)
+        return readBinary(params, bytes, size);
+
+    return readXml(params, data, sizeInBytes);
+}
+
+bool StateCodec::readBinary(Params& params, const juce::uint8* data, size_t size) {
+    const int version = juce::ByteOrder::littleEndianShort(data + 4);
+    const int count = juce::ByteOrder::littleEndianShort(data + 6);
+    if (version < 1 || version > kFormatVersion)
+        return false;
+
+    // The first pass only validates, so a truncated block never leaves the parameters half restored.
+    for (const bool apply : {false, true}) {
+        size_t pos = kHeaderBytes;
+        for (int i = 0; i < count; ++i) {
+            if (pos + 1 > size)
+                return false;
+
+            const size_t idLength = data[pos++];
+            if (pos + idLength + sizeof(float) > size)
+                return false;
+
+            const auto* id = data + pos;
+            pos += idLength;
+
+            const auto valueBits = juce::ByteOrder::littleEndianInt(data + pos);
+            pos += sizeof(float);
+
+            if (!apply)
+                continue;
+
+            float value = 0.0f;
+            std::memcpy(&value, &valueBits, sizeof(float));
+
+            // Unknown IDs are skipped so states from newer builds still load what they can.
+            if (auto* parameter = findParameter(params, id, idLength))
+                parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        }
+    }
+
+    return true;
+}
+
+bool StateCodec::readXml(Params& params, const void* data, int sizeInBytes) {
+    std::unique_ptr<juce::XmlElement> xmlState(juce::AudioProcessor::getXmlFromBinary(data, sizeInBytes));
+    if (xmlState == nullptr)
+        return false;
+
+    if (!xmlState->hasTagName(params.apvts.state.getType()))
+        return false;
+
+    params.apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+    return true;
+}
+
+} // namespace util
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Params.h"
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace util {
+
+// Plugin state serialisation.
+//
+// States are written in a compact little-endian binary layout:
+//   "QBST" | u16 version | u16 parameter count | { u8 id length | id bytes (UTF-8) | f32 plain value } ...
+// read() restores it straight into the parameters without going through XML or a ValueTree, and still accepts
+// the XML blocks (AudioProcessor::copyXmlToBinary) written by earlier versions.
+class StateCodec final {
+  public:
+    static constexpr juce::uint32 kMagic = 0x54534251; // "QBST"
+    static constexpr int kFormatVersion = 1;
+
+    static void write(const Params& params, juce::MemoryBlock& destData);
+    static bool read(Params& params, const void* data, int sizeInBytes);
+
+  private:
+    static bool readBinary(Params& params, const juce::uint8* data, size_t size);
+    static bool readXml(Params& params, const void* data, int sizeInBytes);
+};
+
+} // namespace util
@@ -0,0 +1,153 @@
+#include "TelemetryChannel.h"
+#include "Trace.h"
+
+namespace util {
+
+TelemetryChannel::TelemetryChannel() {
+    drainFrames_.resize(kDrainChunkFrames);
+    drainLeft_.resize(kDrainChunkFrames, 0.0f);
+    drainRight_.resize(kDrainChunkFrames, 0.0f);
+}
+
+void TelemetryChannel::setSampleRate(double sampleRate) noexcept {
+    sampleRate_.store(sampleRate, std::memory_order_relaxed);
+}
+
+void TelemetryChannel::pushOutputBlock(const float* left, const float* right, int numSamples) noexcept {
+    if (numSamples <= 0)
+        return;
+    if (sampleRate_.load(std::memory_order_relaxed) <= 0.0 && subscribers_.load(std::memory_order_relaxed) <= 0)
+        return;
+
+    outputRing_.pushWith(numSamples, [left, right](int i) { return StereoFrame{left[i], right[i]}; });
+}
+
+void TelemetryChannel::publishQuality(int tier, float processingLoad, int numChanges) noexcept {
+    qualityTier_.store(tier, std::memory_order_relaxed);
+    processingLoad_.store(processingLoad, std::memory_order_relaxed);
+    numQualityChanges_.store(numChanges, std::memory_order_relaxed);
+}
+
+void TelemetryChannel::publishNonFiniteBlocks(int numBlocks) noexcept {
+    numNonFiniteBlocks_.store(numBlocks, std::memory_order_relaxed);
+}
+
+bool TelemetryChannel::drain() noexcept {
+    QB_TRACE_SCOPE("analyseMeters");
+    // Views that subscribe after a gap start the correlation afresh rather than from audio they never showed.
+    const bool subscribed = subscribers_.load(std::memory_order_relaxed) > 0;
+    if (subscribed && !wasSubscribed_)
+        correlationAnalyzer_.reset();
+    wasSubscribed_ = subscribed;
+
+    const double sampleRate = sampleRate_.load(std::memory_order_relaxed);
+    const bool metersPrepared = sampleRate > 0.0;
+    const bool resetRequested = loudnessResetPending_.exchange(false, std::memory_order_relaxed);
+    if (sampleRate != meterSampleRate_ && metersPrepared) {
+        loudnessAnalyzer_.prepare(sampleRate);
+        truePeakMeter_.prepare(sampleRate);
+        publishMeters();
+    } else if (resetRequested && metersPrepared) {
+        loudnessAnalyzer_.reset();
+        truePeakMeter_.reset();
+        publishMeters();
+    }
+    meterSampleRate_ = sampleRate;
+
+    bool analysed = false;
+    int numFrames = 0;
+    while ((numFrames = outputRing_.pop(drainFrames_.data(), kDrainChunkFrames)) > 0) {
+        for (int i = 0; i < numFrames; ++i) {
+            const auto& frame = drainFrames_[static_cast<size_t>(i)];
+            drainLeft_[static_cast<size_t>(i)] = frame.left;
+            drainRight_[static_cast<size_t>(i)] = frame.right;
+
+            // Decimate to not overwhelm UI buffer
+            if (subscribed && goniometerPhase_ == 0)
+                goniometerRing_.push(&frame, 1);
+            goniometerPhase_ = (goniometerPhase_ + 1) % kGoniometerDecimation;
+        }
+
+        if (subscribed)
+            correlationAnalyzer_.processBlock(drainLeft_.data(), drainRight_.data(), numFrames);
+        if (metersPrepared) {
+            loudnessAnalyzer_.processBlock(drainLeft_.data(), drainRight_.data(), numFrames);
+            truePeakMeter_.processBlock(drainLeft_.data(), drainRight_.data(), numFrames);
+        }
+        analysed = true;
+    }
+
+    if (analysed) {
+        correlation_.store(correlationAnalyzer_.getCorrelation(), std::memory_order_relaxed);
+        if (metersPrepared)
+            publishMeters();
+        analysisSequence_.fetch_add(1, std::memory_order_release);
+    }
+
+    return analysed;
+}
+
+void TelemetryChannel::publishMeters() noexcept {
+    truePeakDb_.store(truePeakMeter_.getPeakDb(), std::memory_order_relaxed);
+    momentaryLufs_.store(loudnessAnalyzer_.getMomentaryLufs(), std::memory_order_relaxed);
+    shortTermLufs_.store(loudnessAnalyzer_.getShortTermLufs(), std::memory_order_relaxed);
+    integratedLufs_.store(loudnessAnalyzer_.getIntegratedLufs(), std::memory_order_relaxed);
+}
+
+void TelemetryChannel::subscribe() noexcept {
+    subscribers_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TelemetryChannel::unsubscribe() noexcept {
+    subscribers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+float TelemetryChannel::getCorrelation() const noexcept {
+    return correlation_.load(std::memory_order_relaxed);
+}
+
+float TelemetryChannel::getTruePeakDb() const noexcept {
+    return truePeakDb_.load(std::memory_order_relaxed);
+}
+
+float TelemetryChannel::getMomentaryLufs() const noexcept {
+    return momentaryLufs_.load(std::memory_order_relaxed);
+}
+
+float TelemetryChannel::getShortTermLufs() const noexcept {
+    return shortTermLufs_.load(std::memory_order_relaxed);
+}
+
+float TelemetryChannel::getIntegratedLufs() const noexcept {
+    return integratedLufs_.load(std::memory_order_relaxed);
+}
+
+void TelemetryChannel::resetLoudness() noexcept {
+    loudnessResetPending_.store(true, std::memory_order_relaxed);
+}
+
+int TelemetryChannel::getQualityTier() const noexcept {
+    return qualityTier_.load(std::memory_order_relaxed);
+}
+
+float TelemetryChannel::getProcessingLoad() const noexcept {
+    return processingLoad_.load(std::memory_order_relaxed);
+}
+
+int TelemetryChannel::getNumQualityChanges() const noexcept {
+    return numQualityChanges_.load(std::memory_order_relaxed);
+}
+
+int TelemetryChannel::getNumNonFiniteBlocks() const noexcept {
+    return numNonFiniteBlocks_.load(std::memory_order_relaxed);
+}
+
+int TelemetryChannel::popGoniometerPoints(StereoFrame* dest, int maxCount) noexcept {
+    return goniometerRing_.pop(dest, maxCount);
+}
+
+juce::uint32 TelemetryChannel::getAnalysisSequence() const noexcept {
+    return analysisSequence_.load(std::memory_order_acquire);
+}
+
+} // namespace util
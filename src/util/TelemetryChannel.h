@@ -0,0 +1,106 @@
+#pragma once
+
+#include "SpscRing.h"
+#include "dsp/CorrelationAnalyzer.h"
+#include "dsp/LoudnessAnalyzer.h"
+#include "dsp/TruePeakMeter.h"
+#include <atomic>
+#include <juce_core/juce_core.h>
+#include <limits>
+#include <vector>
+
+namespace util {
+
+struct StereoFrame {
+    float left = 0.0f;
+    float right = 0.0f;
+};
+
+// Per-processor link between the audio thread, the shared AnalysisWorker and any open editor.
+//
+// - Audio thread: pushOutputBlock() only copies the output block into a wait-free ring, once the sample rate is known
+//   or while a view is subscribed.
+// - Analysis worker: drain() runs all meter math and publishes results. Loudness and true peak accumulate whether or
+//   not an editor is open, so integrated loudness covers everything the instance played; correlation and the
+//   goniometer only run while a view is subscribed.
+// - Message thread: views subscribe() and read the published results.
+//
+// The channel is owned by the processor, which outlives its editor, so views never hand pointers to themselves to
+// another thread.
+class TelemetryChannel final {
+  public:
+    static constexpr int kOutputRingFrames = 1 << 14;
+    static constexpr int kGoniometerRingFrames = 2048;
+    static constexpr int kGoniometerDecimation = 4;
+
+    TelemetryChannel();
+
+    // Any thread. The loudness and true-peak meters need the output rate; the worker re-prepares them (and starts
+    // them from scratch) on its next drain after the rate changes. Until then they stay silent.
+    void setSampleRate(double sampleRate) noexcept;
+
+    // Audio thread.
+    void pushOutputBlock(const float* left, const float* right, int numSamples) noexcept;
+    // Adaptive quality state from QuadraBassEngine, published every block whether or not a view is subscribed.
+    void publishQuality(int tier, float processingLoad, int numChanges) noexcept;
+    // QuadraBassEngine::getNumNonFiniteBlocks(), published every block like the quality state.
+    void publishNonFiniteBlocks(int numBlocks) noexcept;
+
+    // Analysis worker. Returns true when new frames were analysed.
+    bool drain() noexcept;
+
+    // Message thread.
+    void subscribe() noexcept;
+    void unsubscribe() noexcept;
+    float getCorrelation() const noexcept;
+    float getTruePeakDb() const noexcept;
+    float getMomentaryLufs() const noexcept;
+    float getShortTermLufs() const noexcept;
+    float getIntegratedLufs() const noexcept;
+    // Restarts the integrated loudness and the true-peak hold on the worker's next drain.
+    void resetLoudness() noexcept;
+    int getQualityTier() const noexcept;
+    float getProcessingLoad() const noexcept;
+    int getNumQualityChanges() const noexcept;
+    int getNumNonFiniteBlocks() const noexcept;
+    int popGoniometerPoints(StereoFrame* dest, int maxCount) noexcept;
+    juce::uint32 getAnalysisSequence() const noexcept;
+
+  private:
+    static constexpr int kDrainChunkFrames = 1024;
+
+    void publishMeters() noexcept;
+
+    SpscRing<StereoFrame> outputRing_{kOutputRingFrames};
+    SpscRing<StereoFrame> goniometerRing_{kGoniometerRingFrames};
+    std::atomic<int> subscribers_{0};
+
+    // Worker-only state.
+    qbdsp::CorrelationAnalyzer correlationAnalyzer_;
+    qbdsp::LoudnessAnalyzer loudnessAnalyzer_;
+    qbdsp::TruePeakMeter truePeakMeter_;
+    double meterSampleRate_ = 0.0;
+    std::vector<StereoFrame> drainFrames_;
+    std::vector<float> drainLeft_;
+    std::vector<float> drainRight_;
+    int goniometerPhase_ = 0;
+    bool wasSubscribed_ = false;
+
+    // Published results.
+    std::atomic<float> correlation_{1.0f};
+    std::atomic<float> truePeakDb_{-100.0f};
+    std::atomic<float> momentaryLufs_{-std::numeric_limits<float>::infinity()};
+    std::atomic<float> shortTermLufs_{-std::numeric_limits<float>::infinity()};
+    std::atomic<float> integratedLufs_{-std::numeric_limits<float>::infinity()};
+    std::atomic<double> sampleRate_{0.0};
+    std::atomic<bool> loudnessResetPending_{false};
+    std::atomic<juce::uint32> analysisSequence_{0};
+    std::atomic<int> qualityTier_{0};
+    std::atomic<float> processingLoad_{0.0f};
+    std::atomic<int> numQualityChanges_{0};
+    std::atomic<int> numNonFiniteBlocks_{0};
+
+    JUCE_DECLARE_NON_COPYABLE(TelemetryChannel)
+};
+
+} // namespace util
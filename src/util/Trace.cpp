@@ -0,0 +1,176 @@
+#include "Trace.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace util {
+
+namespace {
+
+struct Event {
+    const char* name = nullptr;
+    juce::int64 startTicks = 0;
+    juce::int64 endTicks = 0;
+};
+
+// Written only by its owning thread. Readers copy the ring and then drop anything the writer may have overwritten
+// while they were copying, so a dump never blocks the audio thread.
+struct ThreadBuffer {
+    std::array<Event, static_cast<size_t>(Trace::kEventsPerThread)> events;
+    std::atomic<juce::uint32> written{0};
+    // Events before this index were recorded by an earlier thread that has since exited.
+    std::atomic<juce::uint32> firstOwnEvent{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<int> threadIndex{0};
+    std::atomic<bool> inUse{true};
+};
+
+// Owns every ring. A ring is handed to a new thread once its thread exits, so the rings never outnumber the threads
+// that were tracing at the same time, however many short-lived worker threads come and go.
+struct Registry {
+    juce::SpinLock lock;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    int numThreads = 0;
+};
+
+Registry& getRegistry() {
+    static Registry registry;
+    return registry;
+}
+
+// Releases the thread's ring when the thread exits. Thread-local objects are destroyed before the registry.
+struct BufferLease {
+    ThreadBuffer* buffer = nullptr;
+
+    ~BufferLease() {
+        if (buffer != nullptr)
+            buffer->inUse.store(false, std::memory_order_release);
+    }
+};
+
+thread_local BufferLease currentLease;
+
+ThreadBuffer& getCurrentBuffer() {
+    if (currentLease.buffer == nullptr) {
+        auto& registry = getRegistry();
+        const juce::SpinLock::ScopedLockType sl(registry.lock);
+        ThreadBuffer* buffer = nullptr;
+        for (auto& candidate : registry.buffers) {
+            if (!candidate->inUse.load(std::memory_order_acquire)) {
+                buffer = candidate.get();
+                break;
+            }
+        }
+
+        if (buffer == nullptr) {
+            registry.buffers.push_back(std::make_unique<ThreadBuffer>());
+            buffer = registry.buffers.back().get();
+        }
+
+        buffer->inUse.store(true, std::memory_order_relaxed);
+        buffer->firstOwnEvent.store(buffer->written.load(std::memory_order_relaxed), std::memory_order_release);
+        buffer->name.store(nullptr, std::memory_order_release);
+        buffer->threadIndex.store(++registry.numThreads, std::memory_order_release);
+        currentLease.buffer = buffer;
+    }
+
+    return *currentLease.buffer;
+}
+
+void writeJsonString(juce::OutputStream& out, const char* text) {
+    out << "\"";
+    for (const char* c = text; *c != 0; ++c) {
+        if (*c == '"' || *c == '\\')
+            out << "\\";
+        out.writeByte(*c);
+    }
+    out << "\"";
+}
+
+} // namespace
+
+Trace::Scope::Scope(const char* name) noexcept
+    : name_(name), startTicks_(juce::Time::getHighResolutionTicks()) {}
+
+Trace::Scope::~Scope() {
+    record(name_, startTicks_, juce::Time::getHighResolutionTicks());
+}
+
+void Trace::record(const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept {
+    auto& buffer = getCurrentBuffer();
+    const auto index = buffer.written.load(std::memory_order_relaxed);
+    buffer.events[index % static_cast<juce::uint32>(kEventsPerThread)] = Event{name, startTicks, endTicks};
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void Trace::setCurrentThreadName(const char* name) noexcept {
+    auto& buffer = getCurrentBuffer();
+    if (buffer.name.load(std::memory_order_relaxed) != name)
+        buffer.name.store(name, std::memory_order_release);
+}
+
+void Trace::writeChromeJson(juce::OutputStream& out) {
+    std::vector<ThreadBuffer*> buffers;
+    {
+        auto& registry = getRegistry();
+        const juce::SpinLock::ScopedLockType sl(registry.lock);
+        for (auto& buffer : registry.buffers)
+            buffers.push_back(buffer.get());
+    }
+
+    const double microsPerTick = 1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    const auto capacity = static_cast<juce::uint32>(kEventsPerThread);
+    std::vector<Event> snapshot;
+    snapshot.reserve(static_cast<size_t>(kEventsPerThread));
+    bool first = true;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (auto* buffer : buffers) {
+        const auto end = buffer->written.load(std::memory_order_acquire);
+        const auto begin = end > capacity ? end - capacity : 0u;
+
+        snapshot.clear();
+        for (auto i = begin; i < end; ++i)
+            snapshot.push_back(buffer->events[i % capacity]);
+
+        // Anything older than one ring behind the writer's current position may have been overwritten mid-copy,
+        // and the slot of event writtenAfterCopy - capacity may be mid-write right now.
+        const auto writtenAfterCopy = buffer->written.load(std::memory_order_acquire);
+        const auto firstValid = juce::jmax(writtenAfterCopy >= capacity ? writtenAfterCopy - capacity + 1 : 0u,
+                                           buffer->firstOwnEvent.load(std::memory_order_acquire));
+
+        const int threadIndex = buffer->threadIndex.load(std::memory_order_acquire);
+        const char* threadName = buffer->name.load(std::memory_order_acquire);
+        out << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << threadIndex << ",\"args\":{\"name\":";
+        writeJsonString(out, threadName != nullptr ? threadName : "Unnamed thread");
+        out << "}}";
+        first = false;
+
+        for (auto i = juce::jmax(begin, firstValid); i < end; ++i) {
+            const auto& event = snapshot[static_cast<size_t>(i - begin)];
+            out << ",{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadIndex
+                << ",\"ts\":" << juce::String(static_cast<double>(event.startTicks) * microsPerTick, 3)
+                << ",\"dur\":"
+                << juce::String(static_cast<double>(event.endTicks - event.startTicks) * microsPerTick, 3) << "}";
+        }
+    }
+    out << "]}\n";
+}
+
+bool Trace::dumpToFile(const juce::File& file) {
+    juce::FileOutputStream stream(file);
+    if (!stream.openedOk())
+        return false;
+
+    stream.setPosition(0);
+    stream.truncate();
+    writeChromeJson(stream);
+    stream.flush();
+    return stream.getStatus().wasOk();
+}
+
+} // namespace util
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#ifndef QUADRABASS_ENABLE_TRACING
+#define QUADRABASS_ENABLE_TRACING 0
+#endif
+
+namespace util {
+
+// Optional timeline tracing (configure with -DQUADRABASS_ENABLE_TRACING=ON). Scoped events are recorded into a
+// fixed-size ring per thread; recording is wait-free and never takes a lock after a thread's first event, which
+// takes a ring (one left by an exited thread, or a new allocation). writeChromeJson() produces a Chrome trace
+// ("traceEvents") file that chrome://tracing and Perfetto open directly. It keeps up to kEventsPerThread - 1 events
+// per ring, since the oldest slot may be mid-write.
+//
+// Event and thread names must be string literals: only the pointer is stored.
+class Trace final {
+  public:
+    static constexpr int kEventsPerThread = 1 << 14;
+
+    class Scope final {
+      public:
+        explicit Scope(const char* name) noexcept;
+        ~Scope();
+
+      private:
+        const char* name_;
+        juce::int64 startTicks_;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    static void record(const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept;
+    static void setCurrentThreadName(const char* name) noexcept;
+
+    // Snapshot of the newest events from every thread. Safe to call from any thread while others keep recording.
+    static void writeChromeJson(juce::OutputStream& out);
+    static bool dumpToFile(const juce::File& file);
+};
+
+} // namespace util
+
+#if QUADRABASS_ENABLE_TRACING
+#define QB_TRACE_CONCAT_INNER(a, b) a##b
+#define QB_TRACE_CONCAT(a, b) QB_TRACE_CONCAT_INNER(a, b)
+#define QB_TRACE_SCOPE(name) const ::util::Trace::Scope QB_TRACE_CONCAT(qbTraceScope_, __LINE__)(name)
+#define QB_TRACE_THREAD_NAME(name) ::util::Trace::setCurrentThreadName(name)
+#else
+#define QB_TRACE_SCOPE(name) ((void)0)
+#define QB_TRACE_THREAD_NAME(name) ((void)0)
+#endif
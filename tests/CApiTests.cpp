@@ -0,0 +1,347 @@
+#include "../src/capi/quadrabass.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool expect(bool condition, const std::string& message) {
+    if (condition)
+        return true;
+    std::cerr << "FAIL: " << message << '\n';
+    return false;
+}
+
+constexpr double kSampleRate = 48000.0;
+constexpr int kMaxBlock = 512;
+constexpr double kTwoPi = 6.283185307179586;
+
+struct StereoSignal {
+    std::vector<float> left;
+    std::vector<float> right;
+};
+
+StereoSignal makeSignal(int samples) {
+    StereoSignal signal;
+    signal.left.resize(static_cast<size_t>(samples));
+    signal.right.resize(static_cast<size_t>(samples));
+    for (int i = 0; i < samples; ++i) {
+        const double t = static_cast<double>(i) / kSampleRate;
+        signal.left[static_cast<size_t>(i)] = static_cast<float>(0.5 * std::sin(kTwoPi * 110.0 * t));
+        signal.right[static_cast<size_t>(i)] = static_cast<float>(0.3 * std::sin(kTwoPi * 220.0 * t + 0.4));
+    }
+    return signal;
+}
+
+qb_engine* createPrepared(float widthPercent) {
+    qb_engine* engine = qb_create();
+    if (engine == nullptr)
+        return nullptr;
+
+    qb_set_param(engine, QB_PARAM_WIDTH_PERCENT, widthPercent);
+    if (qb_prepare(engine, kSampleRate, kMaxBlock, 2) != QB_OK) {
+        qb_destroy(engine);
+        return nullptr;
+    }
+    return engine;
+}
+
+bool testLifecycleAndValidation() {
+    bool ok = true;
+    ok &= expect(qb_get_api_version() == QB_API_VERSION, "API version should match the header");
+
+    qb_engine* engine = qb_create();
+    ok &= expect(engine != nullptr, "qb_create should return an instance");
+    if (engine == nullptr)
+        return false;
+
+    float sample = 0.0f;
+    float* channels[2] = {&sample, &sample};
+    ok &= expect(qb_process(engine, channels, channels, 1) == QB_ERROR_NOT_PREPARED,
+                 "Processing before prepare should be rejected");
+    ok &= expect(qb_prepare(engine, kSampleRate, kMaxBlock, 3) == QB_ERROR_INVALID_ARGUMENT,
+                 "Only mono and stereo should be accepted");
+    ok &= expect(qb_prepare(engine, 0.0, kMaxBlock, 2) == QB_ERROR_INVALID_ARGUMENT,
+                 "A zero sample rate should be rejected");
+    ok &= expect(qb_prepare(engine, kSampleRate, 0, 2) == QB_ERROR_INVALID_ARGUMENT,
+                 "A zero block size should be rejected");
+    ok &= expect(qb_set_param(engine, static_cast<qb_param>(6), 1.0f) == QB_ERROR_INVALID_ARGUMENT,
+                 "Unknown parameters should be rejected");
+    ok &= expect(qb_get_param(engine, QB_PARAM_WIDTH_PERCENT, nullptr) == QB_ERROR_INVALID_ARGUMENT,
+                 "A null output pointer should be rejected");
+
+    float value = -1.0f;
+    ok &= expect(qb_get_param(engine, QB_PARAM_HILBERT_MODE, &value) == QB_OK && std::abs(value - 1.0f) < 1e-6f,
+                 "Hilbert mode should default to FIR");
+    ok &= expect(qb_get_param(engine, QB_PARAM_PHASE_ANGLE_DEG, &value) == QB_OK && std::abs(value - 90.0f) < 1e-6f,
+                 "Phase angle should default to 90 degrees");
+
+    qb_set_param(engine, QB_PARAM_WIDTH_PERCENT, 150.0f);
+    qb_get_param(engine, QB_PARAM_WIDTH_PERCENT, &value);
+    ok &= expect(std::abs(value - 100.0f) < 1e-6f, "Width should clamp to 100%");
+    qb_set_param(engine, QB_PARAM_OUTPUT_GAIN_DB, -200.0f);
+    qb_get_param(engine, QB_PARAM_OUTPUT_GAIN_DB, &value);
+    ok &= expect(std::abs(value + 60.0f) < 1e-6f, "Output gain should clamp to -60 dB");
+
+    ok &= expect(qb_prepare(engine, kSampleRate, kMaxBlock, 2) == QB_OK, "Prepare should succeed");
+    const int firLatency = qb_get_latency_samples(engine);
+    ok &= expect(firLatency > 0, "FIR mode should report latency");
+
+    qb_set_param(engine, QB_PARAM_HILBERT_MODE, 0.0f);
+    ok &= expect(qb_get_latency_samples(engine) == 0, "IIR mode should report zero latency");
+    qb_set_param(engine, QB_PARAM_HILBERT_MODE, 1.0f);
+    ok &= expect(qb_get_latency_samples(engine) == firLatency, "Switching back to FIR should restore its latency");
+    qb_set_param(engine, QB_PARAM_MONO_BASS, 4.0f);
+    const int monoBassLatency = qb_get_latency_samples(engine);
+    ok &= expect(monoBassLatency > 0 && monoBassLatency < firLatency,
+                 "A 120 Hz mono-bass crossover should shorten the FIR latency");
+    qb_set_param(engine, QB_PARAM_MONO_BASS, 0.0f);
+    ok &= expect(qb_get_latency_samples(engine) == firLatency, "Mono bass off should restore the FIR latency");
+    ok &= expect(qb_reset(engine) == QB_OK, "Reset should succeed once prepared");
+
+    qb_destroy(engine);
+    qb_destroy(nullptr);
+    return ok;
+}
+
+bool testZeroWidthCollapsesToMono() {
+    constexpr int samples = 8192;
+    qb_engine* engine = createPrepared(0.0f);
+    if (!expect(engine != nullptr, "Engine should prepare"))
+        return false;
+
+    auto signal = makeSignal(samples);
+    float* channels[2] = {signal.left.data(), signal.right.data()};
+    const bool processed = qb_process(engine, channels, channels, samples) == QB_OK;
+    qb_destroy(engine);
+
+    double diff = 0.0;
+    double energy = 0.0;
+    for (size_t i = 0; i < signal.left.size(); ++i) {
+        const double d = static_cast<double>(signal.left[i]) - static_cast<double>(signal.right[i]);
+        diff += d * d;
+        energy += static_cast<double>(signal.left[i]) * static_cast<double>(signal.left[i]);
+    }
+
+    bool ok = expect(processed, "In-place processing should succeed");
+    ok &= expect(energy > 0.0, "Zero width should still pass the downmixed signal");
+    ok &= expect(diff <= energy * 1e-12, "Zero width should produce identical channels");
+    return ok;
+}
+
+bool testBlockSplittingIsTransparent() {
+    constexpr int samples = 5000;
+    const auto signal = makeSignal(samples);
+
+    // One oversized out-of-place call against the same audio fed in host-sized blocks.
+    qb_engine* whole = createPrepared(100.0f);
+    qb_engine* blocked = createPrepared(100.0f);
+    if (!expect(whole != nullptr && blocked != nullptr, "Engines should prepare")) {
+        qb_destroy(whole);
+        qb_destroy(blocked);
+        return false;
+    }
+
+    std::vector<float> wholeLeft(static_cast<size_t>(samples));
+    std::vector<float> wholeRight(static_cast<size_t>(samples));
+    const float* inputs[2] = {signal.left.data(), signal.right.data()};
+    float* outputs[2] = {wholeLeft.data(), wholeRight.data()};
+    bool ok = expect(qb_process(whole, inputs, outputs, samples) == QB_OK, "Oversized blocks should be accepted");
+
+    auto blockedSignal = signal;
+    for (int start = 0; start < samples; start += 300) {
+        const int count = std::min(300, samples - start);
+        float* channels[2] = {blockedSignal.left.data() + start, blockedSignal.right.data() + start};
+        ok &= expect(qb_process(blocked, channels, channels, count) == QB_OK, "Host-sized blocks should process");
+    }
+
+    qb_destroy(whole);
+    qb_destroy(blocked);
+
+    ok &= expect(std::memcmp(wholeLeft.data(), blockedSignal.left.data(), sizeof(float) * wholeLeft.size()) == 0 &&
+                     std::memcmp(wholeRight.data(), blockedSignal.right.data(), sizeof(float) * wholeRight.size()) == 0,
+                 "Output should not depend on how the caller splits blocks");
+    return ok;
+}
+
+bool testSwappedChannelsAreStaged() {
+    constexpr int samples = 5000;
+    const auto signal = makeSignal(samples);
+
+    qb_engine* reference = createPrepared(100.0f);
+    qb_engine* swapped = createPrepared(100.0f);
+    if (!expect(reference != nullptr && swapped != nullptr, "Engines should prepare")) {
+        qb_destroy(reference);
+        qb_destroy(swapped);
+        return false;
+    }
+
+    std::vector<float> referenceLeft(static_cast<size_t>(samples));
+    std::vector<float> referenceRight(static_cast<size_t>(samples));
+    const float* inputs[2] = {signal.left.data(), signal.right.data()};
+    float* outputs[2] = {referenceLeft.data(), referenceRight.data()};
+    bool ok = expect(qb_process(reference, inputs, outputs, samples) == QB_OK, "Out-of-place process should work");
+
+    // Each output channel is the other channel's input, so the left output lands in the right input's buffer.
+    auto crossed = signal;
+    const float* crossedInputs[2] = {crossed.left.data(), crossed.right.data()};
+    float* crossedOutputs[2] = {crossed.right.data(), crossed.left.data()};
+    ok &= expect(qb_process(swapped, crossedInputs, crossedOutputs, samples) == QB_OK,
+                 "Swapped channel pointers should be accepted");
+
+    qb_destroy(reference);
+    qb_destroy(swapped);
+
+    const size_t bytes = sizeof(float) * static_cast<size_t>(samples);
+    ok &= expect(std::memcmp(referenceLeft.data(), crossed.right.data(), bytes) == 0 &&
+                     std::memcmp(referenceRight.data(), crossed.left.data(), bytes) == 0,
+                 "Swapped channel pointers should not corrupt the input before it is read");
+    return ok;
+}
+
+bool testBatchMatchesSingleEngines() {
+    // More streams than one kernel tile, and enough samples to wrap the batch history.
+    constexpr int numStreams = 70;
+    constexpr int samples = 2600;
+
+    qb_batch* batch = qb_batch_create();
+    if (!expect(batch != nullptr, "qb_batch_create should return an instance"))
+        return false;
+
+    bool ok = true;
+    ok &= expect(qb_batch_set_stream_param(batch, 0, QB_PARAM_WIDTH_PERCENT, 50.0f) == QB_ERROR_NOT_PREPARED,
+                 "Batch parameters need a prepared stream count");
+    ok &= expect(qb_batch_prepare(batch, kSampleRate, 0) == QB_ERROR_INVALID_ARGUMENT,
+                 "A batch needs at least one stream");
+    ok &= expect(qb_batch_prepare(batch, kSampleRate, numStreams) == QB_OK, "Batch prepare should succeed");
+    ok &= expect(qb_batch_set_stream_param(batch, numStreams, QB_PARAM_WIDTH_PERCENT, 50.0f) ==
+                     QB_ERROR_INVALID_ARGUMENT,
+                 "Out-of-range streams should be rejected");
+    ok &= expect(qb_batch_set_stream_param(batch, 0, QB_PARAM_HILBERT_MODE, 0.0f) == QB_ERROR_INVALID_ARGUMENT,
+                 "Batch streams should only accept matrix parameters");
+
+    std::vector<qb_engine*> engines;
+    std::vector<std::vector<float>> signals;
+    std::vector<std::vector<float>> expectedLeft, expectedRight;
+    for (int stream = 0; stream < numStreams; ++stream) {
+        // Stream 0 stays at width 0, where the Q convolution is skipped.
+        const float width = static_cast<float>((stream * 37) % 101);
+        const float angle = static_cast<float>((stream * 53) % 181);
+        const float rotation = static_cast<float>((stream * 71) % 361 - 180);
+        qb_batch_set_stream_param(batch, stream, QB_PARAM_WIDTH_PERCENT, width);
+        qb_batch_set_stream_param(batch, stream, QB_PARAM_PHASE_ANGLE_DEG, angle);
+        qb_batch_set_stream_param(batch, stream, QB_PARAM_PHASE_ROTATION_DEG, rotation);
+
+        qb_engine* engine = createPrepared(width);
+        if (engine == nullptr)
+            break;
+        qb_set_param(engine, QB_PARAM_PHASE_ANGLE_DEG, angle);
+        qb_set_param(engine, QB_PARAM_PHASE_ROTATION_DEG, rotation);
+        engines.push_back(engine);
+
+        std::vector<float> signal(static_cast<size_t>(samples));
+        for (int i = 0; i < samples; ++i)
+            signal[static_cast<size_t>(i)] = static_cast<float>(
+                0.5 * std::sin(kTwoPi * (60.0 + 13.0 * stream) * static_cast<double>(i) / kSampleRate + stream));
+        signals.push_back(signal);
+
+        // Both input channels carry the stream, so the engine's downmix reproduces it exactly.
+        std::vector<float> left = signal;
+        std::vector<float> right = signal;
+        float* channels[2] = {left.data(), right.data()};
+        qb_process(engine, channels, channels, samples);
+        expectedLeft.push_back(left);
+        expectedRight.push_back(right);
+    }
+    ok &= expect(static_cast<int>(engines.size()) == numStreams, "Reference engines should prepare");
+    ok &= expect(qb_batch_get_latency_samples(batch) == qb_get_latency_samples(engines.front()),
+                 "Batch latency should match FIR mode");
+
+    // In place on the left outputs, in uneven blocks.
+    std::vector<std::vector<float>> left = signals;
+    std::vector<std::vector<float>> right(static_cast<size_t>(numStreams), std::vector<float>(samples));
+    for (int start = 0; start < samples;) {
+        const int count = std::min(start == 0 ? 700 : 1100, samples - start);
+        std::vector<const float*> inputs;
+        std::vector<float*> leftOutputs, rightOutputs;
+        for (int stream = 0; stream < numStreams; ++stream) {
+            inputs.push_back(left[static_cast<size_t>(stream)].data() + start);
+            leftOutputs.push_back(left[static_cast<size_t>(stream)].data() + start);
+            rightOutputs.push_back(right[static_cast<size_t>(stream)].data() + start);
+        }
+        ok &= expect(qb_batch_process(batch, inputs.data(), leftOutputs.data(), rightOutputs.data(), count) == QB_OK,
+                     "Batch processing should succeed");
+        start += count;
+    }
+
+    float maxError = 0.0f;
+    for (size_t stream = 0; stream < engines.size(); ++stream) {
+        for (size_t i = 0; i < static_cast<size_t>(samples); ++i) {
+            maxError = std::max(maxError, std::abs(left[stream][i] - expectedLeft[stream][i]));
+            maxError = std::max(maxError, std::abs(right[stream][i] - expectedRight[stream][i]));
+        }
+    }
+    if (maxError > 1.0e-6f)
+        std::cerr << "Batch max error against single engines: " << maxError << '\n';
+    ok &= expect(maxError <= 1.0e-6f, "Each batch stream should match a single engine with the same parameters");
+
+    for (auto* engine : engines)
+        qb_destroy(engine);
+    qb_batch_destroy(batch);
+    qb_batch_destroy(nullptr);
+    return ok;
+}
+
+} // namespace
+
+bool testAutoModeReportsStableLatency() {
+    qb_engine* first = qb_create();
+    qb_engine* second = qb_create();
+    if (!expect(first != nullptr && second != nullptr, "Engines should be created")) {
+        qb_destroy(first);
+        qb_destroy(second);
+        return false;
+    }
+
+    bool ok = true;
+    for (qb_engine* engine : {first, second}) {
+        qb_set_param(engine, QB_PARAM_HILBERT_MODE, 4.0f);
+        ok &= expect(qb_prepare(engine, kSampleRate, kMaxBlock, 2) == QB_OK, "Auto mode should prepare");
+    }
+
+    float value = -1.0f;
+    qb_get_param(first, QB_PARAM_HILBERT_MODE, &value);
+    ok &= expect(std::abs(value - 4.0f) < 1e-6f, "Auto should stay the stored mode value");
+
+    // Auto always resolves to a linear-phase mode, and the same spec resolves the same way every time.
+    const int autoLatency = qb_get_latency_samples(first);
+    ok &= expect(autoLatency > 0, "Auto mode should report the chosen mode's latency");
+    ok &= expect(qb_get_latency_samples(second) == autoLatency, "Engines with the same spec should agree");
+
+    qb_set_param(first, QB_PARAM_HILBERT_MODE, 0.0f);
+    qb_set_param(first, QB_PARAM_HILBERT_MODE, 4.0f);
+    ok &= expect(qb_get_latency_samples(first) == autoLatency, "Switching back to Auto should keep its choice");
+
+    qb_destroy(first);
+    qb_destroy(second);
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    ok &= testLifecycleAndValidation();
+    ok &= testZeroWidthCollapsesToMono();
+    ok &= testBlockSplittingIsTransparent();
+    ok &= testSwappedChannelsAreStaged();
+    ok &= testBatchMatchesSingleEngines();
+    ok &= testAutoModeReportsStableLatency();
+
+    if (!ok)
+        return 1;
+
+    std::cout << "C API tests passed.\n";
+    return 0;
+}
@@ -1,10 +1,19 @@
 #include "../src/PluginProcessor.h"
+#include "../src/dsp/AdaptiveQualityController.h"
+#include "../src/dsp/CorrelationAnalyzer.h"
+#include "../src/dsp/KernelDispatch.h"
+#include "../src/dsp/MonoBassCrossover.h"
+#include "../src/dsp/QuadraBassEngine.h"
+#include "../src/dsp/VelvetDecorrelator.h"
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -267,7 +276,7 @@ bool testHarmonicContentBalanceAndDecorrelation() {
 
 bool testParameterCountInProcessor() {
     QuadraBassAudioProcessor processor;
-    return expect(processor.getParameters().size() == 5, "Processor should expose exactly five parameters");
+    return expect(processor.getParameters().size() == 7, "Processor should expose exactly seven parameters");
 }
 
 bool testFIRModeProducesStableOutput() {
@@ -279,6 +288,542 @@ bool testFIRModeProducesStableOutput() {
     return ok;
 }
 
+bool testAdaptiveQualityController() {
+    constexpr double blockSeconds = 512.0 / 48000.0;
+    qbdsp::AdaptiveQualityController controller;
+    controller.setNumTiers(3);
+    auto run = [&controller](double load, double seconds) {
+        for (double t = 0.0; t < seconds; t += blockSeconds)
+            controller.update(load * blockSeconds, blockSeconds);
+    };
+
+    bool ok = true;
+    run(0.1, 1.0);
+    controller.update(5.0 * blockSeconds, blockSeconds);
+    ok &= expect(controller.getTier() == 0, "A single late block should not reduce quality");
+
+    run(0.8, 1.0);
+    ok &= expect(controller.getTier() == 2, "Sustained overload should step down to the cheapest tier");
+    ok &= expect(controller.getNumTransitions() == 2, "Each step down should be counted");
+
+    run(0.1, 1.5);
+    ok &= expect(controller.getTier() == 2, "Quality should only step back up after sustained headroom");
+    run(0.1, 4.5);
+    ok &= expect(controller.getTier() == 0, "Sustained headroom should restore full quality one tier at a time");
+    ok &= expect(controller.getNumTransitions() == 4, "Each step up should be counted");
+
+    // Headroom for the current tier but not for twice its cost must not oscillate.
+    run(0.8, 1.0);
+    const int transitions = controller.getNumTransitions();
+    run(0.3, 6.0);
+    ok &= expect(controller.getTier() == 2 && controller.getNumTransitions() == transitions,
+                 "Quality should hold while stepping up would overload again");
+
+    // Forty instances at 5% each never reach their own budget, but together they take two cores. Each tier halves an
+    // instance's cost.
+    std::vector<qbdsp::AdaptiveQualityController> instances(40);
+    for (auto& instance : instances) {
+        instance.setNumTiers(3);
+        instance.setSessionBudget(1.5);
+    }
+    auto runSession = [&instances](double fullQualityLoad, double seconds) {
+        for (double t = 0.0; t < seconds; t += blockSeconds) {
+            double sessionLoad = 0.0;
+            for (const auto& instance : instances)
+                sessionLoad += instance.getLoad();
+            for (auto& instance : instances) {
+                const double load = fullQualityLoad / static_cast<double>(1 << instance.getTier());
+                instance.update(load * blockSeconds, blockSeconds, sessionLoad);
+            }
+        }
+    };
+    auto allAtTier = [&instances](int tier) {
+        return std::all_of(instances.begin(), instances.end(),
+                           [tier](const auto& instance) { return instance.getTier() == tier; });
+    };
+
+    runSession(0.05, 1.0);
+    ok &= expect(allAtTier(1), "An overloaded session should step every instance down once");
+    runSession(0.05, 6.0);
+    ok &= expect(allAtTier(1) && instances.front().getNumTransitions() == 1,
+                 "Instances should hold while the session has no room for them to step up");
+    runSession(0.01, 4.0);
+    ok &= expect(allAtTier(0), "Instances should step up once the session load drops");
+
+    qbdsp::AdaptiveQualityController::SessionLoad session;
+    {
+        qbdsp::AdaptiveQualityController::SessionLoad::Contribution first(session);
+        qbdsp::AdaptiveQualityController::SessionLoad::Contribution second(session);
+        first.set(0.3);
+        second.set(0.2);
+        first.set(0.1);
+        ok &= expect(std::abs(session.getTotal() - 0.3) < 1.0e-9, "The session load should sum the latest loads");
+    }
+    ok &= expect(std::abs(session.getTotal()) < 1.0e-9, "Destroyed instances should withdraw their load");
+
+    qbdsp::QuadraBassEngine engine;
+    engine.prepare(48000.0, 512, 2);
+    engine.setAdaptiveQuality(true);
+    juce::AudioBuffer<float> buffer(2, 512);
+    for (int block = 0; block < 8; ++block) {
+        buffer.clear();
+        engine.process(buffer, 2, 2);
+    }
+    ok &= expect(engine.getProcessingLoad() > 0.0, "The engine should time its blocks when adaptive quality is on");
+    ok &= expect(engine.getSessionLoad() >= 0.999 * engine.getProcessingLoad(),
+                 "The engine should publish its load to the session");
+
+    engine.setOfflineRendering(true);
+    engine.process(buffer, 2, 2);
+    ok &= expect(engine.getQualityTier() == 0, "Offline rendering should always run full quality");
+    ok &= expect(engine.getLatencySamples() == (qbdsp::HilbertQuadratureProcessor::kBaseFIRTaps - 1) / 2,
+                 "Adaptive quality should never change latency");
+    return ok;
+}
+
+struct MidSideLevels {
+    double midDb = 0.0;
+    double sideDb = 0.0;
+};
+
+// Mid (L + R) / 2 and side (L - R) levels relative to the input, in dB, for a dual-mono sine through the engine once
+// it has settled.
+MidSideLevels measureMidSideLevels(qbdsp::QuadraBassEngine& engine, float freqHz) {
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    engine.reset();
+    const int settleBlocks = (engine.getLatencySamples() + 4 * blockSize) / blockSize;
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    double input2 = 0.0;
+    double mid2 = 0.0;
+    double side2 = 0.0;
+    for (int block = 0; block < settleBlocks + 8; ++block) {
+        for (int i = 0; i < blockSize; ++i) {
+            const float v = makeSignalSample(SignalKind::Sine, freqHz, sampleRate, block * blockSize + i);
+            buffer.setSample(0, i, v);
+            buffer.setSample(1, i, v);
+        }
+        engine.process(buffer, 2, 2);
+
+        if (block < settleBlocks)
+            continue;
+        for (int i = 0; i < blockSize; ++i) {
+            const double v = static_cast<double>(makeSignalSample(SignalKind::Sine, freqHz, sampleRate, i));
+            const double l = static_cast<double>(buffer.getSample(0, i));
+            const double r = static_cast<double>(buffer.getSample(1, i));
+            input2 += v * v;
+            mid2 += 0.25 * (l + r) * (l + r);
+            side2 += (l - r) * (l - r);
+        }
+    }
+
+    MidSideLevels levels;
+    levels.midDb = 10.0 * std::log10(std::max(mid2, 1.0e-30) / input2);
+    levels.sideDb = 10.0 * std::log10(std::max(side2, 1.0e-30) / input2);
+    return levels;
+}
+
+bool testMonoBassCrossover() {
+    constexpr double sampleRate = 48000.0;
+    bool ok = true;
+
+    // The bands sum back to the delayed input exactly, and split at the crossover frequency.
+    qbdsp::MonoBassCrossover crossover;
+    crossover.prepare(sampleRate, 0);
+    crossover.setFrequencyIndex(4);
+    ok &= expect(crossover.getFrequencyHz() == 120.0, "Index 4 should be the 120 Hz crossover");
+    const int delay = crossover.getLatencySamples();
+    constexpr int numSamples = 24000;
+    for (const float hz : {30.0f, 120.0f, 1000.0f}) {
+        crossover.reset();
+        std::vector<float> input(numSamples), low(numSamples), high(numSamples);
+        for (int i = 0; i < numSamples; ++i)
+            input[static_cast<size_t>(i)] = makeSignalSample(SignalKind::Sine, hz, sampleRate, i);
+        for (int start = 0; start < numSamples; start += 480)
+            crossover.process(input.data() + start, low.data() + start, high.data() + start, 480);
+
+        double maxError = 0.0;
+        double low2 = 0.0;
+        double high2 = 0.0;
+        for (int i = delay; i < numSamples; ++i) {
+            const auto n = static_cast<size_t>(i);
+            const auto delayed = static_cast<size_t>(i - delay);
+            maxError = std::max(maxError, static_cast<double>(std::abs(low[n] + high[n] - input[delayed])));
+            low2 += static_cast<double>(low[n]) * low[n];
+            high2 += static_cast<double>(high[n]) * high[n];
+        }
+        ok &= expect(maxError < 1.0e-5, "Low and high bands should sum to the delayed input");
+        if (hz < 100.0f)
+            ok &= expect(low2 > 100.0 * high2, "Bass well below the crossover should land in the low band");
+        if (hz > 500.0f)
+            ok &= expect(low2 < 1.0e-4 * high2, "Content above the crossover should stay out of the low band");
+    }
+
+    // Mono bass costs the crossover's delay but lets FIR mode drop to the quarter-length kernel.
+    qbdsp::QuadraBassEngine engine;
+    qbdsp::EngineParams params;
+    params.widthPercent = 100.0f;
+    engine.setParameters(params);
+    engine.prepare(sampleRate, 512, 2);
+    const int fullLatency = engine.getLatencySamples();
+    const double wideBassDb = measureMidSideLevels(engine, 40.0f).sideDb;
+
+    params.monoBassIndex = 4;
+    engine.setParameters(params);
+    const int monoBassLatency = engine.getLatencySamples();
+    ok &= expect(monoBassLatency == (qbdsp::HilbertQuadratureProcessor::kBaseFIRTaps / 4 - 1) / 2 + delay,
+                 "Mono bass latency should be the quarter-length kernel's plus the crossover's");
+    ok &= expect(2 * monoBassLatency < fullLatency, "A 120 Hz crossover should more than halve the FIR latency");
+    ok &= expect(wideBassDb > -20.0 && measureMidSideLevels(engine, 40.0f).sideDb < -30.0,
+                 "Bass well below the crossover should collapse to mono");
+    ok &= expect(measureMidSideLevels(engine, 1000.0f).sideDb > -6.0, "Width should still apply above the crossover");
+
+    // Rotation turns the stereo image above the crossover but must leave the mono bass centred and in phase.
+    const double unrotatedBassMidDb = measureMidSideLevels(engine, 40.0f).midDb;
+    for (const float rotation : {45.0f, 90.0f, -90.0f}) {
+        params.phaseRotationDeg = rotation;
+        engine.setParameters(params);
+        const auto bass = measureMidSideLevels(engine, 40.0f);
+        ok &= expect(bass.sideDb < -30.0 && std::abs(bass.midDb - unrotatedBassMidDb) < 0.5,
+                     "Rotated mono bass should keep its level and stay centred, rotation " + std::to_string(rotation));
+    }
+    params.phaseRotationDeg = 0.0f;
+
+    // At zero width the output is I plus the low band, which must line up into the delayed input at the crossover.
+    params.widthPercent = 0.0f;
+    engine.setParameters(params);
+    engine.reset();
+    juce::AudioBuffer<float> buffer(2, 512);
+    double maxError = 0.0;
+    for (int block = 0; block < 12; ++block) {
+        for (int i = 0; i < 512; ++i) {
+            const float v = makeSignalSample(SignalKind::Sine, 120.0f, sampleRate, block * 512 + i);
+            buffer.setSample(0, i, v);
+            buffer.setSample(1, i, v);
+        }
+        engine.process(buffer, 2, 2);
+        for (int i = 0; i < 512; ++i) {
+            const int delayed = block * 512 + i - monoBassLatency;
+            const float expected =
+                delayed >= 0 ? makeSignalSample(SignalKind::Sine, 120.0f, sampleRate, delayed) : 0.0f;
+            maxError = std::max(maxError, static_cast<double>(std::abs(buffer.getSample(0, i) - expected)));
+        }
+    }
+    ok &= expect(maxError < 1.0e-4, "The low band should stay aligned with the Hilbert I path");
+
+    params.hilbertModeIndex = 0;
+    engine.setParameters(params);
+    ok &= expect(engine.getLatencySamples() == 0, "IIR mode should keep zero latency and skip the crossover");
+    return ok;
+}
+
+struct NoiseStats {
+    double correlation = 0.0;
+    double foldRatio = 0.0;
+    double levelDiffDb = 0.0;
+};
+
+// Broadband white noise through the engine; velvet decorrelation is only meaningful over many frequencies at once.
+NoiseStats runNoiseThroughEngine(qbdsp::QuadraBassEngine& engine, float widthPercent) {
+    constexpr int blockSize = 512;
+    constexpr int settleBlocks = 8;
+    constexpr int captureBlocks = 96;
+
+    auto params = engine.getParameters();
+    params.widthPercent = widthPercent;
+    engine.setParameters(params);
+    engine.reset();
+
+    std::uint32_t state = 1u;
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    std::vector<float> input(blockSize);
+    double in2 = 0.0;
+    double l2 = 0.0;
+    double r2 = 0.0;
+    double lr = 0.0;
+    double fold2 = 0.0;
+    for (int block = 0; block < settleBlocks + captureBlocks; ++block) {
+        for (int i = 0; i < blockSize; ++i) {
+            state = state * 1664525u + 1013904223u;
+            input[static_cast<size_t>(i)] = static_cast<float>(state >> 8) / 8388608.0f - 1.0f;
+            buffer.setSample(0, i, input[static_cast<size_t>(i)]);
+            buffer.setSample(1, i, input[static_cast<size_t>(i)]);
+        }
+        engine.process(buffer, 2, 2);
+
+        if (block < settleBlocks)
+            continue;
+        for (int i = 0; i < blockSize; ++i) {
+            const double x = static_cast<double>(input[static_cast<size_t>(i)]);
+            const double L = static_cast<double>(buffer.getSample(0, i));
+            const double R = static_cast<double>(buffer.getSample(1, i));
+            in2 += x * x;
+            l2 += L * L;
+            r2 += R * R;
+            lr += L * R;
+            fold2 += 0.25 * (L + R) * (L + R);
+        }
+    }
+
+    NoiseStats stats;
+    stats.correlation = lr / std::sqrt(std::max(l2 * r2, 1.0e-30));
+    stats.foldRatio = std::sqrt(fold2 / in2);
+    stats.levelDiffDb = std::abs(10.0 * std::log10(std::max(l2, 1.0e-30) / std::max(r2, 1.0e-30)));
+    return stats;
+}
+
+bool testVelvetDecorrelation() {
+    bool ok = true;
+
+    qbdsp::VelvetDecorrelator velvet;
+    velvet.prepare(48000.0);
+    const auto numTaps = velvet.getTaps().size();
+    ok &= expect(numTaps >= 24 && numTaps <= 64, "The velvet kernel should stay a few dozen taps");
+    double energy = 0.0;
+    for (const auto& tap : velvet.getTaps())
+        energy += static_cast<double>(tap.gain) * tap.gain;
+    ok &= expect(std::abs(energy - 1.0) < 1.0e-5, "The velvet kernel should have unit energy");
+
+    qbdsp::QuadraBassEngine engine;
+    qbdsp::EngineParams params;
+    params.hilbertModeIndex = static_cast<int>(qbdsp::HilbertQuadratureProcessor::Mode::Velvet);
+    params.monoBassIndex = 4;
+    engine.setParameters(params);
+    engine.prepare(48000.0, 512, 2);
+    ok &= expect(engine.getActiveHilbertMode() == qbdsp::HilbertQuadratureProcessor::Mode::Velvet,
+                 "Mode index 5 should select Velvet");
+    ok &= expect(engine.getLatencySamples() == 0, "Velvet mode should add no latency and ignore mono bass");
+
+    // L = c x + s v*x and R = c x - s v*x: the fold is exactly c x and the channels decorrelate as cos(2 phi).
+    for (const float width : {0.0f, 50.0f, 100.0f}) {
+        const double phi = juce::MathConstants<double>::pi * 0.25 * width * 0.01;
+        const auto stats = runNoiseThroughEngine(engine, width);
+        const std::string label = " width=" + std::to_string(width);
+        ok &= expect(std::abs(stats.correlation - std::cos(2.0 * phi)) < 0.1,
+                     "Velvet correlation should follow the width law on noise." + label);
+        ok &= expect(std::abs(stats.foldRatio - std::cos(phi)) < 1.0e-3,
+                     "Velvet mono fold should be the width law's mid gain." + label);
+        ok &= expect(stats.levelDiffDb < 0.5, "Velvet should keep broadband L/R balance." + label);
+    }
+
+    return ok;
+}
+
+bool isBlockFinite(const juce::AudioBuffer<float>& buffer) {
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            if (!std::isfinite(buffer.getSample(ch, i)))
+                return false;
+    return true;
+}
+
+bool testNonFiniteGuard() {
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    bool ok = true;
+
+    // A NaN or Inf on the way in is zeroed before it reaches the FIR history, so the output is bit-identical to
+    // feeding a zero there, and nothing is left stuck in the history once the kernel has passed it.
+    for (const float bad : {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity()}) {
+        qbdsp::EngineParams params;
+        params.widthPercent = 100.0f;
+        qbdsp::QuadraBassEngine guarded;
+        qbdsp::QuadraBassEngine reference;
+        for (auto* engine : {&guarded, &reference}) {
+            engine->setParameters(params);
+            engine->prepare(sampleRate, blockSize, 2);
+        }
+
+        const int numBlocks = 2 * guarded.getLatencySamples() / blockSize + 4;
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::AudioBuffer<float> expected(2, blockSize);
+        bool matches = true;
+        for (int block = 0; block < numBlocks; ++block) {
+            for (int i = 0; i < blockSize; ++i) {
+                const float v = makeSignalSample(SignalKind::Saw, 220.0f, sampleRate, block * blockSize + i);
+                for (int ch = 0; ch < 2; ++ch) {
+                    buffer.setSample(ch, i, v);
+                    expected.setSample(ch, i, v);
+                }
+            }
+            if (block == 1) {
+                // The whole downmixed sample is lost, so the reference mutes both channels there.
+                buffer.setSample(0, 100, bad);
+                expected.setSample(0, 100, 0.0f);
+                expected.setSample(1, 100, 0.0f);
+            }
+            guarded.process(buffer, 2, 2);
+            reference.process(expected, 2, 2);
+            matches = matches && isBlockFinite(buffer) &&
+                      std::memcmp(buffer.getReadPointer(0), expected.getReadPointer(0), sizeof(float) * blockSize) == 0;
+        }
+        ok &= expect(matches, "Non-finite input should be processed as silence at that sample");
+        ok &= expect(guarded.getNumNonFiniteBlocks() == 1, "The guard should count the block with non-finite input");
+        ok &= expect(reference.getNumNonFiniteBlocks() == 0, "Finite input should never trip the guard");
+    }
+
+    // A finite input near FLT_MAX overflows the IIR all-pass state. The guard silences that block, resets the
+    // Hilbert filter and ramps back in, instead of leaving the state stuck at NaN.
+    qbdsp::QuadraBassEngine engine;
+    qbdsp::EngineParams params;
+    params.widthPercent = 100.0f;
+    params.hilbertModeIndex = 0;
+    engine.setParameters(params);
+    engine.prepare(sampleRate, blockSize, 2);
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    bool finite = true;
+    double rampStart = 1.0;
+    double settledPeak = 0.0;
+    for (int block = 0; block < 8; ++block) {
+        for (int i = 0; i < blockSize; ++i) {
+            const float v = makeSignalSample(SignalKind::Sine, 1000.0f, sampleRate, block * blockSize + i);
+            buffer.setSample(0, i, v);
+            buffer.setSample(1, i, v);
+        }
+        if (block == 1) {
+            buffer.setSample(0, 10, std::numeric_limits<float>::max());
+            buffer.setSample(1, 10, std::numeric_limits<float>::max());
+        }
+        engine.process(buffer, 2, 2);
+        finite = finite && isBlockFinite(buffer);
+        if (block == 2)
+            rampStart = std::abs(static_cast<double>(buffer.getSample(0, 0)));
+        if (block == 7)
+            settledPeak = static_cast<double>(buffer.getMagnitude(0, 0, blockSize));
+    }
+    ok &= expect(finite, "Overflowed filter state should never reach the output");
+    ok &= expect(engine.getNumNonFiniteBlocks() == 1, "The guard should count the overflowed block");
+    ok &= expect(rampStart < 1.0e-6, "Output should ramp back in from silence after a reset");
+    ok &= expect(settledPeak > 0.5, "Output should recover fully once the ramp is done");
+    return ok;
+}
+
+bool testAutoModeSwitchesOnlyAtReset() {
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    qbdsp::EngineParams params;
+    params.hilbertModeIndex = qbdsp::EngineParams::kAutoHilbertModeIndex;
+
+    // Both benchmarks queue on the one shared worker, so once the second has finished the first is ready too.
+    qbdsp::QuadraBassEngine playing;
+    qbdsp::QuadraBassEngine waited;
+    for (auto* engine : {&playing, &waited}) {
+        engine->setParameters(params);
+        engine->prepare(sampleRate, blockSize, 2);
+    }
+    waited.waitForAutoHilbertMode();
+    const auto chosenMode = waited.getActiveHilbertMode();
+
+    bool ok = expect(!waited.isAutoHilbertModePending(), "Waiting should apply the Auto choice");
+
+    // A finished benchmark must not change the backend or the latency while blocks are being processed.
+    const int latencyWhilePlaying = playing.getLatencySamples();
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    bool steady = true;
+    for (int block = 0; block < 32; ++block) {
+        for (int i = 0; i < blockSize; ++i) {
+            const float v = makeSignalSample(SignalKind::Saw, 110.0f, sampleRate, block * blockSize + i);
+            buffer.setSample(0, i, v);
+            buffer.setSample(1, i, v);
+        }
+        playing.process(buffer, 2, 2);
+        steady = steady && isBlockFinite(buffer) && playing.getLatencySamples() == latencyWhilePlaying &&
+                 playing.getActiveHilbertMode() == qbdsp::HilbertQuadratureProcessor::Mode::FIR;
+    }
+    ok &= expect(steady, "Auto should keep running FIR at a fixed latency until the next reset");
+
+    playing.reset();
+    ok &= expect(!playing.isAutoHilbertModePending(), "reset() should apply the finished Auto choice");
+    ok &= expect(playing.getActiveHilbertMode() == chosenMode, "reset() should switch to the benchmarked backend");
+    ok &= expect(playing.getLatencySamples() == waited.getLatencySamples(),
+                 "Latency after reset() should match the chosen backend");
+    return ok;
+}
+
+// FNV-1a over the bit patterns, so any rounding difference changes the hash.
+std::uint64_t hashFloats(std::uint64_t hash, const float* values, int count) {
+    for (int i = 0; i < count; ++i) {
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, values + i, sizeof(bits));
+        for (int byte = 0; byte < 4; ++byte) {
+            hash ^= (bits >> (8 * byte)) & 0xffu;
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+std::uint64_t hashDeterministicRender(int modeIndex, bool offlineRender) {
+    // 96 kHz, so Multirate runs its decimated path rather than FIR's.
+    constexpr double sampleRate = 96000.0;
+    constexpr int blockSize = 480;
+    constexpr int totalBlocks = 40;
+
+    qbdsp::QuadraBassEngine engine;
+    qbdsp::EngineParams params;
+    params.widthPercent = 70.0f;
+    params.hilbertModeIndex = modeIndex;
+    params.phaseAngleDeg = 75.0f;
+    params.phaseRotationDeg = 20.0f;
+    params.outputGainDb = -1.5f;
+    engine.setParameters(params);
+    engine.prepare(sampleRate, blockSize, 2);
+    engine.setOfflineRendering(offlineRender);
+    engine.setProcessingProfile(offlineRender ? qbdsp::ProcessingProfile::Render : qbdsp::ProcessingProfile::Realtime);
+
+    qbdsp::CorrelationAnalyzer correlation;
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    std::uint64_t hash = 14695981039346656037ull;
+    juce::uint32 seed = 0x5eedu;
+    for (int block = 0; block < totalBlocks; ++block) {
+        for (int i = 0; i < blockSize; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            const float noise = static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) - 0.5f;
+            const float tone = makeSignalSample(SignalKind::Saw, 97.0f, sampleRate, block * blockSize + i);
+            buffer.setSample(0, i, 0.4f * tone + 0.2f * noise);
+            buffer.setSample(1, i, 0.3f * tone - 0.1f * noise);
+        }
+
+        engine.process(buffer, 2, 2);
+        correlation.processBlock(buffer.getReadPointer(0), buffer.getReadPointer(1), blockSize);
+        hash = hashFloats(hash, buffer.getReadPointer(0), blockSize);
+        hash = hashFloats(hash, buffer.getReadPointer(1), blockSize);
+        const float meter = correlation.getCorrelation();
+        hash = hashFloats(hash, &meter, 1);
+    }
+
+    return hash;
+}
+
+bool testDeterministicOutputMatchesAcrossKernels() {
+    using Isa = qbdsp::KernelDispatch::Isa;
+    const auto originalIsa = qbdsp::KernelDispatch::getActiveIsa();
+    const bool wasDeterministic = qbdsp::KernelDispatch::isDeterministic();
+    qbdsp::KernelDispatch::setDeterministic(true);
+
+    bool ok = true;
+    for (int modeIndex = 0; modeIndex < qbdsp::EngineParams::kNumHilbertModes; ++modeIndex) {
+        for (const bool offlineRender : {false, true}) {
+            qbdsp::KernelDispatch::setIsa(Isa::Scalar);
+            const auto reference = hashDeterministicRender(modeIndex, offlineRender);
+
+            for (const auto isa : {Isa::SSE2, Isa::AVX2, Isa::AVX512, Isa::NEON}) {
+                if (!qbdsp::KernelDispatch::setIsa(isa))
+                    continue;
+                ok &= expect(hashDeterministicRender(modeIndex, offlineRender) == reference,
+                             std::string("Deterministic output should hash the same on ") +
+                                 qbdsp::KernelDispatch::getIsaName(isa) + " as on scalar, mode " +
+                                 std::to_string(modeIndex) + (offlineRender ? " (offline render)" : ""));
+            }
+        }
+    }
+
+    qbdsp::KernelDispatch::setIsa(originalIsa);
+    qbdsp::KernelDispatch::setDeterministic(wasDeterministic);
+    return ok;
+}
+
 } // namespace
 
 int main() {
@@ -290,6 +835,12 @@ int main() {
     ok &= testHarmonicContentBalanceAndDecorrelation();
     ok &= testParameterCountInProcessor();
     ok &= testFIRModeProducesStableOutput();
+    ok &= testAdaptiveQualityController();
+    ok &= testMonoBassCrossover();
+    ok &= testVelvetDecorrelation();
+    ok &= testNonFiniteGuard();
+    ok &= testAutoModeSwitchesOnlyAtReset();
+    ok &= testDeterministicOutputMatchesAcrossKernels();
 
     if (!ok)
         return 1;
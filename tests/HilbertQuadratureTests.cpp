@@ -1,6 +1,8 @@
+#include "../src/dsp/HilbertEngineSelector.h"
 #include "../src/dsp/HilbertQuadratureProcessor.h"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <vector>
 
@@ -155,61 +157,614 @@ bool testIIRRegression() {
     return expect(ok, "IIR regression checks passed");
 }
 
+std::vector<double> logSpacedFrequencies(double lowHz, double highHz, int count) {
+    std::vector<double> frequencies;
+    for (int i = 0; i < count; ++i) {
+        const double t = static_cast<double>(i) / static_cast<double>(count - 1);
+        frequencies.push_back(lowHz * std::pow(highHz / lowHz, t));
+    }
+    return frequencies;
+}
+
+bool checkAccuracyTargets(qbdsp::HilbertQuadratureProcessor::Mode mode, double sampleRate, const std::string& label,
+                          qbdsp::HilbertQuadratureProcessor::FIRCoefficientStorage storage =
+                              qbdsp::HilbertQuadratureProcessor::FIRCoefficientStorage::Float32) {
+    bool ok = true;
+    qbdsp::HilbertQuadratureProcessor processor;
+    juce::dsp::ProcessSpec spec{sampleRate, 512, 1};
+    processor.prepare(spec);
+    processor.setMode(mode);
+    processor.setFIRCoefficientStorage(storage);
+
+    ok &= expect(processor.getLatencySamples() > 0, label + " mode should report non-zero latency");
+
+    // One impulse measurement replaces per-frequency sine runs, so the band can be covered densely.
+    const auto response = processor.measureQuadratureResponse();
+
+    std::vector<double> phaseErrorsMain;
+    std::vector<double> magErrorsMain;
+    std::vector<double> edgePhaseErrors;
+
+    for (double freq : logSpacedFrequencies(30.0, sampleRate * 0.45, 400)) {
+        phaseErrorsMain.push_back(response.getQuadratureErrorDeg(freq));
+        magErrorsMain.push_back(std::abs(response.getMagnitudeMatchDb(freq)));
+    }
+
+    const double edgeFreq = std::min(sampleRate * 0.47, sampleRate * 0.5 - 200.0);
+    for (double freq = sampleRate * 0.45; freq <= edgeFreq; freq += sampleRate * 0.0025)
+        edgePhaseErrors.push_back(response.getQuadratureErrorDeg(freq));
+    edgePhaseErrors.push_back(response.getQuadratureErrorDeg(edgeFreq));
+
+    ok &= expect(!phaseErrorsMain.empty(), "Main-band " + label + " probe set should not be empty");
+    ok &= expect(!magErrorsMain.empty(), "Main-band " + label + " magnitude probe set should not be empty");
+
+    const double mainPhase95 = percentile95(phaseErrorsMain);
+    const double mainPhaseMax =
+        phaseErrorsMain.empty() ? 0.0 : *std::max_element(phaseErrorsMain.begin(), phaseErrorsMain.end());
+    const double mainMag95 = percentile95(magErrorsMain);
+    const double mainMagMax =
+        magErrorsMain.empty() ? 0.0 : *std::max_element(magErrorsMain.begin(), magErrorsMain.end());
+    const double edgePhaseMax =
+        edgePhaseErrors.empty() ? 0.0 : *std::max_element(edgePhaseErrors.begin(), edgePhaseErrors.end());
+
+    if (!(mainPhase95 <= 3.0 && mainPhaseMax <= 8.0 && mainMag95 <= 0.5 && mainMagMax <= 1.5 &&
+          edgePhaseMax <= 12.0)) {
+        std::cerr << label << " stats @" << sampleRate << " Hz: phase95=" << mainPhase95 << " phaseMax=" << mainPhaseMax
+                  << " mag95=" << mainMag95 << " magMax=" << mainMagMax << " edgePhaseMax=" << edgePhaseMax << '\n';
+    }
+
+    ok &= expect(mainPhase95 <= 3.0, label + " main-band phase error 95th percentile should be <= 3 deg");
+    ok &= expect(mainPhaseMax <= 8.0, label + " main-band phase error max should be <= 8 deg");
+    ok &= expect(mainMag95 <= 0.5, label + " main-band magnitude error 95th percentile should be <= 0.5 dB");
+    ok &= expect(mainMagMax <= 1.5, label + " main-band magnitude error max should be <= 1.5 dB");
+    ok &= expect(edgePhaseMax <= 12.0, label + " edge-band phase error max should be <= 12 deg");
+    return ok;
+}
+
 bool testFIRAccuracyTargets() {
     bool ok = true;
 
+    for (double sampleRate : {44100.0, 48000.0, 96000.0})
+        ok &= checkAccuracyTargets(qbdsp::HilbertQuadratureProcessor::Mode::FIR, sampleRate, "FIR");
+
+    return expect(ok, "FIR accuracy target checks passed");
+}
+
+bool testMultirateAccuracyTargets() {
+    bool ok = true;
+
+    for (double sampleRate : {44100.0, 96000.0, 192000.0, 384000.0})
+        ok &= checkAccuracyTargets(qbdsp::HilbertQuadratureProcessor::Mode::Multirate, sampleRate, "Multirate");
+
+    return expect(ok, "Multirate accuracy target checks passed");
+}
+
+bool testSpectralAccuracyTargets() {
+    bool ok = true;
+
     for (double sampleRate : {44100.0, 48000.0, 96000.0}) {
+        ok &= checkAccuracyTargets(qbdsp::HilbertQuadratureProcessor::Mode::Spectral, sampleRate, "Spectral");
+
         qbdsp::HilbertQuadratureProcessor processor;
-        juce::dsp::ProcessSpec spec{sampleRate, 512, 1};
-        processor.prepare(spec);
-        processor.setMode(qbdsp::HilbertQuadratureProcessor::Mode::FIR);
-        processor.reset();
+        processor.prepare({sampleRate, 512, 1});
+        processor.setMode(qbdsp::HilbertQuadratureProcessor::Mode::Spectral);
+
+        // A unit impulse must come back on I exactly at the reported latency.
+        const int latency = processor.getLatencySamples();
+        const int total = latency + 1024;
+        juce::AudioBuffer<float> iBuffer(1, total);
+        juce::AudioBuffer<float> qBuffer(1, total);
+        iBuffer.clear();
+        iBuffer.setSample(0, 0, 1.0f);
+        processor.process(iBuffer, qBuffer, 90.0f);
 
-        ok &= expect(processor.getLatencySamples() > 0, "FIR mode should report non-zero latency");
+        int peakIndex = 0;
+        for (int i = 1; i < total; ++i)
+            if (std::abs(iBuffer.getSample(0, i)) > std::abs(iBuffer.getSample(0, peakIndex)))
+                peakIndex = i;
 
-        std::vector<double> phaseErrorsMain;
-        std::vector<double> magErrorsMain;
-        std::vector<double> edgePhaseErrors;
+        ok &= expect(peakIndex == latency, "Spectral I impulse should land on the reported latency");
+        ok &= expect(std::abs(iBuffer.getSample(0, peakIndex) - 1.0f) < 1.0e-3f,
+                     "Spectral overlap-add should reconstruct the input at unity gain");
+    }
 
-        for (double freq : {30.0, 60.0, 120.0, 250.0, 500.0, 1000.0, 2000.0, 4000.0, 8000.0, 12000.0, 16000.0}) {
-            if (freq > sampleRate * 0.45)
-                continue;
+    return expect(ok, "Spectral accuracy target checks passed");
+}
+
+bool testQuadratureResponseMatchesTones() {
+    using Mode = qbdsp::HilbertQuadratureProcessor::Mode;
+    struct Case {
+        Mode mode;
+        double sampleRate;
+        const char* label;
+    };
+
+    bool ok = true;
+    for (const auto& testCase : {Case{Mode::IIR, 48000.0, "IIR"}, Case{Mode::FIR, 48000.0, "FIR"},
+                                 Case{Mode::Multirate, 96000.0, "Multirate"},
+                                 Case{Mode::Spectral, 44100.0, "Spectral"}}) {
+        qbdsp::HilbertQuadratureProcessor processor;
+        processor.prepare({testCase.sampleRate, 512, 1});
+        processor.setMode(testCase.mode);
+        const auto response = processor.measureQuadratureResponse();
+
+        ok &= expect(std::abs(response.sampleRate - testCase.sampleRate) < 1.0e-9,
+                     std::string(testCase.label) + " response should report its sample rate");
+        ok &= expect(response.frequencyHz.size() == response.phaseDifferenceDeg.size() &&
+                         response.frequencyHz.size() == response.magnitudeMatchDb.size() &&
+                         std::abs(response.frequencyHz.back() - testCase.sampleRate * 0.5) < 1.0e-6,
+                     std::string(testCase.label) + " response should cover 0 Hz to Nyquist");
+
+        // Snap to bins of measureTone's 4096-sample capture so the sine reference itself is free of leakage.
+        const double captureBinHz = testCase.sampleRate / 4096.0;
+        for (double target : {200.0, 1000.0, 8000.0}) {
+            const auto freq = static_cast<float>(std::round(target / captureBinHz) * captureBinHz);
             processor.reset();
-            const auto metrics = measureTone(processor, sampleRate, static_cast<float>(freq));
-            phaseErrorsMain.push_back(metrics.phaseErrDeg);
-            magErrorsMain.push_back(metrics.magErrDb);
+            const auto tone = measureTone(processor, testCase.sampleRate, freq);
+            const double phaseDelta = std::abs(tone.phaseErrDeg - response.getQuadratureErrorDeg(freq));
+            const double magDelta = std::abs(tone.magErrDb - std::abs(response.getMagnitudeMatchDb(freq)));
+            if (phaseDelta > 0.25 || magDelta > 0.05) {
+                std::cerr << testCase.label << " response vs tone @" << freq << " Hz: phaseDelta=" << phaseDelta
+                          << " magDelta=" << magDelta << '\n';
+                ok = false;
+            }
         }
+    }
+
+    return expect(ok, "Impulse-based quadrature response should agree with sine measurements");
+}
+
+void renderFIR(qbdsp::HilbertQuadratureProcessor& processor, const std::vector<float>& input, int blockSize,
+               std::vector<float>& iOut, std::vector<float>& qOut) {
+    const int total = static_cast<int>(input.size());
+    juce::AudioBuffer<float> iBuffer(1, blockSize);
+    juce::AudioBuffer<float> qBuffer(1, blockSize);
+    iOut.assign(input.size(), 0.0f);
+    qOut.assign(input.size(), 0.0f);
+
+    for (int start = 0; start < total; start += blockSize) {
+        const int count = std::min(blockSize, total - start);
+        iBuffer.setSize(1, count, false, false, true);
+        qBuffer.setSize(1, count, false, false, true);
+        std::copy(input.begin() + start, input.begin() + start + count, iBuffer.getWritePointer(0));
+        processor.process(iBuffer, qBuffer, 90.0f);
+        std::copy(iBuffer.getReadPointer(0), iBuffer.getReadPointer(0) + count, iOut.begin() + start);
+        std::copy(qBuffer.getReadPointer(0), qBuffer.getReadPointer(0) + count, qOut.begin() + start);
+    }
+}
 
-        const double edgeFreq = std::min(sampleRate * 0.47, sampleRate * 0.5 - 200.0);
+bool testOfflineFIRMatchesRealtime() {
+    const double sampleRate = 96000.0;
+    constexpr int realtimeBlock = 480;
+    constexpr int offlineBlock = 20000;
+    const int total = 3 * qbdsp::HilbertQuadratureProcessor::kFIRChunk + 777;
+
+    std::vector<float> input(static_cast<size_t>(total));
+    juce::uint32 seed = 12345u;
+    for (auto& sample : input) {
+        seed = seed * 1664525u + 1013904223u;
+        sample = static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+    }
+
+    qbdsp::HilbertQuadratureProcessor realtime;
+    qbdsp::HilbertQuadratureProcessor offline;
+    realtime.prepare({sampleRate, static_cast<juce::uint32>(realtimeBlock), 1});
+    offline.prepare({sampleRate, static_cast<juce::uint32>(offlineBlock), 1});
+    realtime.setMode(qbdsp::HilbertQuadratureProcessor::Mode::FIR);
+    offline.setMode(qbdsp::HilbertQuadratureProcessor::Mode::FIR);
+    offline.setOfflineRendering(true);
+
+    std::vector<float> iRealtime, qRealtime, iOffline, qOffline;
+    renderFIR(realtime, input, realtimeBlock, iRealtime, qRealtime);
+    renderFIR(offline, input, offlineBlock, iOffline, qOffline);
+
+    const size_t bytes = input.size() * sizeof(float);
+    bool ok = true;
+    ok &= expect(offline.isOfflineRendering(), "Offline rendering should be enabled");
+    ok &= expect(std::memcmp(iRealtime.data(), iOffline.data(), bytes) == 0,
+                 "Offline FIR delayed I should be bit-identical to realtime processing");
+    ok &= expect(std::memcmp(qRealtime.data(), qOffline.data(), bytes) == 0,
+                 "Offline multi-core FIR Q should be bit-identical to realtime processing");
+    return ok;
+}
+
+bool testCompactFIRCoefficients() {
+    using Processor = qbdsp::HilbertQuadratureProcessor;
+    using Storage = Processor::FIRCoefficientStorage;
+    bool ok = true;
+
+    for (double sampleRate : {44100.0, 48000.0, 96000.0}) {
+        ok &= checkAccuracyTargets(Processor::Mode::FIR, sampleRate, "FIR int16", Storage::Int16Folded);
+
+        // Quantisation cost relative to the float kernel, across the whole main band.
+        const auto reference = Processor::measureQuadratureResponse(Processor::Mode::FIR, sampleRate, Storage::Float32);
+        const auto compact =
+            Processor::measureQuadratureResponse(Processor::Mode::FIR, sampleRate, Storage::Int16Folded);
+        double phaseDeviation = 0.0;
+        double magDeviation = 0.0;
+        for (double freq : logSpacedFrequencies(30.0, sampleRate * 0.45, 400)) {
+            phaseDeviation = std::max(phaseDeviation, std::abs(compact.getQuadratureErrorDeg(freq) -
+                                                               reference.getQuadratureErrorDeg(freq)));
+            magDeviation = std::max(magDeviation,
+                                    std::abs(compact.getMagnitudeMatchDb(freq) - reference.getMagnitudeMatchDb(freq)));
+        }
+
+        // Same noise through both forms; the Q difference is the quantisation noise floor.
+        std::vector<float> input(static_cast<size_t>(sampleRate / 2));
+        juce::uint32 seed = 777u;
+        for (auto& sample : input) {
+            seed = seed * 1664525u + 1013904223u;
+            sample = static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+        }
+
+        Processor floatProcessor;
+        Processor compactProcessor;
+        for (auto* processor : {&floatProcessor, &compactProcessor}) {
+            processor->prepare({sampleRate, 512, 1});
+            processor->setMode(Processor::Mode::FIR);
+        }
+        compactProcessor.setFIRCoefficientStorage(Storage::Int16Folded);
+
+        std::vector<float> iFloat, qFloat, iCompact, qCompact;
+        renderFIR(floatProcessor, input, 512, iFloat, qFloat);
+        renderFIR(compactProcessor, input, 512, iCompact, qCompact);
+
+        double signal = 0.0;
+        double error = 0.0;
+        for (size_t i = static_cast<size_t>(floatProcessor.getLatencySamples()); i < input.size(); ++i) {
+            const double diff = static_cast<double>(qCompact[i]) - static_cast<double>(qFloat[i]);
+            signal += static_cast<double>(qFloat[i]) * static_cast<double>(qFloat[i]);
+            error += diff * diff;
+        }
+        const double noiseDb = 10.0 * std::log10((error + 1.0e-30) / (signal + 1.0e-30));
+
+        if (phaseDeviation > 0.01 || magDeviation > 0.1 || noiseDb > -60.0) {
+            std::cerr << "FIR int16 @" << sampleRate << " Hz: phaseDeviation=" << phaseDeviation
+                      << " magDeviation=" << magDeviation << " noiseDb=" << noiseDb << '\n';
+        }
+
+        // Folding keeps the kernel exactly antisymmetric, so phase is untouched; quantisation costs a little
+        // magnitude match and adds a noise floor.
+        ok &= expect(phaseDeviation <= 0.01, "16-bit coefficients should not move quadrature phase");
+        ok &= expect(magDeviation <= 0.1, "16-bit coefficients should move I/Q magnitude match by <= 0.1 dB");
+        ok &= expect(noiseDb <= -60.0, "16-bit coefficient noise should stay below -60 dB relative to Q");
+        ok &= expect(std::memcmp(iFloat.data(), iCompact.data(), input.size() * sizeof(float)) == 0,
+                     "Coefficient storage should not affect the delayed I path");
+    }
+
+    return expect(ok, "Compact FIR coefficient checks passed");
+}
+
+bool testRenderProfile() {
+    using Processor = qbdsp::HilbertQuadratureProcessor;
+    using Profile = qbdsp::ProcessingProfile;
+    constexpr auto storage = Processor::FIRCoefficientStorage::Float32;
+    bool ok = true;
+
+    for (double sampleRate : {44100.0, 48000.0, 96000.0}) {
+        const auto iir =
+            Processor::measureQuadratureResponse(Processor::Mode::IIR, sampleRate, storage, Profile::Render);
+        const auto firRealtime =
+            Processor::measureQuadratureResponse(Processor::Mode::FIR, sampleRate, storage, Profile::Realtime);
+        const auto firRender =
+            Processor::measureQuadratureResponse(Processor::Mode::FIR, sampleRate, storage, Profile::Render);
+
+        double iirPhaseMax = 0.0;
+        double iirMagMax = 0.0;
+        double firDeviation = 0.0;
+        for (double freq : logSpacedFrequencies(30.0, sampleRate * 0.45, 400)) {
+            iirPhaseMax = std::max(iirPhaseMax, iir.getQuadratureErrorDeg(freq));
+            iirMagMax = std::max(iirMagMax, std::abs(iir.getMagnitudeMatchDb(freq)));
+            firDeviation = std::max(firDeviation, std::abs(firRender.getQuadratureErrorDeg(freq) -
+                                                           firRealtime.getQuadratureErrorDeg(freq)));
+        }
+
+        if (iirPhaseMax > 0.5 || iirMagMax > 0.01 || firDeviation > 0.01) {
+            std::cerr << "Render @" << sampleRate << " Hz: iirPhaseMax=" << iirPhaseMax << " iirMagMax=" << iirMagMax
+                      << " firDeviation=" << firDeviation << '\n';
+        }
+
+        ok &= expect(iirPhaseMax <= 0.5, "Render IIR should hold quadrature within 0.5 deg from 30 Hz to 0.45 Fs");
+        ok &= expect(iirMagMax <= 0.01, "Render IIR I and Q should stay matched in magnitude");
+        ok &= expect(firDeviation <= 0.01, "Render FIR should keep the realtime FIR's quadrature response");
+
+        for (auto mode : {Processor::Mode::IIR, Processor::Mode::FIR}) {
+            Processor processor;
+            processor.prepare({sampleRate, 512, 1});
+            processor.setMode(mode);
+            const int realtimeLatency = processor.getLatencySamples();
+            processor.setProcessingProfile(Profile::Render);
+            ok &= expect(processor.getLatencySamples() == realtimeLatency,
+                         "The Render profile should not change the reported latency");
+        }
+    }
+
+    // Multi-core offline rendering must stay bit-identical in the Render profile too.
+    const double sampleRate = 48000.0;
+    const int total = 2 * Processor::kFIRChunk + 333;
+    std::vector<float> input(static_cast<size_t>(total));
+    juce::uint32 seed = 4242u;
+    for (auto& sample : input) {
+        seed = seed * 1664525u + 1013904223u;
+        sample = static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+    }
+
+    Processor realtime;
+    Processor offline;
+    realtime.prepare({sampleRate, 256, 1});
+    offline.prepare({sampleRate, static_cast<juce::uint32>(total), 1});
+    for (auto* processor : {&realtime, &offline}) {
+        processor->setMode(Processor::Mode::FIR);
+        processor->setProcessingProfile(Profile::Render);
+    }
+    offline.setOfflineRendering(true);
+
+    std::vector<float> iRealtime, qRealtime, iOffline, qOffline;
+    renderFIR(realtime, input, 256, iRealtime, qRealtime);
+    renderFIR(offline, input, total, iOffline, qOffline);
+    ok &= expect(std::memcmp(qRealtime.data(), qOffline.data(), input.size() * sizeof(float)) == 0,
+                 "Offline Render FIR Q should be bit-identical to block-by-block Render processing");
+
+    return expect(ok, "Render profile checks passed");
+}
+
+bool testSkippedQuadratureKeepsHistoryWarm() {
+    using Processor = qbdsp::HilbertQuadratureProcessor;
+    constexpr int blockSize = 256;
+    const int total = 40 * blockSize;
+
+    std::vector<float> input(static_cast<size_t>(total));
+    juce::uint32 seed = 99u;
+    for (auto& sample : input) {
+        seed = seed * 1664525u + 1013904223u;
+        sample = static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+    }
+
+    Processor reference;
+    Processor elided;
+    for (auto* processor : {&reference, &elided}) {
+        processor->prepare({48000.0, blockSize, 1});
+        processor->setMode(Processor::Mode::FIR);
+    }
+
+    // Q is skipped for the first half, then needed again.
+    const int skippedBlocks = total / blockSize / 2;
+    juce::AudioBuffer<float> iReference(1, blockSize), qReference(1, blockSize);
+    juce::AudioBuffer<float> iElided(1, blockSize), qElided(1, blockSize);
+    bool iMatches = true;
+    bool qSilentWhileSkipped = true;
+    bool qMatchesAfter = true;
+    for (int block = 0; block * blockSize < total; ++block) {
+        const float* in = input.data() + block * blockSize;
+        std::copy(in, in + blockSize, iReference.getWritePointer(0));
+        std::copy(in, in + blockSize, iElided.getWritePointer(0));
+        elided.setQuadratureNeeded(block >= skippedBlocks);
+        reference.process(iReference, qReference, 90.0f);
+        elided.process(iElided, qElided, 90.0f);
+
+        const size_t bytes = blockSize * sizeof(float);
+        iMatches &= std::memcmp(iReference.getReadPointer(0), iElided.getReadPointer(0), bytes) == 0;
+        if (block < skippedBlocks) {
+            for (int i = 0; i < blockSize; ++i)
+                qSilentWhileSkipped &= qElided.getSample(0, i) == 0.0f;
+        } else {
+            qMatchesAfter &= std::memcmp(qReference.getReadPointer(0), qElided.getReadPointer(0), bytes) == 0;
+        }
+    }
+
+    bool ok = true;
+    ok &= expect(iMatches, "Skipping Q should not change the delayed I path");
+    ok &= expect(qSilentWhileSkipped, "Skipped Q should be written as silence");
+    ok &= expect(qMatchesAfter, "Q should be bit-identical from the first block it is needed again");
+    return ok;
+}
+
+bool testFIRQualityTiers() {
+    using Processor = qbdsp::HilbertQuadratureProcessor;
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    bool ok = true;
+
+    Processor processor;
+    processor.prepare({sampleRate, blockSize, 1});
+    processor.setMode(Processor::Mode::FIR);
+    ok &= expect(processor.usesFIRTiers(), "FIR mode should run the tiered path");
+    const int latency = processor.getLatencySamples();
+    for (int tier = 1; tier < Processor::kNumFIRTiers; ++tier) {
+        ok &= expect(processor.getFIRTierTapCount(tier) < processor.getFIRTierTapCount(tier - 1),
+                     "Each tier should convolve fewer taps");
+        ok &= expect(processor.getFIRTierTapCount(tier) % 2 == 1, "Tier kernels should have a centre tap");
+
+        processor.setFIRTier(tier);
         processor.reset();
-        edgePhaseErrors.push_back(measureTone(processor, sampleRate, static_cast<float>(edgeFreq)).phaseErrDeg);
+        ok &= expect(processor.getLatencySamples() == latency, "Tiers should not change the reported latency");
+        for (const float hz : {1000.0f, 5000.0f, 15000.0f}) {
+            const auto metrics = measureTone(processor, sampleRate, hz);
+            ok &= expect(metrics.phaseErrDeg <= 3.0 && std::abs(metrics.magErrDb) <= 0.5,
+                         "Tier " + std::to_string(tier) + " should keep quadrature at " + std::to_string(hz) + " Hz");
+        }
+    }
+
+    // I stays on the full delay at every tier, and stepping tiers fades Q across without a step. 25 Hz is below the
+    // cheapest tier's accurate band, so its Q differs from the full kernel's by about a quarter of full scale.
+    processor.setFIRTier(0);
+    processor.reset();
+    const double omega = 2.0 * juce::MathConstants<double>::pi * 25.0 / sampleRate;
+    juce::AudioBuffer<float> iBuffer(1, blockSize), qBuffer(1, blockSize);
+    std::vector<float> q;
+    int sampleIndex = 0;
+    bool iDelayed = true;
+    for (int block = 0; block < 160; ++block) {
+        if (block == 80)
+            processor.setFIRTier(Processor::kNumFIRTiers - 1);
+        if (block == 120)
+            processor.setFIRTier(0);
+        for (int i = 0; i < blockSize; ++i)
+            iBuffer.setSample(0, i, static_cast<float>(std::sin(omega * (sampleIndex + i))));
+        processor.process(iBuffer, qBuffer, 90.0f);
+        for (int i = 0; i < blockSize; ++i) {
+            const int delayed = sampleIndex + i - latency;
+            const float expected = delayed >= 0 ? static_cast<float>(std::sin(omega * delayed)) : 0.0f;
+            iDelayed &= std::abs(iBuffer.getSample(0, i) - expected) < 1.0e-5f;
+            q.push_back(qBuffer.getSample(0, i));
+        }
+        sampleIndex += blockSize;
+    }
 
-        ok &= expect(!phaseErrorsMain.empty(), "Main-band FIR probe set should not be empty");
-        ok &= expect(!magErrorsMain.empty(), "Main-band FIR magnitude probe set should not be empty");
+    // Settled Q is a near-unit sine, so no sample-to-sample step may exceed the tone's own slope by much.
+    double maxStep = 0.0;
+    for (size_t i = static_cast<size_t>(2 * latency) + 1; i < q.size(); ++i)
+        maxStep = std::max(maxStep, static_cast<double>(std::abs(q[i] - q[i - 1])));
+    ok &= expect(iDelayed, "I should stay on the full kernel's delay across tier changes");
+    ok &= expect(maxStep <= omega * 1.05, "Tier changes should crossfade without steps in Q");
+
+    processor.setMode(Processor::Mode::Spectral);
+    ok &= expect(!processor.usesFIRTiers(), "Spectral mode should ignore the FIR tier");
+    processor.setMode(Processor::Mode::FIR);
+    processor.setProcessingProfile(qbdsp::ProcessingProfile::Render);
+    ok &= expect(!processor.usesFIRTiers(), "The Render profile should always convolve the full kernel");
+    return expect(ok, "FIR quality tier checks passed");
+}
 
-        const double mainPhase95 = percentile95(phaseErrorsMain);
-        const double mainPhaseMax =
-            phaseErrorsMain.empty() ? 0.0 : *std::max_element(phaseErrorsMain.begin(), phaseErrorsMain.end());
-        const double mainMag95 = percentile95(magErrorsMain);
-        const double mainMagMax =
-            magErrorsMain.empty() ? 0.0 : *std::max_element(magErrorsMain.begin(), magErrorsMain.end());
-        const double edgePhaseMax =
-            edgePhaseErrors.empty() ? 0.0 : *std::max_element(edgePhaseErrors.begin(), edgePhaseErrors.end());
+bool testFIRLowestFrequency() {
+    using Processor = qbdsp::HilbertQuadratureProcessor;
+    constexpr double sampleRate = 48000.0;
+    bool ok = true;
 
-        if (!(mainPhase95 <= 3.0 && mainPhaseMax <= 8.0 && mainMag95 <= 0.5 && mainMagMax <= 1.5 &&
-              edgePhaseMax <= 12.0)) {
-            std::cerr << "FIR stats @" << sampleRate << " Hz: phase95=" << mainPhase95 << " phaseMax=" << mainPhaseMax
-                      << " mag95=" << mainMag95 << " magMax=" << mainMagMax << " edgePhaseMax=" << edgePhaseMax << '\n';
+    Processor processor;
+    processor.prepare({sampleRate, 512, 1});
+    processor.setMode(Processor::Mode::FIR);
+    const int fullLatency = processor.getLatencySamples();
+    const int fullTaps = processor.getFIRTierTapCount(0);
+
+    // 120 Hz and up only needs the quarter-length kernel: a quarter of the cost and latency.
+    processor.setFIRLowestFrequency(120.0);
+    const int shortLatency = processor.getLatencySamples();
+    ok &= expect(processor.getFIRTierTapCount(0) == ((fullTaps >> 2) | 1),
+                 "A 120 Hz floor should select the quarter-length kernel");
+    ok &= expect(shortLatency == (processor.getFIRTierTapCount(0) - 1) / 2 && 4 * shortLatency <= fullLatency + 4,
+                 "The shorter base kernel should cut the latency to a quarter");
+    ok &= expect(processor.getMaxLatencySamples() >= fullLatency, "The maximum latency should cover the full kernel");
+    ok &= expect(processor.getFIRTierTapCount(Processor::kNumFIRTiers - 1) == processor.getFIRTierTapCount(0),
+                 "Tiers past the shortest kernel should share it");
+    for (const auto profile : {qbdsp::ProcessingProfile::Realtime, qbdsp::ProcessingProfile::Render}) {
+        processor.setProcessingProfile(profile);
+        processor.reset();
+        ok &= expect(processor.getLatencySamples() == shortLatency, "Both profiles should run the base kernel");
+        const auto metrics = measureTone(processor, sampleRate, 150.0f);
+        ok &= expect(metrics.phaseErrDeg <= 3.0 && metrics.magErrDb <= 0.5,
+                     "The base kernel should keep quadrature just above the crossover");
+    }
+    processor.setProcessingProfile(qbdsp::ProcessingProfile::Realtime);
+
+    processor.setFIRLowestFrequency(60.0);
+    ok &= expect(processor.getFIRTierTapCount(0) == ((fullTaps >> 1) | 1),
+                 "A 60 Hz floor should select the half-length kernel");
+    processor.setFIRLowestFrequency(0.0);
+    ok &= expect(processor.getLatencySamples() == fullLatency, "No floor should restore the full kernel");
+
+    processor.setFIRLowestFrequency(120.0);
+    processor.setMode(Processor::Mode::Spectral);
+    const int spectralLatency = processor.getLatencySamples();
+    processor.setFIRLowestFrequency(0.0);
+    ok &= expect(processor.getLatencySamples() == spectralLatency, "Spectral mode should ignore the FIR floor");
+
+    // Each shortened kernel holds the FIR targets from half its floor (well inside a crossover's low band) upwards.
+    for (const double rate : {44100.0, 96000.0}) {
+        for (const double floorHz : {60.0, 120.0, 200.0}) {
+            const auto response = Processor::measureQuadratureResponse(
+                Processor::Mode::FIR, rate, qbdsp::HilbertQuadratureProcessor::kDefaultFIRCoefficientStorage,
+                qbdsp::ProcessingProfile::Realtime, floorHz);
+            double worstPhase = 0.0;
+            double worstMagnitude = 0.0;
+            for (double hz = 0.5 * floorHz; hz <= 0.45 * rate; hz *= 1.05) {
+                worstPhase = std::max(worstPhase, response.getQuadratureErrorDeg(hz));
+                worstMagnitude = std::max(worstMagnitude, std::abs(response.getMagnitudeMatchDb(hz)));
+            }
+            ok &= expect(worstPhase <= 3.0 && worstMagnitude <= 0.5,
+                         "Shortened kernel for " + std::to_string(static_cast<int>(floorHz)) +
+                             " Hz should stay accurate above half its floor at " +
+                             std::to_string(static_cast<int>(rate)) + " Hz");
         }
+    }
+
+    return expect(ok, "FIR lowest-frequency checks passed");
+}
+
+bool testEngineSelector() {
+    using Mode = qbdsp::HilbertQuadratureProcessor::Mode;
+    using Selector = qbdsp::HilbertEngineSelector;
+    bool ok = true;
 
-        ok &= expect(mainPhase95 <= 3.0, "FIR main-band phase error 95th percentile should be <= 3 deg");
-        ok &= expect(mainPhaseMax <= 8.0, "FIR main-band phase error max should be <= 8 deg");
-        ok &= expect(mainMag95 <= 0.5, "FIR main-band magnitude error 95th percentile should be <= 0.5 dB");
-        ok &= expect(mainMagMax <= 1.5, "FIR main-band magnitude error max should be <= 1.5 dB");
-        ok &= expect(edgePhaseMax <= 12.0, "FIR edge-band phase error max should be <= 12 deg");
+    for (const double sampleRate : {48000.0, 192000.0}) {
+        const auto candidates = Selector::benchmark(sampleRate, 256);
+        const bool hasMultirate = std::any_of(candidates.begin(), candidates.end(),
+                                              [](const auto& candidate) { return candidate.mode == Mode::Multirate; });
+        ok &= expect(hasMultirate == (sampleRate > 88200.0),
+                     "Multirate should only be benchmarked at rates where it differs from FIR");
+
+        for (const auto& candidate : candidates) {
+            ok &= expect(qbdsp::HilbertQuadratureProcessor::isLinearPhase(candidate.mode),
+                         "Only linear-phase modes should be candidates");
+            ok &= expect(candidate.latencySamples > 0, "Candidates should report their latency");
+            ok &= expect(candidate.realtimeFraction > 0.0, "Candidates should be timed");
+            if (candidate.mode != Mode::FIR || sampleRate <= 96000.0)
+                ok &= expect(candidate.meetsAccuracyTargets, "Certified modes should meet the accuracy targets");
+        }
     }
 
-    return expect(ok, "FIR accuracy target checks passed");
+    std::vector<Selector::Candidate> candidates(2);
+    candidates[0].mode = Mode::FIR;
+    candidates[0].meetsAccuracyTargets = true;
+    candidates[0].realtimeFraction = 0.02;
+    candidates[1].mode = Mode::Spectral;
+    candidates[1].realtimeFraction = 0.01;
+    ok &= expect(Selector::chooseFastest(candidates) == Mode::FIR, "Inaccurate candidates should never be chosen");
+    candidates[1].meetsAccuracyTargets = true;
+    ok &= expect(Selector::chooseFastest(candidates) == Mode::Spectral, "The fastest accurate candidate should win");
+    ok &= expect(Selector::chooseFastest({}) == Mode::FIR, "FIR should be the fallback");
+
+    // Background selections measure on the worker, then land in the same cache as select().
+    {
+        Selector::clearCache();
+        juce::SharedResourcePointer<Selector::Worker> worker;
+        const auto pending = Selector::selectInBackground(48000.0, 128, *worker);
+        pending.wait();
+        ok &= expect(pending.isReady(), "A background selection should be ready once it has finished");
+        ok &= expect(pending.getMode() == Selector::select(48000.0, 128),
+                     "A background selection should be stored as the cached decision");
+        const auto cached = Selector::selectInBackground(48000.0, 128, *worker);
+        ok &= expect(cached.isReady() && cached.getMode() == pending.getMode(),
+                     "A cached decision should be ready without queueing a measurement");
+        ok &= expect(!Selector::PendingMode().isReady() && Selector::PendingMode().getMode() == Mode::FIR,
+                     "A selection that was never started should run FIR");
+    }
+
+    // Persisted decisions are reused instead of re-benchmarking: overwrite the saved choice and reload it.
+    const auto file = juce::File::createTempFile(".xml");
+    Selector::clearCache();
+    Selector::setCacheFile(file);
+    const auto measured = Selector::select(48000.0, 256);
+    ok &= expect(Selector::select(48000.0, 256) == measured, "Decisions should be cached per spec");
+
+    const auto forced = measured == Mode::FIR ? Mode::Spectral : Mode::FIR;
+    auto xml = juce::XmlDocument::parse(file);
+    ok &= expect(xml != nullptr, "The decision should be saved to the cache file");
+    if (xml != nullptr) {
+        for (auto* entry : xml->getChildWithTagNameIterator("Decision"))
+            entry->setAttribute("mode", static_cast<int>(forced));
+        xml->writeTo(file);
+    }
+
+    Selector::clearCache();
+    Selector::setCacheFile({});
+    Selector::setCacheFile(file);
+    ok &= expect(Selector::select(48000.0, 256) == forced, "Saved decisions should be loaded from the cache file");
+
+    Selector::setCacheFile({});
+    Selector::clearCache();
+    file.deleteFile();
+    return ok;
 }
 
 } // namespace
@@ -218,6 +773,16 @@ int main() {
     bool ok = true;
     ok &= testIIRRegression();
     ok &= testFIRAccuracyTargets();
+    ok &= testMultirateAccuracyTargets();
+    ok &= testSpectralAccuracyTargets();
+    ok &= testOfflineFIRMatchesRealtime();
+    ok &= testQuadratureResponseMatchesTones();
+    ok &= testCompactFIRCoefficients();
+    ok &= testRenderProfile();
+    ok &= testSkippedQuadratureKeepsHistoryWarm();
+    ok &= testFIRQualityTiers();
+    ok &= testFIRLowestFrequency();
+    ok &= testEngineSelector();
 
     if (!ok)
         return 1;
@@ -58,7 +58,9 @@ bool testParameterIdsExist() {
     ok &=
         expect(params.apvts.getParameter(util::Params::IDs::phaseRotationDeg) != nullptr, "Missing phase_rotation_deg");
     ok &= expect(params.apvts.getParameter(util::Params::IDs::outputGainDb) != nullptr, "Missing output_gain_db");
-    ok &= expect(processor.getParameters().size() == 5, "Expected exactly five plugin parameters");
+    ok &= expect(params.apvts.getParameter(util::Params::IDs::adaptiveQuality) != nullptr, "Missing adaptive_quality");
+    ok &= expect(params.apvts.getParameter(util::Params::IDs::monoBass) != nullptr, "Missing mono_bass");
+    ok &= expect(processor.getParameters().size() == 7, "Expected exactly seven plugin parameters");
     return ok;
 }
 
@@ -77,6 +79,8 @@ bool testDefaultValues() {
     ok &= expect(isNear(params.getPhaseAngleDeg(), 90.0f), "Default phase angle should be 90 deg");
     ok &= expect(isNear(params.getPhaseRotationDeg(), 0.0f), "Default phase rotation should be 0 deg");
     ok &= expect(isNear(params.getOutputGainDb(), 0.0f), "Default gain should be 0 dB");
+    ok &= expect(!params.getAdaptiveQuality(), "Adaptive quality should default to off");
+    ok &= expect(params.getMonoBassIndex() == 0, "Mono bass should default to off");
     return ok;
 }
 
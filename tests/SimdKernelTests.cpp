@@ -0,0 +1,297 @@
+#include "../src/dsp/KernelDispatch.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Isa = qbdsp::KernelDispatch::Isa;
+
+bool expect(bool condition, const std::string& message) {
+    if (condition)
+        return true;
+
+    std::cerr << "FAIL: " << message << '\n';
+    return false;
+}
+
+std::vector<float> makeNoise(int size, juce::uint32 seed) {
+    std::vector<float> values(static_cast<size_t>(size));
+    for (auto& value : values) {
+        seed = seed * 1664525u + 1013904223u;
+        value = static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+    }
+    return values;
+}
+
+bool isClose(float actual, float expected, float relative) {
+    return std::abs(actual - expected) <= relative * juce::jmax(1.0f, std::abs(expected));
+}
+
+bool checkTableMatchesScalar(const qbdsp::simd::KernelTable& table) {
+    const auto& scalar = qbdsp::simd::getScalarKernels();
+    const std::string name = table.name;
+    bool ok = true;
+
+    const auto a = makeNoise(4096, 1u);
+    const auto b = makeNoise(8192, 2u);
+
+    for (int n : {0, 1, 3, 15, 16, 17, 100, 1023, 4096}) {
+        ok &= expect(isClose(table.dot(a.data(), b.data(), n), scalar.dot(a.data(), b.data(), n), 1.0e-5f),
+                     name + " dot should match scalar, n=" + std::to_string(n));
+        ok &= expect(isClose(table.dotStride2(a.data(), b.data(), n), scalar.dotStride2(a.data(), b.data(), n),
+                             1.0e-5f),
+                     name + " dotStride2 should match scalar, n=" + std::to_string(n));
+    }
+
+    // Convolution is vectorised across outputs with the taps summed in order, so it must match exactly.
+    const auto coeffs = makeNoise(1025, 3u);
+    const float* newest = b.data() + 2100;
+    for (int numOutputs : {1, 5, 16, 63, 64, 333}) {
+        for (int numCoeffs : {1, 9, 1025}) {
+            std::vector<float> expected(static_cast<size_t>(numOutputs));
+            std::vector<float> actual(static_cast<size_t>(numOutputs));
+            scalar.convolveStride2(coeffs.data(), numCoeffs, newest, expected.data(), numOutputs);
+            table.convolveStride2(coeffs.data(), numCoeffs, newest, actual.data(), numOutputs);
+            ok &= expect(std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)) == 0,
+                         name + " convolveStride2 should be bit-identical to scalar, outputs=" +
+                             std::to_string(numOutputs) + " taps=" + std::to_string(numCoeffs));
+        }
+    }
+
+    std::vector<std::int16_t> folded(512);
+    for (size_t j = 0; j < folded.size(); ++j)
+        folded[j] = static_cast<std::int16_t>(static_cast<int>(coeffs[j] * 32767.0f));
+    const float* oldest = b.data() + 40;
+    for (int numOutputs : {1, 5, 16, 63, 64, 333}) {
+        for (int numCoeffs : {1, 9, 512}) {
+            std::vector<float> expected(static_cast<size_t>(numOutputs));
+            std::vector<float> actual(static_cast<size_t>(numOutputs));
+            scalar.convolveStride2Folded(folded.data(), numCoeffs, 1.0f / 32767.0f, newest, oldest, expected.data(),
+                                         numOutputs);
+            table.convolveStride2Folded(folded.data(), numCoeffs, 1.0f / 32767.0f, newest, oldest, actual.data(),
+                                        numOutputs);
+            ok &= expect(std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)) == 0,
+                         name + " convolveStride2Folded should be bit-identical to scalar, outputs=" +
+                             std::to_string(numOutputs) + " taps=" + std::to_string(numCoeffs));
+        }
+    }
+
+    // Each batched stream must come out exactly as if it were convolved on its own.
+    constexpr int batchRows = 2 * 1025 + 8;
+    constexpr int batchOutputs = 7;
+    for (int numStreams : {1, 7, 16, 67}) {
+        for (int numCoeffs : {1, 9, 1025}) {
+            const auto rows = makeNoise(batchRows * numStreams, static_cast<juce::uint32>(numStreams));
+            const int firstOutputRow = batchRows - batchOutputs;
+            std::vector<float> actual(static_cast<size_t>(batchOutputs * numStreams));
+            table.convolveStride2Batch(coeffs.data(), numCoeffs, rows.data() + firstOutputRow * numStreams,
+                                       numStreams, actual.data(), numStreams, batchOutputs);
+
+            bool batchOk = true;
+            std::vector<float> stream(static_cast<size_t>(batchRows));
+            std::vector<float> expected(static_cast<size_t>(batchOutputs));
+            for (int k = 0; k < numStreams; ++k) {
+                for (int t = 0; t < batchRows; ++t)
+                    stream[static_cast<size_t>(t)] = rows[static_cast<size_t>(t * numStreams + k)];
+                scalar.convolveStride2(coeffs.data(), numCoeffs, stream.data() + firstOutputRow, expected.data(),
+                                       batchOutputs);
+                for (int t = 0; t < batchOutputs; ++t)
+                    batchOk &= std::memcmp(&expected[static_cast<size_t>(t)],
+                                           &actual[static_cast<size_t>(t * numStreams + k)], sizeof(float)) == 0;
+            }
+            ok &= expect(batchOk, name + " convolveStride2Batch should be bit-identical to per-stream scalar, " +
+                                      "streams=" + std::to_string(numStreams) + " taps=" + std::to_string(numCoeffs));
+        }
+    }
+
+    constexpr int mixSamples = 509;
+    const float* inputs[4] = {a.data(), a.data() + 600, b.data(), b.data() + 1200};
+    const float leftGains[4] = {0.5f, -0.25f, 0.75f, 0.1f};
+    const float rightGains[4] = {0.5f, 0.25f, -0.75f, 0.3f};
+    std::vector<float> expectedL(mixSamples), expectedR(mixSamples), actualL(mixSamples), actualR(mixSamples);
+    scalar.mixStereo(inputs, 4, leftGains, rightGains, expectedL.data(), expectedR.data(), mixSamples);
+    table.mixStereo(inputs, 4, leftGains, rightGains, actualL.data(), actualR.data(), mixSamples);
+    bool mixOk = true;
+    for (size_t s = 0; s < static_cast<size_t>(mixSamples); ++s)
+        mixOk &= isClose(actualL[s], expectedL[s], 1.0e-6f) && isClose(actualR[s], expectedR[s], 1.0e-6f);
+    ok &= expect(mixOk, name + " mixStereo should match scalar");
+
+    // The downmix adds in input order without FMA, so it is exact; any NaN or Inf input must be reported.
+    for (int numInputs : {1, 2, 4}) {
+        std::vector<float> expected(mixSamples), actual(mixSamples);
+        const bool scalarFinite = scalar.downmix(inputs, numInputs, 0.25f, expected.data(), mixSamples);
+        const bool finite = table.downmix(inputs, numInputs, 0.25f, actual.data(), mixSamples);
+        ok &= expect(scalarFinite && finite, name + " downmix should report finite inputs as finite");
+        ok &= expect(std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)) == 0,
+                     name + " downmix should be bit-identical to scalar, inputs=" + std::to_string(numInputs));
+    }
+    auto mixLeft = makeNoise(mixSamples, 9u);
+    auto mixRight = makeNoise(mixSamples, 10u);
+    const float* mixInputs[2] = {mixLeft.data(), mixRight.data()};
+    std::vector<float> mono(mixSamples);
+    for (int position : {0, 17, mixSamples - 1}) {
+        mixRight[static_cast<size_t>(position)] = std::numeric_limits<float>::infinity();
+        ok &= expect(!table.downmix(mixInputs, 2, 0.5f, mono.data(), mixSamples),
+                     name + " downmix should report a non-finite input at " + std::to_string(position));
+        mixRight[static_cast<size_t>(position)] = 0.0f;
+    }
+
+    float expectedSums[3] = {0.1f, 0.2f, 0.3f};
+    float actualSums[3] = {0.1f, 0.2f, 0.3f};
+    scalar.accumulateCorrelation(a.data(), b.data(), 4001, 0.9999f, expectedSums);
+    table.accumulateCorrelation(a.data(), b.data(), 4001, 0.9999f, actualSums);
+    for (int k = 0; k < 3; ++k)
+        ok &= expect(isClose(actualSums[k], expectedSums[k], 1.0e-4f),
+                     name + " accumulateCorrelation should match scalar, sum " + std::to_string(k));
+
+    // Only max and abs are applied to the in-order sums, so the peak must match exactly.
+    const auto phases = makeNoise(4 * 12, 4u);
+    for (int n : {0, 1, 3, 15, 16, 17, 1024}) {
+        for (int numPhases : {1, 2, 4}) {
+            const float expected = scalar.interpolatedPeak(phases.data(), numPhases, 12, b.data() + 20, n);
+            const float actual = table.interpolatedPeak(phases.data(), numPhases, 12, b.data() + 20, n);
+            ok &= expect(std::memcmp(&expected, &actual, sizeof(float)) == 0,
+                         name + " interpolatedPeak should be bit-identical to scalar, n=" + std::to_string(n) +
+                             " phases=" + std::to_string(numPhases));
+        }
+    }
+
+    // A single NaN or Inf anywhere, in any channel and including the scalar tails, must be found.
+    auto scan = makeNoise(1027, 7u);
+    auto scanRight = makeNoise(1027, 8u);
+    const float* const channels[] = {scan.data(), scanRight.data()};
+    ok &= expect(table.allFinite(channels, 2, 1027), name + " allFinite should accept finite samples");
+    for (const float bad : {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(),
+                            -std::numeric_limits<float>::infinity()}) {
+        for (auto* channel : {&scan, &scanRight}) {
+            for (int position : {0, 7, 16, 511, 1026}) {
+                auto& sample = (*channel)[static_cast<size_t>(position)];
+                const float saved = sample;
+                sample = bad;
+                ok &= expect(!table.allFinite(channels, 2, 1027),
+                             name + " allFinite should find a non-finite sample at " + std::to_string(position));
+                ok &= expect(table.allFinite(channels, 2, position), name + " allFinite should stop at n");
+                ok &= expect(table.allFinite(channels, channel == &scan ? 0 : 1, 1027),
+                             name + " allFinite should stop at numChannels");
+                sample = saved;
+            }
+        }
+    }
+
+    return ok;
+}
+
+bool testEveryTableMatchesScalar() {
+    bool ok = true;
+    int numTables = 0;
+    for (const auto isa : {Isa::Scalar, Isa::SSE2, Isa::AVX2, Isa::AVX512, Isa::NEON}) {
+        if (const auto* table = qbdsp::KernelDispatch::getTable(isa)) {
+            ok &= checkTableMatchesScalar(*table);
+            ++numTables;
+        }
+    }
+
+    std::cout << "Checked " << numTables << " kernel table(s), active: "
+              << qbdsp::KernelDispatch::getIsaName(qbdsp::KernelDispatch::getActiveIsa()) << '\n';
+    return ok;
+}
+
+bool testDeterministicTablesAreBitIdentical() {
+    const auto& reference = qbdsp::simd::getScalarKernels(true);
+    const auto a = makeNoise(4096, 5u);
+    const auto b = makeNoise(8192, 6u);
+    bool ok = true;
+    int numTables = 0;
+
+    for (const auto isa : {Isa::Scalar, Isa::SSE2, Isa::AVX2, Isa::AVX512, Isa::NEON}) {
+        const auto* table = qbdsp::KernelDispatch::getTable(isa, true);
+        if (table == nullptr)
+            continue;
+
+        ++numTables;
+        ok &= checkTableMatchesScalar(*table);
+
+        const std::string name = std::string(table->name) + " (deterministic)";
+        for (int n : {0, 1, 15, 16, 17, 33, 100, 1023, 4096}) {
+            const float expectedDot = reference.dot(a.data(), b.data(), n);
+            const float actualDot = table->dot(a.data(), b.data(), n);
+            ok &= expect(std::memcmp(&expectedDot, &actualDot, sizeof(float)) == 0,
+                         name + " dot should be bit-identical to scalar, n=" + std::to_string(n));
+
+            const float expectedStride2 = reference.dotStride2(a.data(), b.data(), n);
+            const float actualStride2 = table->dotStride2(a.data(), b.data(), n);
+            ok &= expect(std::memcmp(&expectedStride2, &actualStride2, sizeof(float)) == 0,
+                         name + " dotStride2 should be bit-identical to scalar, n=" + std::to_string(n));
+
+            float expectedSums[3] = {0.1f, 0.2f, 0.3f};
+            float actualSums[3] = {0.1f, 0.2f, 0.3f};
+            reference.accumulateCorrelation(a.data(), b.data(), n, 0.9999f, expectedSums);
+            table->accumulateCorrelation(a.data(), b.data(), n, 0.9999f, actualSums);
+            ok &= expect(std::memcmp(expectedSums, actualSums, sizeof(expectedSums)) == 0,
+                         name + " accumulateCorrelation should be bit-identical to scalar, n=" + std::to_string(n));
+        }
+
+        // The matrix mix sums its inputs in order per sample in every table.
+        constexpr int mixSamples = 509;
+        const float* inputs[3] = {a.data(), a.data() + 600, b.data()};
+        const float leftGains[3] = {0.5f, -0.25f, 0.75f};
+        const float rightGains[3] = {0.5f, 0.25f, -0.75f};
+        std::vector<float> expectedL(mixSamples), expectedR(mixSamples), actualL(mixSamples), actualR(mixSamples);
+        reference.mixStereo(inputs, 3, leftGains, rightGains, expectedL.data(), expectedR.data(), mixSamples);
+        table->mixStereo(inputs, 3, leftGains, rightGains, actualL.data(), actualR.data(), mixSamples);
+        ok &= expect(expectedL == actualL && expectedR == actualR, name + " mixStereo should be bit-identical");
+    }
+
+    const bool wasDeterministic = qbdsp::KernelDispatch::isDeterministic();
+    qbdsp::KernelDispatch::setDeterministic(true);
+    ok &= expect(&qbdsp::KernelDispatch::get() ==
+                     qbdsp::KernelDispatch::getTable(qbdsp::KernelDispatch::getActiveIsa(), true),
+                 "Deterministic mode should switch the active table");
+    qbdsp::KernelDispatch::setDeterministic(wasDeterministic);
+
+    std::cout << "Checked " << numTables << " deterministic kernel table(s)\n";
+    return ok;
+}
+
+bool testDispatchOverride() {
+    bool ok = true;
+    const auto best = qbdsp::KernelDispatch::detectBestIsa();
+    ok &= expect(qbdsp::KernelDispatch::isSupported(best), "Detected ISA should be supported");
+
+    ok &= expect(qbdsp::KernelDispatch::setIsa(Isa::Scalar), "Scalar kernels should always be selectable");
+    ok &= expect(qbdsp::KernelDispatch::getActiveIsa() == Isa::Scalar, "Override should change the active ISA");
+    ok &= expect(std::strcmp(qbdsp::KernelDispatch::get().name, "scalar") == 0,
+                 "Override should change the active table");
+
+    for (const auto isa : {Isa::SSE2, Isa::AVX2, Isa::AVX512, Isa::NEON})
+        if (!qbdsp::KernelDispatch::isSupported(isa))
+            ok &= expect(!qbdsp::KernelDispatch::setIsa(isa), "Unsupported ISAs should be rejected");
+
+    Isa parsed = Isa::Scalar;
+    ok &= expect(qbdsp::KernelDispatch::parseIsaName(" AVX2 ", parsed) && parsed == Isa::AVX2,
+                 "Override names should parse case-insensitively");
+    ok &= expect(!qbdsp::KernelDispatch::parseIsaName("mmx", parsed), "Unknown override names should be rejected");
+
+    qbdsp::KernelDispatch::setIsa(best);
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    ok &= testEveryTableMatchesScalar();
+    ok &= testDeterministicTablesAreBitIdentical();
+    ok &= testDispatchOverride();
+
+    if (!ok)
+        return 1;
+
+    std::cout << "QuadraBass SIMD kernel tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include "../src/util/StateCodec.h"
+#include <cmath>
+#include <iostream>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <string>
+
+namespace {
+
+class DummyProcessor final : public juce::AudioProcessor {
+  public:
+    DummyProcessor()
+        : AudioProcessor(BusesProperties()
+                             .withInput("In", juce::AudioChannelSet::stereo(), true)
+                             .withOutput("Out", juce::AudioChannelSet::stereo(), true)) {}
+
+    const juce::String getName() const override { return "DummyProcessor"; }
+    void prepareToPlay(double, int) override {}
+    void releaseResources() override {}
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override {
+        return layouts.getMainInputChannelSet() == layouts.getMainOutputChannelSet();
+    }
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override {}
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    bool isMidiEffect() const override { return false; }
+    double getTailLengthSeconds() const override { return 0.0; }
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+};
+
+bool expect(bool condition, const std::string& message) {
+    if (condition)
+        return true;
+
+    std::cerr << "FAIL: " << message << '\n';
+    return false;
+}
+
+bool isNear(float a, float b, float epsilon = 1.0e-4f) {
+    return std::abs(a - b) <= epsilon;
+}
+
+void setPlainValue(util::Params& params, const char* id, float value) {
+    auto* parameter = params.apvts.getParameter(id);
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+void applyCustomValues(util::Params& params) {
+    setPlainValue(params, util::Params::IDs::widthPercent, 37.5f);
+    setPlainValue(params, util::Params::IDs::hilbertMode, 0.0f);
+    setPlainValue(params, util::Params::IDs::phaseAngleDeg, 120.0f);
+    setPlainValue(params, util::Params::IDs::phaseRotationDeg, -45.0f);
+    setPlainValue(params, util::Params::IDs::outputGainDb, -6.0f);
+}
+
+void applyOtherValues(util::Params& params) {
+    setPlainValue(params, util::Params::IDs::widthPercent, 80.0f);
+    setPlainValue(params, util::Params::IDs::hilbertMode, 1.0f);
+    setPlainValue(params, util::Params::IDs::phaseAngleDeg, 30.0f);
+    setPlainValue(params, util::Params::IDs::phaseRotationDeg, 90.0f);
+    setPlainValue(params, util::Params::IDs::outputGainDb, 3.0f);
+}
+
+bool expectCustomValues(const util::Params& params, const std::string& context) {
+    bool ok = true;
+    ok &= expect(isNear(params.getWidthPercent(), 37.5f), context + ": width should be restored");
+    ok &= expect(params.getHilbertModeIndex() == 0, context + ": Hilbert mode should be restored");
+    ok &= expect(isNear(params.getPhaseAngleDeg(), 120.0f), context + ": phase angle should be restored");
+    ok &= expect(isNear(params.getPhaseRotationDeg(), -45.0f), context + ": phase rotation should be restored");
+    ok &= expect(isNear(params.getOutputGainDb(), -6.0f), context + ": gain should be restored");
+    return ok;
+}
+
+bool testBinaryRoundTrip() {
+    DummyProcessor processor;
+    util::Params params(processor);
+    applyCustomValues(params);
+
+    juce::MemoryBlock state;
+    util::StateCodec::write(params, state);
+
+    bool ok = true;
+    ok &= expect(state.getSize() > 8 && juce::ByteOrder::littleEndianInt(state.getData()) == util::StateCodec::kMagic,
+                 "State should start with the binary magic");
+
+    applyOtherValues(params);
+    ok &= expect(util::StateCodec::read(params, state.getData(), static_cast<int>(state.getSize())),
+                 "Binary state should load");
+    ok &= expectCustomValues(params, "binary");
+    return ok;
+}
+
+bool testLegacyXmlStateStillLoads() {
+    DummyProcessor processor;
+    util::Params params(processor);
+    applyCustomValues(params);
+
+    juce::MemoryBlock legacy;
+    std::unique_ptr<juce::XmlElement> xml(params.apvts.copyState().createXml());
+    juce::AudioProcessor::copyXmlToBinary(*xml, legacy);
+
+    juce::MemoryBlock binary;
+    util::StateCodec::write(params, binary);
+
+    applyOtherValues(params);
+    bool ok = true;
+    ok &= expect(util::StateCodec::read(params, legacy.getData(), static_cast<int>(legacy.getSize())),
+                 "Legacy XML state should load");
+    ok &= expectCustomValues(params, "xml");
+    ok &= expect(binary.getSize() < legacy.getSize(), "Binary state should be smaller than the XML state");
+    return ok;
+}
+
+bool testRejectsMalformedState() {
+    DummyProcessor processor;
+    util::Params params(processor);
+    applyCustomValues(params);
+
+    juce::MemoryBlock state;
+    util::StateCodec::write(params, state);
+    applyOtherValues(params);
+
+    bool ok = true;
+    ok &= expect(!util::StateCodec::read(params, state.getData(), static_cast<int>(state.getSize()) - 2),
+                 "Truncated binary state should be rejected");
+
+    juce::MemoryBlock future(state);
+    static_cast<juce::uint8*>(future.getData())[4] = static_cast<juce::uint8>(util::StateCodec::kFormatVersion + 1);
+    ok &= expect(!util::StateCodec::read(params, future.getData(), static_cast<int>(future.getSize())),
+                 "Unknown future format versions should be rejected");
+
+    const char garbage[] = "not a plugin state";
+    ok &= expect(!util::StateCodec::read(params, garbage, static_cast<int>(sizeof(garbage))),
+                 "Garbage should be rejected");
+
+    ok &= expect(isNear(params.getPhaseAngleDeg(), 30.0f), "Rejected states should leave the parameters untouched");
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    ok &= testBinaryRoundTrip();
+    ok &= testLegacyXmlStateStillLoads();
+    ok &= testRejectsMalformedState();
+
+    if (!ok)
+        return 1;
+
+    std::cout << "QuadraBass StateCodec tests passed.\n";
+    return 0;
+}
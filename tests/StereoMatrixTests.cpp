@@ -92,11 +92,91 @@ bool testSymmetricWidthAtNinetyDegrees() {
     return ok;
 }
 
+bool testRenderProfileRampsGains() {
+    constexpr int samples = 64;
+    juce::AudioBuffer<float> lowBuffer(1, samples);
+    juce::AudioBuffer<float> xHighBuffer(1, samples);
+    juce::AudioBuffer<float> iBuffer(1, samples);
+    juce::AudioBuffer<float> qBuffer(1, samples);
+    juce::AudioBuffer<float> output(2, samples);
+    lowBuffer.clear();
+    xHighBuffer.clear();
+    qBuffer.clear();
+    for (int i = 0; i < samples; ++i)
+        iBuffer.setSample(0, i, 1.0f);
+
+    // With a constant I input and the FIR law, both outputs equal cos(45deg * width).
+    const float fullWidthGain = std::cos(juce::MathConstants<float>::pi * 0.25f);
+    bool ok = true;
+
+    qbdsp::StereoMatrixProcessor realtime;
+    realtime.prepare({48000.0, samples, 2});
+    realtime.process(lowBuffer, xHighBuffer, iBuffer, qBuffer, output, 0.0f, 90.0f, 0.0f, true);
+    realtime.process(lowBuffer, xHighBuffer, iBuffer, qBuffer, output, 100.0f, 90.0f, 0.0f, true);
+    ok &= expect(std::abs(output.getSample(0, 0) - fullWidthGain) < 1.0e-6f,
+                 "Realtime profile should apply new gains from the first sample");
+
+    qbdsp::StereoMatrixProcessor render;
+    render.prepare({48000.0, samples, 2});
+    render.setProcessingProfile(qbdsp::ProcessingProfile::Render);
+    render.process(lowBuffer, xHighBuffer, iBuffer, qBuffer, output, 0.0f, 90.0f, 0.0f, true);
+    ok &= expect(std::abs(output.getSample(0, 0) - 1.0f) < 1.0e-6f,
+                 "The first Render block should start at its own gains");
+
+    render.process(lowBuffer, xHighBuffer, iBuffer, qBuffer, output, 100.0f, 90.0f, 0.0f, true);
+    const float step = (1.0f - fullWidthGain) / static_cast<float>(samples);
+    bool monotonic = true;
+    for (int i = 1; i < samples; ++i)
+        monotonic &= output.getSample(0, i) < output.getSample(0, i - 1);
+
+    ok &= expect(std::abs(output.getSample(0, 0) - (1.0f - step)) < 1.0e-5f,
+                 "Render profile should start the ramp one step from the previous gains");
+    ok &= expect(std::abs(output.getSample(0, samples - 1) - fullWidthGain) < 1.0e-6f,
+                 "Render profile should reach the new gains on the last sample");
+    ok &= expect(std::abs(output.getSample(1, samples / 2 - 1) - (1.0f + fullWidthGain) * 0.5f) < 1.0e-5f,
+                 "Render profile should ramp both channels linearly");
+    ok &= expect(monotonic, "Render ramp should move steadily towards the new gains");
+    return ok;
+}
+
+bool testQuadratureElision() {
+    qbdsp::StereoMatrixProcessor processor;
+    processor.prepare({48000.0, 64, 2});
+    bool ok = true;
+
+    // Width 0 leaves Q out of both channels under either width law, whatever the angle and rotation.
+    for (float angle : {0.0f, 45.0f, 90.0f, 180.0f})
+        for (float rotation : {-90.0f, 0.0f, 30.0f, 90.0f})
+            for (bool firLaw : {true, false})
+                ok &= expect(!processor.usesQuadrature(0.0f, angle, rotation, firLaw),
+                             "Width 0 should not need the Q signal");
+
+    ok &= expect(processor.usesQuadrature(50.0f, 90.0f, 0.0f, true), "Non-zero width should need Q");
+    ok &= expect(processor.usesQuadrature(1.0f, 180.0f, 45.0f, false), "Legacy law should need Q above width 0");
+
+    // In the Render profile the block after Q's gain drops to zero still ramps it out.
+    constexpr int samples = 64;
+    juce::AudioBuffer<float> empty;
+    juce::AudioBuffer<float> iBuffer(1, samples), qBuffer(1, samples), output(2, samples);
+    iBuffer.clear();
+    qBuffer.clear();
+    processor.setProcessingProfile(qbdsp::ProcessingProfile::Render);
+    processor.process(empty, empty, iBuffer, qBuffer, output, 100.0f, 90.0f, 0.0f, true);
+    ok &= expect(processor.usesQuadrature(0.0f, 90.0f, 0.0f, true),
+                 "Render profile should keep Q while ramping its gain out");
+    processor.process(empty, empty, iBuffer, qBuffer, output, 0.0f, 90.0f, 0.0f, true);
+    ok &= expect(!processor.usesQuadrature(0.0f, 90.0f, 0.0f, true),
+                 "Render profile should drop Q once its gain has ramped to zero");
+    return ok;
+}
+
 } // namespace
 
 int main() {
     bool ok = true;
     ok &= testSymmetricWidthAtNinetyDegrees();
+    ok &= testRenderProfileRampsGains();
+    ok &= testQuadratureElision();
 
     if (!ok)
         return 1;
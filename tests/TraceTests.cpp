@@ -0,0 +1,117 @@
+#include "../src/util/Trace.h"
+#include <iostream>
+#include <thread>
+
+namespace {
+
+bool expect(bool condition, const std::string& message) {
+    if (condition)
+        return true;
+    std::cerr << "FAIL: " << message << '\n';
+    return false;
+}
+
+struct TraceSummary {
+    bool parsed = false;
+    int eventsA = 0;
+    int eventsB = 0;
+    int eventsC = 0;
+    int eventsD = 0;
+    bool sawWorkerName = false;
+    bool durationsValid = true;
+};
+
+TraceSummary summarise() {
+    juce::MemoryOutputStream out;
+    util::Trace::writeChromeJson(out);
+
+    TraceSummary summary;
+    const auto root = juce::JSON::parse(out.toString());
+    const auto* events = root.getProperty("traceEvents", {}).getArray();
+    if (events == nullptr)
+        return summary;
+
+    summary.parsed = true;
+    for (const auto& event : *events) {
+        const auto name = event.getProperty("name", {}).toString();
+        const auto phase = event.getProperty("ph", {}).toString();
+        if (phase == "M") {
+            summary.sawWorkerName |= event.getProperty("args", {}).getProperty("name", {}).toString() == "Worker";
+            continue;
+        }
+
+        summary.durationsValid &= static_cast<double>(event.getProperty("dur", -1.0)) >= 0.0;
+        if (name == "a")
+            ++summary.eventsA;
+        else if (name == "b")
+            ++summary.eventsB;
+        else if (name == "c")
+            ++summary.eventsC;
+        else if (name == "d")
+            ++summary.eventsD;
+    }
+
+    return summary;
+}
+
+bool testEventsFromSeveralThreads() {
+    util::Trace::setCurrentThreadName("Main");
+    for (int i = 0; i < 3; ++i) {
+        const util::Trace::Scope scope("a");
+    }
+
+    std::thread worker([] {
+        util::Trace::setCurrentThreadName("Worker");
+        const util::Trace::Scope scope("b");
+    });
+    worker.join();
+
+    const auto summary = summarise();
+    bool ok = expect(summary.parsed, "Trace output should be valid JSON with a traceEvents array");
+    ok &= expect(summary.eventsA == 3, "Main thread events should all be recorded");
+    ok &= expect(summary.eventsB == 1, "Events from other threads should be recorded");
+    ok &= expect(summary.sawWorkerName, "Thread names should be emitted as metadata");
+    ok &= expect(summary.durationsValid, "Event durations should be non-negative");
+    return ok;
+}
+
+bool testRingKeepsNewestEvents() {
+    std::thread writer([] {
+        for (int i = 0; i < util::Trace::kEventsPerThread + 100; ++i)
+            util::Trace::record("c", i, i + 1);
+    });
+    writer.join();
+
+    // The oldest slot of a full ring may be mid-write, so a dump leaves it out.
+    const auto summary = summarise();
+    return expect(summary.eventsC == util::Trace::kEventsPerThread - 1,
+                  "A full ring should keep all but one of its capacity of the newest events");
+}
+
+bool testExitedThreadsShareRings() {
+    for (int i = 0; i < 8; ++i) {
+        std::thread worker([] {
+            const util::Trace::Scope scope("d");
+        });
+        worker.join();
+    }
+
+    // Each thread takes over the ring the previous one released, dropping the earlier thread's events.
+    const auto summary = summarise();
+    return expect(summary.eventsD == 1, "Threads that have exited should hand their rings to new threads");
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    ok &= testEventsFromSeveralThreads();
+    ok &= testRingKeepsNewestEvents();
+    ok &= testExitedThreadsShareRings();
+
+    if (!ok)
+        return 1;
+
+    std::cout << "Trace tests passed.\n";
+    return 0;
+}
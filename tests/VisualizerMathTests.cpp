@@ -1,8 +1,14 @@
-#include "../src/ui/CorrelationMeter.h"
+#include "../src/dsp/CorrelationAnalyzer.h"
+#include "../src/dsp/LoudnessAnalyzer.h"
+#include "../src/dsp/TruePeakMeter.h"
 #include "../src/ui/GoniometerComponent.h"
+#include "../src/ui/LayerCache.h"
+#include "../src/ui/RepaintScheduler.h"
+#include "../src/util/TelemetryChannel.h"
 #include <cmath>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -14,7 +20,7 @@ bool expect(bool condition, const std::string& message) {
 }
 
 bool testCorrelationMath() {
-    qbui::CorrelationMeter meter;
+    qbdsp::CorrelationAnalyzer meter;
 
     // Mono signal = 1.0 correlation
     float leftMono[512];
@@ -60,6 +66,226 @@ bool testCorrelationMath() {
     return ok;
 }
 
+bool testTelemetryChannel() {
+    util::TelemetryChannel channel;
+
+    float left[512];
+    float right[512];
+    for (int i = 0; i < 512; ++i) {
+        left[i] = std::sin(2.0f * 3.14159f * 100.0f * i / 48000.0f);
+        right[i] = -left[i];
+    }
+
+    // Nothing is queued while no view is subscribed and the meters have no sample rate.
+    channel.pushOutputBlock(left, right, 512);
+    bool ok = expect(!channel.drain(), "Unprepared, unsubscribed channel should not analyse output");
+
+    channel.subscribe();
+    const auto sequenceBefore = channel.getAnalysisSequence();
+    channel.pushOutputBlock(left, right, 512);
+    ok &= expect(channel.drain(), "Subscribed channel should analyse pushed output");
+    ok &= expect(channel.getAnalysisSequence() != sequenceBefore, "Analysis sequence should advance after a drain");
+    ok &= expect(std::abs(channel.getCorrelation() - (-1.0f)) < 1e-4f, "Channel correlation should track the meter");
+
+    constexpr int stride = util::TelemetryChannel::kGoniometerDecimation;
+    util::StereoFrame points[util::TelemetryChannel::kGoniometerRingFrames];
+    const int numPoints = channel.popGoniometerPoints(points, util::TelemetryChannel::kGoniometerRingFrames);
+    ok &= expect(numPoints == 512 / stride, "Goniometer points should be decimated output frames");
+    ok &= expect(numPoints > 1 && std::abs(points[1].left - left[stride]) < 1e-7f,
+                 "Goniometer points should keep the decimation stride");
+
+    // A full ring drops the excess instead of blocking the producer.
+    for (int block = 0; block < util::TelemetryChannel::kOutputRingFrames / 512 + 4; ++block)
+        channel.pushOutputBlock(left, right, 512);
+    ok &= expect(channel.drain(), "Overfull channel should still drain");
+    ok &= expect(!channel.drain(), "Drained channel should report no new data");
+
+    channel.unsubscribe();
+    return ok;
+}
+
+bool testLoudnessOfReferenceSine() {
+    // EBU Tech 3341 case 1: a 1 kHz sine at -23 dBFS on both channels reads -23 LUFS on every scale.
+    constexpr double sampleRate = 48000.0;
+    const float amplitude = std::pow(10.0f, -23.0f / 20.0f);
+    std::vector<float> left(48000);
+    for (size_t i = 0; i < left.size(); ++i)
+        left[i] = amplitude *
+                  static_cast<float>(std::sin(2.0 * 3.141592653589793 * 1000.0 * static_cast<double>(i) / sampleRate));
+
+    qbdsp::LoudnessAnalyzer meter;
+    meter.prepare(sampleRate);
+    bool ok = expect(std::isinf(meter.getIntegratedLufs()), "Integrated loudness should be -inf before any signal");
+
+    for (int second = 0; second < 20; ++second)
+        meter.processBlock(left.data(), left.data(), static_cast<int>(left.size()));
+
+    ok &= expect(std::abs(meter.getMomentaryLufs() + 23.0f) < 0.1f, "Momentary loudness of the reference sine");
+    ok &= expect(std::abs(meter.getShortTermLufs() + 23.0f) < 0.1f, "Short-term loudness of the reference sine");
+    ok &= expect(std::abs(meter.getIntegratedLufs() + 23.0f) < 0.1f, "Integrated loudness of the reference sine");
+
+    meter.reset();
+    ok &= expect(std::isinf(meter.getShortTermLufs()), "Reset should clear the loudness history");
+    return ok;
+}
+
+bool testLoudnessRelativeGate() {
+    // EBU Tech 3341 case 3: -36 dBFS for 10 s, -23 dBFS for 60 s, -36 dBFS for 10 s. The quiet parts fall under the
+    // relative gate.
+    constexpr double sampleRate = 48000.0;
+    std::vector<float> quiet(48000);
+    std::vector<float> loud(48000);
+    for (size_t i = 0; i < quiet.size(); ++i) {
+        const auto phase =
+            static_cast<float>(std::sin(2.0 * 3.141592653589793 * 1000.0 * static_cast<double>(i) / sampleRate));
+        quiet[i] = std::pow(10.0f, -36.0f / 20.0f) * phase;
+        loud[i] = std::pow(10.0f, -23.0f / 20.0f) * phase;
+    }
+
+    qbdsp::LoudnessAnalyzer meter;
+    meter.prepare(sampleRate);
+    auto play = [&meter](const std::vector<float>& section, int seconds) {
+        for (int second = 0; second < seconds; ++second)
+            meter.processBlock(section.data(), section.data(), static_cast<int>(section.size()));
+    };
+    play(quiet, 10);
+    play(loud, 60);
+    play(quiet, 10);
+
+    return expect(std::abs(meter.getIntegratedLufs() + 23.0f) < 0.1f, "Relative gate should drop the quiet parts");
+}
+
+bool testTruePeakCatchesInterSamplePeaks() {
+    // A sine at a quarter of the rate, sampled 45 degrees off its crests, peaks at -3 dBFS on the samples but
+    // 0 dBTP between them.
+    constexpr double sampleRate = 48000.0;
+    std::vector<float> signal(4800);
+    for (size_t i = 0; i < signal.size(); ++i)
+        signal[i] = static_cast<float>(std::sin(0.5 * 3.141592653589793 * (static_cast<double>(i) + 0.5)));
+
+    qbdsp::TruePeakMeter meter;
+    meter.prepare(sampleRate);
+    bool ok = expect(meter.getOversamplingFactor() == 4, "True peak should oversample 4x at 48 kHz");
+    meter.processBlock(signal.data(), signal.data(), static_cast<int>(signal.size()));
+    ok &= expect(std::abs(meter.getPeakDb()) < 0.3f, "True peak should find the crest between samples");
+
+    meter.reset();
+    ok &= expect(meter.getPeak() == 0.0f, "Reset should clear the true-peak hold");
+
+    meter.prepare(96000.0);
+    ok &= expect(meter.getOversamplingFactor() == 2, "True peak should oversample 2x at 96 kHz");
+    meter.prepare(192000.0);
+    ok &= expect(meter.getOversamplingFactor() == 1, "True peak should not oversample at 192 kHz");
+    return ok;
+}
+
+bool testTelemetryPublishesLoudness() {
+    util::TelemetryChannel channel;
+    channel.setSampleRate(48000.0);
+
+    std::vector<float> left(512);
+    for (size_t i = 0; i < left.size(); ++i)
+        left[i] = 0.5f * std::sin(2.0f * 3.14159f * 1000.0f * static_cast<float>(i) / 48000.0f);
+
+    // 0.5 s, well past the first 400 ms momentary window, with no editor open.
+    for (int block = 0; block < 47; ++block) {
+        channel.pushOutputBlock(left.data(), left.data(), 512);
+        channel.drain();
+    }
+
+    bool ok = expect(std::isfinite(channel.getMomentaryLufs()), "Channel should publish momentary loudness");
+    ok &= expect(channel.getTruePeakDb() > -7.0f && channel.getTruePeakDb() < -5.0f,
+                 "Channel should publish the true peak");
+    util::StereoFrame point;
+    ok &= expect(channel.popGoniometerPoints(&point, 1) == 0, "Goniometer should stay idle without a view");
+
+    // Opening a view continues the same measurement instead of starting a new one.
+    const float integratedBefore = channel.getIntegratedLufs();
+    channel.subscribe();
+    channel.pushOutputBlock(left.data(), left.data(), 512);
+    channel.drain();
+    ok &= expect(std::isfinite(integratedBefore) && std::abs(channel.getIntegratedLufs() - integratedBefore) < 0.1f,
+                 "Integrated loudness should cover audio played before the editor opened");
+
+    channel.resetLoudness();
+    channel.pushOutputBlock(left.data(), left.data(), 512);
+    channel.drain();
+    ok &= expect(std::isinf(channel.getIntegratedLufs()), "Resetting should restart the integrated measurement");
+
+    channel.unsubscribe();
+    return ok;
+}
+
+struct CountingClient final : public qbui::RepaintScheduler::Client {
+    bool advanceFrame() override {
+        ++frames;
+        return hasNewData;
+    }
+
+    bool hasNewData = true;
+    int frames = 0;
+};
+
+bool testRepaintSchedulerThrottlesWhenIdle() {
+    juce::Component host;
+    qbui::RepaintScheduler scheduler(host);
+    CountingClient client;
+    scheduler.addClient(client);
+
+    // A 144 Hz display is capped to the active frame rate.
+    double now = 1000.0;
+    for (int i = 0; i < 144; ++i, now += 1000.0 / 144.0)
+        scheduler.advance(now);
+    bool ok = expect(client.frames > 50 && client.frames <= 72, "Active views should refresh near 60 Hz");
+
+    client.hasNewData = false;
+    for (int i = 0; i < 144; ++i, now += 1000.0 / 144.0)
+        scheduler.advance(now);
+    ok &= expect(scheduler.isIdle(), "Scheduler should go idle once views stop changing");
+
+    client.frames = 0;
+    for (int i = 0; i < 144; ++i, now += 1000.0 / 144.0)
+        scheduler.advance(now);
+    ok &= expect(client.frames <= 5, "Idle views should only be polled at the idle rate");
+
+    client.hasNewData = true;
+    for (int i = 0; i < 72; ++i, now += 1000.0 / 144.0)
+        scheduler.advance(now);
+    ok &= expect(!scheduler.isIdle(), "New data should bring the scheduler back to the active rate");
+
+    scheduler.removeClient(client);
+    return ok;
+}
+
+bool testLayerCacheRendersOnlyWhenStale() {
+    qbui::LayerCache cache;
+    juce::Image target(juce::Image::ARGB, 200, 100, true);
+    juce::Graphics g(target);
+
+    int renders = 0;
+    auto render = [&renders](juce::Graphics& layer, juce::Rectangle<float> area) {
+        ++renders;
+        layer.setColour(juce::Colours::black);
+        layer.fillRect(area);
+    };
+
+    cache.draw(g, {0, 0, 200, 100}, render);
+    cache.draw(g, {0, 0, 200, 100}, render);
+    bool ok = expect(renders == 1, "Static layer should be rendered once and then reused");
+
+    cache.draw(g, {10, 10, 200, 100}, render);
+    ok &= expect(renders == 1, "Moving a static layer should not re-render it");
+
+    cache.draw(g, {0, 0, 120, 100}, render);
+    ok &= expect(renders == 2, "Resizing a static layer should re-render it");
+
+    cache.draw(g, {0, 0, 120, 100}, render, 7);
+    ok &= expect(renders == 3, "Changing the content key should re-render the layer");
+    cache.draw(g, {0, 0, 120, 100}, render, 7);
+    ok &= expect(renders == 3, "An unchanged content key should reuse the layer");
+    return ok;
+}
+
 bool testXYMapping() {
     qbui::GoniometerComponent goniometer;
 
@@ -92,6 +318,13 @@ bool testXYMapping() {
 int main() {
     bool ok = true;
     ok &= testCorrelationMath();
+    ok &= testTelemetryChannel();
+    ok &= testLoudnessOfReferenceSine();
+    ok &= testLoudnessRelativeGate();
+    ok &= testTruePeakCatchesInterSamplePeaks();
+    ok &= testTelemetryPublishesLoudness();
+    ok &= testRepaintSchedulerThrottlesWhenIdle();
+    ok &= testLayerCacheRendersOnlyWhenStale();
     ok &= testXYMapping();
 
     if (!ok)